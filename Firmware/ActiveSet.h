@@ -0,0 +1,145 @@
+/*
+ * ActiveSet.h - Sparse set of lit pixels for twinkle-style effects
+ *
+ * Keeps only the pixels that are lit, so updating and drawing cost follows
+ * the number of twinkles rather than the strip length
+ */
+
+#ifndef ACTIVE_SET_H
+#define ACTIVE_SET_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "EffectDefs.h"
+
+// ============================================================================
+// Active Pixel Set
+// ============================================================================
+// Twinkle, TwinkleFox, Snow Sparkle and the Christmas Chase
+// sparkles light a few random pixels and fade them out, but kept a level
+// per LED and walked all NUM_LEDS of them every step and again to draw.
+// On a 5000-LED strip that was thousands of dark pixels per frame for a
+// few dozen lit ones. Here, in the effect's per-LED state
+// (ACTIVE_LED_STATE bytes per LED):
+//
+//   lit bitmap      one bit per LED - is it in the set (spawning checks a
+//                   random LED in O(1))
+//   pixels          ActivePixel entries, dense in [0, count): LED, level,
+//                   phase and color - update() and drawing walk only these
+//
+// light() adds a pixel, update() visits every lit pixel and drops the ones
+// it returns false for (the last entry moves into the gap), shift() moves
+// them all along the strip. find() is a scan, for effects that re-light an
+// already lit LED - that happens about count/NUM_LEDS of the time.
+//
+// Capacity is ~60% of the strip, far more than twinkles ever light at once
+// at sane settings; light() fails when it is full, which on a tiny strip
+// at extreme settings just means fewer twinkles.
+// ============================================================================
+
+#define ACTIVE_LED_STATE    5       // Per-LED state bytes an effect registers
+
+// One lit pixel
+struct ActivePixel {
+    uint16_t led;
+    uint8_t level;      // Brightness
+    uint8_t phase;      // Effect-defined (e.g. brightening/dimming)
+    CRGB color;
+};
+
+// Set bookkeeping (in the effect's state struct)
+struct ActiveSet {
+    uint16_t count = 0;     // Lit pixels, entries [0, count)
+};
+
+// View of the bound instance's set - build one per frame with
+// ActivePool::bind()
+class ActivePool {
+public:
+    ActivePixel* pixels;
+    uint16_t capacity;
+
+    // Set in effectLedState() for NUM_LEDS LEDs
+    static ActivePool bind(ActiveSet& set) {
+        uint8_t* base = effectLedState();
+        uint32_t bitmapBytes = ((NUM_LEDS + 31) / 32) * 4;
+        uint32_t total = (uint32_t)NUM_LEDS * ACTIVE_LED_STATE;
+        uint16_t cap = total > bitmapBytes ? (total - bitmapBytes) / sizeof(ActivePixel) : 0;
+        if (set.count > cap) set.count = cap;
+        return ActivePool(set, base, (ActivePixel*)(base + bitmapBytes), cap);
+    }
+
+    uint16_t count() const { return set.count; }
+
+    bool isLit(uint16_t led) const {
+        return lit[led >> 3] & (1 << (led & 7));
+    }
+
+    // Add led to the set; nullptr if it is already lit or the set is full
+    ActivePixel* light(uint16_t led) {
+        if (isLit(led) || set.count >= capacity) return nullptr;
+        lit[led >> 3] |= 1 << (led & 7);
+        ActivePixel& p = pixels[set.count++];
+        p = { led, 0, 0, CRGB::Black };
+        return &p;
+    }
+
+    // Entry of a lit LED (nullptr if not lit)
+    ActivePixel* find(uint16_t led) {
+        if (!isLit(led)) return nullptr;
+        for (uint16_t i = 0; i < set.count; i++) {
+            if (pixels[i].led == led) return &pixels[i];
+        }
+        return nullptr;
+    }
+
+    // Entry for led, lit or newly lit (nullptr only when the set is full)
+    ActivePixel* touch(uint16_t led) {
+        ActivePixel* p = find(led);
+        return p != nullptr ? p : light(led);
+    }
+
+    // fn(pixel) for every lit pixel; pixels it returns false for go dark.
+    // Runs last to first so removal only moves pixels already visited.
+    template<typename F>
+    void update(F fn) {
+        for (int32_t i = (int32_t)set.count - 1; i >= 0; i--) {
+            if (!fn(pixels[i])) remove(i);
+        }
+    }
+
+    // Move every lit pixel delta LEDs along the strip; pixels that leave it
+    // go dark
+    void shift(int16_t delta) {
+        for (uint16_t i = 0; i < set.count; i++) {
+            lit[pixels[i].led >> 3] &= ~(1 << (pixels[i].led & 7));
+        }
+        for (int32_t i = (int32_t)set.count - 1; i >= 0; i--) {
+            int32_t led = (int32_t)pixels[i].led + delta;
+            if (led < 0 || led >= NUM_LEDS) {
+                pixels[i] = pixels[--set.count];
+            } else {
+                pixels[i].led = led;
+            }
+        }
+        for (uint16_t i = 0; i < set.count; i++) {
+            lit[pixels[i].led >> 3] |= 1 << (pixels[i].led & 7);
+        }
+    }
+
+private:
+    ActiveSet& set;
+    uint8_t* lit;
+
+    ActivePool(ActiveSet& s, uint8_t* bitmap, ActivePixel* px, uint16_t cap)
+        : pixels(px), capacity(cap), set(s), lit(bitmap) {}
+
+    void remove(uint16_t i) {
+        uint16_t led = pixels[i].led;
+        lit[led >> 3] &= ~(1 << (led & 7));
+        pixels[i] = pixels[--set.count];
+    }
+};
+
+#endif // ACTIVE_SET_H
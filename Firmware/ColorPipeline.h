@@ -0,0 +1,348 @@
+/*
+ * ColorPipeline.h - Output color correction
+ *
+ * Gamma, white point, color temperature and global hue/saturation,
+ * applied to the frame on its way to the LED driver
+ */
+
+#ifndef COLOR_PIPELINE_H
+#define COLOR_PIPELINE_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "HDRFrame.h"
+
+// ============================================================================
+// ColorConfig - Calibration settings (/api/led/color)
+// ============================================================================
+
+struct ColorConfig {
+    float gamma[3];       // Per channel R, G, B (1.0 = linear)
+    CRGB white;           // White point: per-channel full scale
+    uint16_t kelvin;      // Color temperature (LED_COLOR_NEUTRAL_K = none)
+    uint8_t hue;          // Hue rotation, 0-255 = full circle
+    uint8_t saturation;   // Percent (100 = unchanged, 0 = grey, 200 = double)
+};
+
+// ============================================================================
+// ColorPipeline - LUT-based correction in the output copy
+// ============================================================================
+// Everything is folded into lookup tables when the settings change, so the
+// per-pixel cost is a few table reads whatever is enabled:
+//
+//   hue/saturation   3x3 color matrix, stored as 9 tables of the products
+//                    (256 x int16 each, 4 fractional bits) - summed per
+//                    channel and clamped
+//   gamma, white     one table per channel from 8-bit value to 8.8 output
+//   point, kelvin,   (linear light): gamma curve, scaled by white point x
+//   brightness,      temperature x global brightness x the strip's color
+//   strip balance    correction (LED_COLOR_CORRECTION)
+//
+// apply() runs inside LEDOutput::present()'s copy into the driver buffer
+// and dithers the 8.8 result down to 8 bits (HDRFrame), so low brightness
+// keeps every level of the effect instead of a handful. leds[] is never
+// touched and effects that read back their last frame see uncorrected
+// colors. The matrix pass is skipped while hue/saturation are neutral, the
+// whole pipeline (plain memcpy) while everything is, brightness is full and
+// the strip needs no correction.
+//
+// toOutput() gives the same 8.8 output values for blending in linear light
+// (transitions); a 16-bit input is interpolated between table entries.
+//
+// configure() and setBrightness() build the tables on the caller's task
+// into a staging set; the LED task picks them up at its next present()
+// (latch()). FastLED's own correction is off (UncorrectedColor) - applied
+// there it would scale the already dithered values a second time.
+//
+// Needs LED_OUTPUT_DOUBLE_BUFFER (with a single buffer the driver sends
+// leds[] itself and there is no copy to correct in).
+// ============================================================================
+
+class ColorPipeline {
+public:
+    static bool begin() {
+        mutex = xSemaphoreCreateMutex();
+        if (mutex == NULL) {
+            LOG_ERROR("Failed to create color pipeline mutex!");
+            return false;
+        }
+        buildTables(config, brightness, live);
+        return true;
+    }
+
+    static ColorConfig defaults() {
+        return { { 1.0f, 1.0f, 1.0f }, CRGB(255, 255, 255), LED_COLOR_NEUTRAL_K, 0, 100 };
+    }
+
+    // Rebuild the tables for cfg (values are clamped to their valid ranges)
+    static void configure(const ColorConfig& cfg) {
+        ColorConfig c = cfg;
+        for (uint8_t ch = 0; ch < 3; ch++) {
+            c.gamma[ch] = constrain(c.gamma[ch], LED_COLOR_GAMMA_MIN, LED_COLOR_GAMMA_MAX);
+        }
+        c.kelvin = constrain(c.kelvin, LED_COLOR_KELVIN_MIN, LED_COLOR_KELVIN_MAX);
+        c.saturation = min<uint8_t>(c.saturation, 200);
+
+        if (mutex != NULL) xSemaphoreTake(mutex, portMAX_DELAY);
+        config = c;
+        buildTables(config, brightness, staging);
+        pending = true;
+        if (mutex != NULL) xSemaphoreGive(mutex);
+    }
+
+    // Global brightness (255 = full), applied in the 8.8 tables
+    static void setBrightness(uint8_t b) {
+        if (mutex != NULL) xSemaphoreTake(mutex, portMAX_DELAY);
+        brightness = b;
+        buildTables(config, brightness, staging);
+        pending = true;
+        if (mutex != NULL) xSemaphoreGive(mutex);
+    }
+
+    static const ColorConfig& getConfig() { return config; }
+
+    // Take over new tables (LED task, before the frame is copied out)
+    static void latch() {
+        if (!pending) return;
+        if (mutex != NULL) xSemaphoreTake(mutex, portMAX_DELAY);
+        live = staging;
+        pending = false;
+        if (mutex != NULL) xSemaphoreGive(mutex);
+    }
+
+    // True if apply() changes anything (otherwise copy the frame as is)
+    static bool isActive() { return !live.identity; }
+
+    // Correct and dither count pixels from src into dst. err is the dither
+    // error of src's LEDs; reversed reads both backwards from the last pixel.
+    // scale < 255 scales the 8.8 output values down before they are
+    // dithered (the power limiter, through a scaled copy of the tables).
+    // Returns non-zero if any value fell between output levels.
+    static uint8_t apply(CRGB* __restrict__ dst, const CRGB* __restrict__ src,
+                         uint8_t* __restrict__ err, uint16_t count, bool reversed,
+                         uint8_t scale = 255) {
+        int step = reversed ? -1 : 1;
+        if (reversed) {
+            src += count - 1;
+            err += (count - 1) * 3;
+        }
+
+        const uint16_t* lr = live.lut[0];
+        const uint16_t* lg = live.lut[1];
+        const uint16_t* lb = live.lut[2];
+        if (scale != 255) {
+            for (uint8_t ch = 0; ch < 3; ch++) {
+                for (uint16_t v = 0; v < 256; v++) {
+                    scaledLut[ch][v] = HDRFrame::scaleValue(live.lut[ch][v], scale);
+                }
+            }
+            lr = scaledLut[0];
+            lg = scaledLut[1];
+            lb = scaledLut[2];
+        }
+
+        uint16_t fraction = 0;
+        if (!live.useMatrix) {
+            for (uint16_t i = 0; i < count; i++, src += step, err += step * 3) {
+                uint16_t r = lr[src->r], g = lg[src->g], b = lb[src->b];
+                fraction |= r | g | b;
+                dst[i].r = HDRFrame::dither(r, err[0]);
+                dst[i].g = HDRFrame::dither(g, err[1]);
+                dst[i].b = HDRFrame::dither(b, err[2]);
+            }
+            return (uint8_t)fraction;
+        }
+
+        for (uint16_t i = 0; i < count; i++, src += step, err += step * 3) {
+            CRGB c = applyMatrix(*src);
+            uint16_t r = lr[c.r], g = lg[c.g], b = lb[c.b];
+            fraction |= r | g | b;
+            dst[i].r = HDRFrame::dither(r, err[0]);
+            dst[i].g = HDRFrame::dither(g, err[1]);
+            dst[i].b = HDRFrame::dither(b, err[2]);
+        }
+        return (uint8_t)fraction;
+    }
+
+    // Take back an apply() of the same pixels (unscaled): err as it was
+    // before, for the power limiter to dither them again scaled down
+    static void undo(const CRGB* src, uint8_t* err, uint16_t count) {
+        for (uint16_t i = 0; i < count; i++, err += 3) {
+            CRGB16 v = toOutput(src[i]);
+            HDRFrame::undither(v.r, err[0]);
+            HDRFrame::undither(v.g, err[1]);
+            HDRFrame::undither(v.b, err[2]);
+        }
+    }
+
+    // Output value (8.8, corrected, brightness applied) of an 8-bit color
+    static inline CRGB16 toOutput(CRGB c) {
+        if (live.useMatrix) c = applyMatrix(c);
+        return { live.lut[0][c.r], live.lut[1][c.g], live.lut[2][c.b] };
+    }
+
+    // Output value of an 8.8 color
+    static CRGB16 toOutput(CRGB16 c) {
+        if (live.useMatrix) {
+            int32_t in[3] = { c.r, c.g, c.b };
+            uint16_t* out[3] = { &c.r, &c.g, &c.b };
+            for (uint8_t o = 0; o < 3; o++) {
+                int32_t v = (live.coef[o][0] * in[0] + live.coef[o][1] * in[1] +
+                             live.coef[o][2] * in[2] + 2048) >> 12;
+                *out[o] = v < 0 ? 0 : (v > 0xFF00 ? 0xFF00 : v);
+            }
+        }
+        return { interpolate(live.lut[0], c.r), interpolate(live.lut[1], c.g),
+                 interpolate(live.lut[2], c.b) };
+    }
+
+    // dst = a faded towards b by amountOfB/65536, blended in output light
+    static void mix(CRGB16* __restrict__ dst, const CRGB* __restrict__ a,
+                    const CRGB* __restrict__ b, uint16_t count, uint16_t amountOfB) {
+        for (uint16_t i = 0; i < count; i++) {
+            CRGB16 x = toOutput(a[i]);
+            CRGB16 y = toOutput(b[i]);
+            dst[i].r = x.r + (((int32_t)y.r - x.r) * amountOfB >> 16);
+            dst[i].g = x.g + (((int32_t)y.g - x.g) * amountOfB >> 16);
+            dst[i].b = x.b + (((int32_t)y.b - x.b) * amountOfB >> 16);
+        }
+    }
+
+private:
+    struct Tables {
+        uint16_t lut[3][257];          // 8-bit value -> 8.8 output ([256] = [255])
+        int16_t matrix[3][3][256];     // matrix[out][in][v] = M[out][in] * v * 16
+        int32_t coef[3][3];            // M in Q12, for 16-bit input
+        bool identity;
+        bool useMatrix;
+    };
+
+    static ColorConfig config;
+    static uint8_t brightness;
+    static Tables live;       // LED task only
+    static Tables staging;    // Built by configure(), under mutex
+    static uint16_t scaledLut[3][256];   // live.lut scaled for one apply()
+    static volatile bool pending;
+    static SemaphoreHandle_t mutex;
+
+    // Matrix sum (4 fractional bits) to a channel value
+    static inline uint8_t clampChannel(int32_t v) {
+        v = (v + 8) >> 4;
+        return v < 0 ? 0 : (v > 255 ? 255 : v);
+    }
+
+    static inline CRGB applyMatrix(CRGB c) {
+        const int16_t (*m)[3][256] = live.matrix;
+        return CRGB(clampChannel(m[0][0][c.r] + m[0][1][c.g] + m[0][2][c.b]),
+                    clampChannel(m[1][0][c.r] + m[1][1][c.g] + m[1][2][c.b]),
+                    clampChannel(m[2][0][c.r] + m[2][1][c.g] + m[2][2][c.b]));
+    }
+
+    // Table value at an 8.8 position
+    static inline uint16_t interpolate(const uint16_t* lut, uint16_t v) {
+        uint8_t i = v >> 8, f = v & 0xFF;
+        return lut[i] + (((int32_t)lut[i + 1] - lut[i]) * f >> 8);
+    }
+
+    static void buildTables(const ColorConfig& c, uint8_t bright, Tables& t) {
+        float temp[3];
+        kelvinScale(c.kelvin, temp);
+
+        // FastLED's scaling for a correction channel: value * (c + 1) / 256
+        const CRGB strip(LED_COLOR_CORRECTION);
+
+        t.identity = true;
+        for (uint8_t ch = 0; ch < 3; ch++) {
+            float scale = c.white.raw[ch] / 255.0f * temp[ch] * (bright / 255.0f) *
+                          ((strip.raw[ch] + 1) / 256.0f);
+            for (uint16_t v = 0; v < 256; v++) {
+                float x = powf(v / 255.0f, c.gamma[ch]) * scale;
+                t.lut[ch][v] = (uint16_t)constrain(lroundf(x * 0xFF00), 0L, 0xFF00L);
+                t.identity &= t.lut[ch][v] == (v << 8);
+            }
+            t.lut[ch][256] = t.lut[ch][255];
+        }
+
+        float m[3][3];
+        colorMatrix(c.hue, c.saturation, m);
+        t.useMatrix = c.hue != 0 || c.saturation != 100;
+        t.identity &= !t.useMatrix;
+        for (uint8_t o = 0; o < 3; o++) {
+            for (uint8_t i = 0; i < 3; i++) {
+                t.coef[o][i] = lroundf(m[o][i] * 4096.0f);
+                for (uint16_t v = 0; v < 256; v++) {
+                    t.matrix[o][i][v] = (int16_t)lroundf(m[o][i] * v * 16.0f);
+                }
+            }
+        }
+    }
+
+    // Saturation x hue rotation, luminance preserving (Rec. 709 weights,
+    // as the SVG feColorMatrix saturate/hueRotate filters)
+    static void colorMatrix(uint8_t hue, uint8_t saturation, float m[3][3]) {
+        float a = hue * (2.0f * PI / 256.0f);
+        float cs = cosf(a), sn = sinf(a);
+        const float h[3][3] = {
+            { 0.213f + cs * 0.787f - sn * 0.213f, 0.715f - cs * 0.715f - sn * 0.715f, 0.072f - cs * 0.072f + sn * 0.928f },
+            { 0.213f - cs * 0.213f + sn * 0.143f, 0.715f + cs * 0.285f + sn * 0.140f, 0.072f - cs * 0.072f - sn * 0.283f },
+            { 0.213f - cs * 0.213f - sn * 0.787f, 0.715f - cs * 0.715f + sn * 0.715f, 0.072f + cs * 0.928f + sn * 0.072f }
+        };
+
+        float s = saturation / 100.0f;
+        const float sat[3][3] = {
+            { 0.213f + 0.787f * s, 0.715f - 0.715f * s, 0.072f - 0.072f * s },
+            { 0.213f - 0.213f * s, 0.715f + 0.285f * s, 0.072f - 0.072f * s },
+            { 0.213f - 0.213f * s, 0.715f - 0.715f * s, 0.072f + 0.928f * s }
+        };
+
+        for (uint8_t o = 0; o < 3; o++) {
+            for (uint8_t i = 0; i < 3; i++) {
+                m[o][i] = sat[o][0] * h[0][i] + sat[o][1] * h[1][i] + sat[o][2] * h[2][i];
+            }
+        }
+    }
+
+    // Black body color of kelvin relative to the neutral point, brightest
+    // channel 1.0 (Tanner Helland's fit of the CIE data)
+    static void kelvinScale(uint16_t kelvin, float out[3]) {
+        float k[3], n[3];
+        blackBody(kelvin, k);
+        blackBody(LED_COLOR_NEUTRAL_K, n);
+
+        float peak = 0;
+        for (uint8_t ch = 0; ch < 3; ch++) {
+            out[ch] = n[ch] > 0 ? k[ch] / n[ch] : 1.0f;
+            peak = max(peak, out[ch]);
+        }
+        for (uint8_t ch = 0; ch < 3; ch++) {
+            out[ch] /= peak;
+        }
+    }
+
+    static void blackBody(uint16_t kelvin, float rgb[3]) {
+        float t = kelvin / 100.0f;
+        rgb[0] = t <= 66 ? 255.0f : 329.698727446f * powf(t - 60, -0.1332047592f);
+        rgb[1] = t <= 66 ? 99.4708025861f * logf(t) - 161.1195681661f
+                         : 288.1221695283f * powf(t - 60, -0.0755148492f);
+        rgb[2] = t >= 66 ? 255.0f : (t <= 19 ? 0.0f : 138.5177312231f * logf(t - 10) - 305.0447927307f);
+        for (uint8_t ch = 0; ch < 3; ch++) {
+            rgb[ch] = constrain(rgb[ch], 0.0f, 255.0f);
+        }
+    }
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+ColorConfig ColorPipeline::config = ColorPipeline::defaults();
+uint8_t ColorPipeline::brightness = 255;
+ColorPipeline::Tables ColorPipeline::live = {};
+ColorPipeline::Tables ColorPipeline::staging = {};
+volatile bool ColorPipeline::pending = false;
+SemaphoreHandle_t ColorPipeline::mutex = NULL;
+uint16_t ColorPipeline::scaledLut[3][256];
+
+#endif // COLOR_PIPELINE_H
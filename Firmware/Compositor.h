@@ -0,0 +1,211 @@
+/*
+ * Compositor.h - Layer stack blending
+ *
+ * Blends per-layer render buffers into the output frame
+ */
+
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "LEDKernels.h"
+
+// ============================================================================
+// Blend Modes
+// ============================================================================
+// level is the layer's brightness - it scales the layer before blending,
+// except in BLEND_ALPHA where it is the opacity of the unscaled layer and in
+// BLEND_MULTIPLY where it is the strength of the darkening.
+// ============================================================================
+
+enum BlendMode : uint8_t {
+    BLEND_NORMAL = 0,     // Replace what is below
+    BLEND_ADD,            // Saturating add (sparkles, glitter, lightning)
+    BLEND_SCREEN,         // Like add, but never clips to white
+    BLEND_ALPHA,          // Cross-mix with the layer below by level
+    BLEND_MAX,            // Brighter channel wins
+    BLEND_MULTIPLY,       // Darken the layer below (masks, vignettes)
+    BLEND_MODE_COUNT
+};
+
+// ============================================================================
+// Compositor - Fused composite of a layer stack
+// ============================================================================
+// compose() walks the frame once. The strip is cut into spans at every layer
+// edge, so inside a span the set of covering layers is fixed; each span is
+// processed in small chunks and all its layers are blended into a chunk
+// while it is still in cache, bottom to top, before moving on. Layers below
+// the topmost full-level BLEND_NORMAL layer are hidden and skipped.
+//
+// The kernels work on plain byte arrays (CRGB is 3 packed bytes) with no
+// aliasing, one branch-free loop per mode, so the compiler can vectorize
+// them.
+// ============================================================================
+
+class Compositor {
+public:
+    struct Layer {
+        const CRGB* pixels;   // Layer buffer, length LEDs
+        uint16_t start;       // First frame LED covered
+        uint16_t length;
+        uint8_t level;
+        BlendMode mode;
+    };
+
+    static constexpr uint8_t MAX_LAYERS = LED_MAX_SEGMENTS;
+
+    // Compose layers (bottom first) over black into frame
+    static void compose(CRGB* frame, uint16_t frameLen, const Layer* layers, uint8_t count) {
+        count = min(count, MAX_LAYERS);
+
+        // Span edges: strip ends plus every layer edge, sorted and unique
+        uint16_t edges[2 * MAX_LAYERS + 2];
+        uint8_t numEdges = 0;
+        addEdge(edges, numEdges, 0);
+        addEdge(edges, numEdges, frameLen);
+        for (uint8_t l = 0; l < count; l++) {
+            addEdge(edges, numEdges, min<uint16_t>(layers[l].start, frameLen));
+            addEdge(edges, numEdges, min<uint16_t>(layers[l].start + layers[l].length, frameLen));
+        }
+
+        for (uint8_t e = 0; e + 1 < numEdges; e++) {
+            uint16_t spanStart = edges[e];
+            uint16_t spanEnd = edges[e + 1];
+
+            // Layers covering this span, from the lowest visible one up
+            uint8_t active[MAX_LAYERS];
+            uint8_t numActive = 0;
+            for (uint8_t l = 0; l < count; l++) {
+                const Layer& layer = layers[l];
+                if (layer.start > spanStart || layer.start + layer.length < spanEnd) {
+                    continue;
+                }
+                if (layer.mode == BLEND_NORMAL && layer.level == 255) {
+                    numActive = 0;    // Opaque - hides everything below
+                }
+                active[numActive++] = l;
+            }
+
+            for (uint16_t c = spanStart; c < spanEnd; c += CHUNK_LEDS) {
+                uint16_t n = min<uint16_t>(CHUNK_LEDS, spanEnd - c);
+                uint8_t* dst = (uint8_t*)(frame + c);
+
+                uint8_t first = 0;
+                if (numActive > 0 && layers[active[0]].mode == BLEND_NORMAL) {
+                    const Layer& layer = layers[active[0]];
+                    blendSpan(dst, (const uint8_t*)(layer.pixels + (c - layer.start)),
+                              n * 3, layer.level, BLEND_NORMAL);
+                    first = 1;
+                } else {
+                    memset(dst, 0, n * sizeof(CRGB));
+                }
+
+                for (uint8_t a = first; a < numActive; a++) {
+                    const Layer& layer = layers[active[a]];
+                    blendSpan(dst, (const uint8_t*)(layer.pixels + (c - layer.start)),
+                              n * 3, layer.level, layer.mode);
+                }
+            }
+        }
+    }
+
+    // Blend bytes of src onto dst
+    static void blendSpan(uint8_t* __restrict__ dst, const uint8_t* __restrict__ src,
+                          uint16_t bytes, uint8_t level, BlendMode mode) {
+        switch (mode) {
+            case BLEND_NORMAL:
+                if (level == 255) {
+                    memcpy(dst, src, bytes);
+                } else {
+                    for (uint16_t i = 0; i < bytes; i++) {
+                        dst[i] = scale8_video(src[i], level);
+                    }
+                }
+                break;
+
+            case BLEND_ADD:
+                if (level == 255) {
+                    LEDKernels::addBytes(dst, src, bytes);
+                    break;
+                }
+                for (uint16_t i = 0; i < bytes; i++) {
+                    dst[i] = qadd8(dst[i], scale8_video(src[i], level));
+                }
+                break;
+
+            case BLEND_SCREEN:
+                for (uint16_t i = 0; i < bytes; i++) {
+                    uint8_t s = scale8_video(src[i], level);
+                    dst[i] = 255 - scale8(255 - dst[i], 255 - s);
+                }
+                break;
+
+            case BLEND_ALPHA:
+                for (uint16_t i = 0; i < bytes; i++) {
+                    dst[i] = blend8(dst[i], src[i], level);
+                }
+                break;
+
+            case BLEND_MAX:
+                for (uint16_t i = 0; i < bytes; i++) {
+                    uint8_t s = scale8_video(src[i], level);
+                    dst[i] = dst[i] > s ? dst[i] : s;
+                }
+                break;
+
+            case BLEND_MULTIPLY:
+                for (uint16_t i = 0; i < bytes; i++) {
+                    uint8_t s = 255 - scale8(255 - src[i], level);
+                    dst[i] = scale8(dst[i], s);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    // ========================================================================
+    // Names (web API)
+    // ========================================================================
+
+    static const char* modeName(BlendMode mode) {
+        return mode < BLEND_MODE_COUNT ? modeNames[mode] : "normal";
+    }
+
+    static bool parseMode(const char* name, BlendMode& mode) {
+        if (name == nullptr) return false;
+        for (uint8_t m = 0; m < BLEND_MODE_COUNT; m++) {
+            if (!strcmp(name, modeNames[m])) {
+                mode = (BlendMode)m;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    // 64 LEDs = 192 bytes per chunk stays in cache across all layers
+    static constexpr uint16_t CHUNK_LEDS = 64;
+
+    static constexpr const char* modeNames[BLEND_MODE_COUNT] = {
+        "normal", "add", "screen", "alpha", "max", "multiply"
+    };
+
+    static void addEdge(uint16_t* edges, uint8_t& count, uint16_t value) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (edges[i] == value) return;
+        }
+        uint8_t i = count;
+        while (i > 0 && edges[i - 1] > value) {
+            edges[i] = edges[i - 1];
+            i--;
+        }
+        edges[i] = value;
+        count++;
+    }
+};
+
+#endif // COMPOSITOR_H
@@ -61,6 +61,15 @@
 #define NVS_KEY_PASSWORD          "wifi_pass"
 #define NVS_KEY_PROVISIONED       "provisioned"
 #define NVS_KEY_LED_EFFECT        "led_effect"
+#define NVS_KEY_LED_COUNT         "led_count"
+#define NVS_KEY_LED_OUTPUTS       "led_outputs"
+#define NVS_KEY_LED_SEGMENTS      "led_segments"
+#define NVS_KEY_LED_TRANS_MS      "led_trans_ms"
+#define NVS_KEY_LED_TRANS_CURVE   "led_trans_crv"
+#define NVS_KEY_LED_PLAYLIST      "led_playlist"
+#define NVS_KEY_LED_COLOR         "led_color"
+#define NVS_KEY_LED_GEOMETRY      "led_geometry"
+#define NVS_MAX_STRING_LEN        4000    // NVS string value limit, terminator included
 
 // ----------------------------------------------------------------------------
 // GPIO Pin Configuration
@@ -71,13 +80,45 @@
 
 // Future ARGB LED pins
 #define ARGB_DATA_PIN             44     // GPIO44 = D7 on XIAO ESP32S3
-#define ARGB_NUM_LEDS             75     // 75 ARGB LEDs on the chain
-#define LED_TARGET_FPS            60     // Target frame rate for animations
+#define ARGB_NUM_LEDS             75     // Default strip length (runtime value lives in NVS)
+#define ARGB_MAX_LEDS             5000   // Upper bound accepted for the runtime strip length
+#define LED_TARGET_FPS            60     // Target frame rate (lowered automatically for long strips)
+#define EFFECT_REF_FRAME_MS       16     // Frame period effect speeds are tuned at (independent of FPS)
+#define EFFECT_MAX_DT_MS          100    // Longest frame time effects catch up in one frame
+#define EFFECT_MAX_STEPS          8      // More steps due than this = effect was paused, resync
+#define LED_OUTPUT_DOUBLE_BUFFER  true   // Render next frame while the previous one is sent
+
+// Parallel outputs: the strip can be split over several data pins that are
+// sent at the same time (e.g. 44, 43, 1, 2). Each pin is one RMT TX channel
+// and the ESP32-S3 has only 4, so at most LED_OUTPUT_MAX_PINS. The split
+// itself is runtime config (POST /api/led/outputs); the pins are fixed at
+// build time.
+#define LED_OUTPUT_PINS           ARGB_DATA_PIN
+#define LED_OUTPUT_MAX_PINS       4      // RMT TX channels on the ESP32-S3
+#define LED_PARALLEL_RENDER       true   // Split tile-capable effects across both cores
+#define LED_PARALLEL_MIN_LEDS     300    // Shorter strips render faster on one core
+#define LED_KERNELS_PIE           true   // ESP32-S3 vector unit for fill/fade (LEDKernels.h)
+#define LED_POWER_VOLTS           5      // Strip supply voltage (for the W figures)
+#define LED_POWER_LIMIT_MW        45000  // Supply budget of the whole strip (0 = unlimited)
+#define LED_MAX_SEGMENTS          8      // Independent effect ranges (/api/led/segments)
+#define LED_TRANSITION_MS         500    // Default crossfade on effect change (0 = hard cut)
+#define LED_TRANSITION_MAX_MS     10000  // Longest transition accepted by /api/led/transition
+#define LED_MAX_PLAYLIST          8      // Entries in the on-device playlist (/api/led/playlist)
+#define LED_PLAYLIST_MIN_MS       1000   // Shortest time on one playlist entry
+#define LED_DITHER_HOLD_FRAMES    120    // Frames an unchanged scene keeps dithering before it rests
+#define LED_COLOR_CORRECTION      TypicalLEDStrip  // Strip's RGB balance (in the output tables)
+#define LED_COLOR_NEUTRAL_K       6500   // Color temperature that leaves white unchanged
+#define LED_COLOR_KELVIN_MIN      1900   // Color temperature range (/api/led/color)
+#define LED_COLOR_KELVIN_MAX      10000
+#define LED_COLOR_GAMMA_MIN       1.0f   // Output gamma range (1.0 = linear)
+#define LED_COLOR_GAMMA_MAX       3.0f
 
 // ----------------------------------------------------------------------------
 // Development Mode
 // ----------------------------------------------------------------------------
 #define DEV_MODE                  false   // Reset credentials on boot (development)
+#define LED_EFFECT_CHECKS         false   // Flag effects that block, show or overrun their slice
+#define LED_EFFECT_SLICE_PCT      50      // Share of the frame period one effect render may use
 
 // ----------------------------------------------------------------------------
 // Task Configuration (FreeRTOS)
@@ -90,6 +131,10 @@
 #define TASK_PRIORITY_LOGGER      0
 #define TASK_STACK_SIZE_LED       8192
 #define TASK_PRIORITY_LED         3      // Higher than WiFi/BLE for smooth animations
+#define TASK_STACK_SIZE_LED_SHOW  4096
+#define TASK_PRIORITY_LED_SHOW    4      // Above LED task so a ready frame goes out at once
+#define TASK_STACK_SIZE_LED_TILE  4096
+#define TASK_PRIORITY_LED_TILE    3      // Core 1 render worker (TileRenderer)
 
 // ----------------------------------------------------------------------------
 // Logging Configuration
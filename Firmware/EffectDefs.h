@@ -11,34 +11,244 @@
 #include "Config.h"
 #include "EffectParams.h"
 #include "Palettes.h"
-
-// Define NUM_LEDS for compatibility with Effects.h 
-// (Effects.h uses NUM_LEDS, Config.h uses ARGB_NUM_LEDS)
-#ifndef NUM_LEDS
-#define NUM_LEDS ARGB_NUM_LEDS
-#endif
+#include "LEDKernels.h"
 
 // ============================================================================
 // Global LED Array
 // ============================================================================
 
-CRGB leds[ARGB_NUM_LEDS];
+// Strip length is chosen at boot (NVS), so effects read it at runtime.
+// NUM_LEDS is kept as the name Effects.h uses.
+uint16_t numLeds = ARGB_NUM_LEDS;
+CRGB* leds = nullptr;
+
+#define NUM_LEDS numLeds
+
+// Allocate a zeroed per-LED buffer. PSRAM requests fall back to internal
+// RAM on boards without PSRAM.
+template<typename T>
+T* allocLedBuffer(uint16_t count, uint32_t caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) {
+    T* buf = (T*)heap_caps_calloc(count, sizeof(T), caps);
+    if (buf == nullptr && (caps & MALLOC_CAP_SPIRAM)) {
+        buf = (T*)heap_caps_calloc(count, sizeof(T), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    return buf;
+}
+
+// Set strip length and allocate the render buffer (once, at boot).
+// leds[] is touched by every effect on every frame, so keep it internal.
+bool allocLeds(uint16_t count) {
+    numLeds = count;
+    leds = allocLedBuffer<CRGB>(count, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (leds == nullptr) {
+        leds = allocLedBuffer<CRGB>(count);
+    }
+    return leds != nullptr;
+}
+
+// ============================================================================
+// Effect Timebase
+// ============================================================================
+// Effects were tuned on 16 ms frames (EFFECT_REF_FRAME_MS). They no longer
+// step once per call; the LED task stamps effectTime once per frame and
+// effects scale their motion by it, so frame rate changes (LED_TARGET_FPS,
+// long strips, dropped frames) leave animation speed alone:
+//   - smooth phases add effectStep8(perFrame) to a Q8.8 accumulator
+//   - "every N ms" steps run effectSteps(last, delayMs) times; steps sit on
+//     the reference frame grid, so on 16 ms frames they fire exactly where
+//     the old millis() - last > delayMs check did
+//   - per-frame simulations (fades, fire) run effectTime.frames times
+
+struct EffectTime {
+    uint32_t now;       // millis() at frame start
+    uint16_t dt;        // ms since the previous frame (clamped)
+    uint16_t dt8;       // dt in reference frames, Q8.8 (256 = one frame)
+    uint8_t frames;     // Reference frames completed during dt
+    uint32_t ticks8;    // Reference frames since start, Q8.8
+};
+
+EffectTime effectTime = { 0, 0, 0, 0, 0 };
+
+// Restart the timebase (LED task start)
+inline void resetEffectTime(uint32_t nowMs) {
+    effectTime = { nowMs, 0, 0, 0, 0 };
+}
+
+// Step the timebase to the current frame
+inline void advanceEffectTime(uint32_t nowMs) {
+    uint32_t dt = min<uint32_t>(nowMs - effectTime.now, EFFECT_MAX_DT_MS);
+    uint32_t prevTicks8 = effectTime.ticks8;
+
+    effectTime.now = nowMs;
+    effectTime.dt = dt;
+    effectTime.dt8 = dt * 256 / EFFECT_REF_FRAME_MS;
+    effectTime.ticks8 += effectTime.dt8;
+    effectTime.frames = (effectTime.ticks8 >> 8) - (prevTicks8 >> 8);
+}
+
+// Frame time spanning back to an earlier frame, for effects that are not
+// rendered every frame (segment fpsDivider)
+inline EffectTime effectTimeSince(uint32_t sinceTicks8) {
+    EffectTime t = effectTime;
+    uint32_t elapsed8 = min<uint32_t>(t.ticks8 - sinceTicks8,
+                                      EFFECT_MAX_DT_MS * 256 / EFFECT_REF_FRAME_MS);
+    t.dt8 = elapsed8;
+    t.dt = elapsed8 * EFFECT_REF_FRAME_MS / 256;
+    t.frames = (t.ticks8 >> 8) - ((t.ticks8 - elapsed8) >> 8);
+    return t;
+}
+
+// Per-frame amount scaled to this frame's duration, Q8.8
+inline uint32_t effectStep8(uint16_t perFrame) {
+    return (uint32_t)perFrame * effectTime.dt8;
+}
+
+// Per-frame amount times the reference frames this frame covers (saturated),
+// for qsub8()/qadd8() fades
+inline uint8_t effectFrameAmount(uint8_t perFrame) {
+    return min<uint16_t>(255, (uint16_t)perFrame * effectTime.frames);
+}
+
+// Length of an "every delayMs" step in ticks8 (whole reference frames)
+inline uint32_t effectStepPeriod8(uint16_t delayMs) {
+    return ((uint32_t)delayMs / EFFECT_REF_FRAME_MS + 1) << 8;
+}
+
+// How many "every delayMs" steps are due this frame. last is the effect's
+// step time in ticks8 and advances by the steps returned.
+inline uint8_t effectSteps(uint32_t& last, uint16_t delayMs) {
+    uint32_t period8 = effectStepPeriod8(delayMs);
+    uint32_t elapsed8 = effectTime.ticks8 - last;
+    if (elapsed8 < period8) {
+        return 0;
+    }
+
+    uint32_t steps = elapsed8 / period8;
+    if (steps > EFFECT_MAX_STEPS) {
+        // Effect was not running (switched away, power off) - resume, don't burst
+        last = effectTime.ticks8;
+        return 1;
+    }
+    last += steps * period8;
+    return steps;
+}
+
+// How far into the next step this frame is (0..255), after effectSteps() -
+// for drawing motion between steps
+inline uint8_t effectStepFraction(uint32_t last, uint16_t delayMs) {
+    uint32_t period8 = effectStepPeriod8(delayMs);
+    uint32_t elapsed8 = effectTime.ticks8 - last;
+    return elapsed8 >= period8 ? 255 : elapsed8 * 256 / period8;
+}
+
+// ============================================================================
+// Fixed-Point Math
+// ============================================================================
+// Positions, velocities and phases are Q16.16 (int32_t, 1.0 = Q16_ONE):
+// the LED task does no float work, and results are the same on both cores
+// and on the host. Positions are in LEDs, which leaves room for strips far
+// longer than ARGB_MAX_LEDS.
+
+typedef int32_t q16_16;
+
+#define Q16_ONE   65536
+
+// num/den as Q16.16, rounded - constants (0.25 = q16Ratio(1, 4)) and
+// param scaling (den > 0)
+constexpr q16_16 q16Ratio(int32_t num, int32_t den) {
+    return (q16_16)((((int64_t)num << 16) + (num < 0 ? -den / 2 : den / 2)) / den);
+}
+
+// Whole LEDs (floor)
+constexpr int32_t q16Int(q16_16 x) {
+    return x >> 16;
+}
+
+// num/den added once per step (gravity), carrying the rounding remainder
+// from step to step: a rounded q16Ratio() is off by up to half a unit every
+// step, which over a few hundred steps of a fall puts a particle a good
+// fraction of an LED off, while n steps of next() stay within half a unit
+// of n * num/den. Keep one in the effect state (num >= 0, den > 0 and the
+// same den every step).
+struct Q16Step {
+    int32_t carry = 0;      // Remainder, [-den/2, den/2)
+
+    q16_16 next(int32_t num, int32_t den) {
+        int64_t scaled = (int64_t)num << 16;
+        q16_16 step = (q16_16)(scaled / den);
+        carry += (int32_t)(scaled % den);
+        if (carry >= den / 2) {
+            carry -= den;
+            step++;
+        }
+        return step;
+    }
+};
+
+// ============================================================================
+// Effect State
+// ============================================================================
+// Effects keep their animation state in a struct (member initializers are
+// the start values) plus optional per-LED bytes, and never in statics. The
+// memory belongs to an EffectInstance (EffectInstance.h), which binds it
+// here before the effect runs - the same way segments re-point leds/NUM_LEDS
+// - so one effect can run in several instances at once.
+
+void* effectStateBlock = nullptr;
+uint8_t* effectLedStateBlock = nullptr;
+
+// State struct of the bound instance
+template<typename T>
+inline T& effectState() {
+    return *(T*)effectStateBlock;
+}
+
+// Per-LED state of the bound instance (ledStateSize bytes per LED)
+inline uint8_t* effectLedState() {
+    return effectLedStateBlock;
+}
+
+// ============================================================================
+// Effect Contract Checks (LED_EFFECT_CHECKS)
+// ============================================================================
+// Debug builds route blocking and output calls made from Effects.h here (see
+// the contract there). The call is dropped and the first offender of the
+// frame is reported by LEDStats after the effect returns.
+
+#if LED_EFFECT_CHECKS
+const char* volatile effectViolation = nullptr;
+
+inline void effectBlockingCall(const char* what) {
+    if (effectViolation == nullptr) effectViolation = what;
+}
+
+// Stands in for FastLED inside Effects.h - the output belongs to the LED task
+struct EffectFastLEDGuard {
+    template<typename... Args> void show(Args...) { effectBlockingCall("FastLED.show()"); }
+    // FastLED.delay(ms) lands here through the delay() macro
+    void effectBlockingCall(const char* what) { ::effectBlockingCall(what); }
+    template<typename... Args> void clear(Args...) { effectBlockingCall("FastLED.clear()"); }
+};
+EffectFastLEDGuard effectFastLEDGuard;
+#endif
 
 // ============================================================================
 // Helper Functions (used by Effects.h)
 // ============================================================================
 
+// Clear the render buffer (FastLED.clear() would clear the output buffer)
+inline void clearLeds() {
+    LEDKernels::fill(leds, NUM_LEDS, CRGB::Black);
+}
+
 // Fade all LEDs by a given amount
 inline void fadeAll(uint8_t amount) {
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        leds[i].nscale8(255 - amount);
-    }
+    LEDKernels::fade(leds, NUM_LEDS, amount);
 }
 
 // Get color from palette
 inline CRGB getColorFromPalette(PaletteType paletteType, uint8_t index, uint8_t brightness = 255) {
-    CRGBPalette16 palette = getPalette(paletteType);
-    return ColorFromPalette(palette, index, brightness, LINEARBLEND);
+    return paletteColor(PaletteCache::get(paletteType), index, brightness);
 }
 
 // ============================================================================
@@ -168,39 +378,25 @@ StrobeParams strobeParams = { .frequency = 200, .color = CRGB::White, .mode = ST
 // Helper Functions
 // ============================================================================
 
-// Map LED position based on direction
-uint16_t mapLed(uint16_t pos, Direction dir) {
-    switch (dir) {
-        case DIR_REVERSE: // Reverse/Left
-        case DIR_DOWN:    // Down (same as reverse for 1D strip)
-        case DIR_CCW:     // Counter-clockwise (same as reverse)
-            return ARGB_NUM_LEDS - 1 - pos;
-        
-        case DIR_FORWARD: // Forward/Right (default)
-        case DIR_UP:      // Up (same as forward for 1D strip)
-        case DIR_CW:      // Clockwise (same as forward)
-        default:
-            return pos;
-    }
-}
+// mapLed()/ledPositions() live in LEDGeometry.h (direction tables)
 
 // Safe LED set with bounds checking
 void setLedSafe(uint16_t pos, CRGB color) {
-    if (pos < ARGB_NUM_LEDS) {
+    if (pos < NUM_LEDS) {
         leds[pos] = color;
     }
 }
 
 // Add color (blend)
 void addLedSafe(uint16_t pos, CRGB color) {
-    if (pos < ARGB_NUM_LEDS) {
+    if (pos < NUM_LEDS) {
         leds[pos] += color;
     }
 }
 
 // Blend with fade
 void blendLedSafe(uint16_t pos, CRGB color, uint8_t amount) {
-    if (pos < ARGB_NUM_LEDS) {
+    if (pos < NUM_LEDS) {
         leds[pos] = blend(leds[pos], color, amount);
     }
 }
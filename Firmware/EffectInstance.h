@@ -0,0 +1,83 @@
+/*
+ * EffectInstance.h - Per-instance effect state
+ *
+ * Owns the state an effect animates with, so effects can be reset on
+ * switch and run in several places at once
+ */
+
+#ifndef EFFECT_INSTANCE_H
+#define EFFECT_INSTANCE_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "EffectDefs.h"
+#include "EffectTable.h"
+
+// ============================================================================
+// EffectInstance - One running effect's state block
+// ============================================================================
+// init() allocates a single block for a range of LEDs, big enough for any
+// effect: the largest state struct followed by the largest per-LED state.
+// After that nothing is allocated again - switching effects is reset(),
+// which rebuilds the struct from its start values and zeroes the per-LED
+// bytes the effect uses. bind() points effectState()/effectLedState() at
+// the block for the next render.
+//
+// The main effect owns one instance; every segment owns its own. A running
+// transition (LEDTransition) holds the outgoing effect's.
+// ============================================================================
+
+class EffectInstance {
+public:
+    // Allocate the state block for length LEDs (call once)
+    bool init(uint16_t length) {
+        uint32_t bytes = STATE_BYTES + (uint32_t)maxEffectLedStateSize() * length;
+        block = allocLedBuffer<uint32_t>((bytes + 3) / 4);
+        ledCount = length;
+        return block != nullptr;
+    }
+
+    void release() {
+        heap_caps_free(block);
+        block = nullptr;
+        ledCount = 0;
+    }
+
+    // Put the effect back to its starting state
+    void reset(uint8_t effect) {
+        if (block == nullptr || effect >= NUM_EFFECT_ENTRIES) return;
+
+        const EffectEntry& entry = effectTable[effect];
+        if (entry.resetState != nullptr) {
+            entry.resetState(block);
+        }
+        memset(ledState(), 0, (size_t)entry.ledStateSize * ledCount);
+    }
+
+    // Make this instance's state the one effects see
+    void bind() const {
+        effectStateBlock = block;
+        effectLedStateBlock = ledState();
+    }
+
+    // Exchange blocks with another instance of the same length - hands a
+    // running effect over without copying its state
+    void swap(EffectInstance& other) {
+        uint32_t* tmp = block;
+        block = other.block;
+        other.block = tmp;
+    }
+
+private:
+    // State struct area, rounded up to keep the per-LED bytes word aligned
+    static constexpr uint32_t STATE_BYTES = (maxEffectStateSize() + 3) & ~3u;
+
+    uint32_t* block = nullptr;
+    uint16_t ledCount = 0;
+
+    uint8_t* ledState() const {
+        return block != nullptr ? (uint8_t*)block + STATE_BYTES : nullptr;
+    }
+};
+
+#endif // EFFECT_INSTANCE_H
@@ -459,7 +459,8 @@ extern PoliceLightsParams policeLightsParams;
 extern StrobeParams strobeParams;
 
 // Global variables accessible to effects
-extern CRGB leds[];
+extern CRGB* leds;
+extern uint16_t numLeds;
 extern uint32_t frameCounter;
 extern uint32_t lastFrameTime;
 
@@ -0,0 +1,144 @@
+/*
+ * EffectTable.h - Registry of all LED effects
+ * 
+ * Single list of effects shared by LEDController and the host
+ * simulation build (host/), indexed by effect ID
+ */
+
+#ifndef EFFECT_TABLE_H
+#define EFFECT_TABLE_H
+
+#include <new>
+#include "Config.h"
+#include "Effects.h"
+
+// Effect definition
+struct EffectEntry {
+    const char* name;
+    void (*func)();
+    uint8_t category;
+    
+    // Parameter struct of this effect (copied in/out per segment)
+    void* params;
+    uint8_t paramsSize;
+    
+    // Animation state (see EffectInstance.h): struct size, bytes per LED and
+    // a function that puts the struct back to its start values
+    uint16_t stateSize;
+    uint8_t ledStateSize;
+    void (*resetState)(void* state);
+    
+    // Optional split form for parallel rendering (nullptr = render with func).
+    // tile() must only touch leds[start..end) and read no shared mutable state.
+    void (*tile)(uint16_t start, uint16_t end);
+    void (*advance)();
+};
+
+template<typename T>
+void resetEffectState(void* state) {
+    new (state) T();
+}
+
+#define EFFECT_PARAMS(p) &p, sizeof(p)
+#define EFFECT_STATE(T, perLed) sizeof(T), perLed, resetEffectState<T>
+#define EFFECT_LED_STATE(perLed) 0, perLed, nullptr
+#define EFFECT_NO_STATE 0, 0, nullptr
+
+// Effect function array
+constexpr EffectEntry effectTable[] = {
+    // Category 1: Static
+    {"Solid", effectSolid, 1, EFFECT_PARAMS(solidParams), EFFECT_NO_STATE, nullptr, nullptr},
+    {"Gradient", effectGradient, 1, EFFECT_PARAMS(gradientParams), EFFECT_NO_STATE, nullptr, nullptr},
+    {"Spots", effectSpots, 1, EFFECT_PARAMS(spotsParams), EFFECT_NO_STATE, nullptr, nullptr},
+    {"Pattern", effectPattern, 1, EFFECT_PARAMS(patternParams), EFFECT_NO_STATE, nullptr, nullptr},
+    
+    // Category 2: Wave/Fale
+    {"Rainbow Wave", effectRainbowWave, 2, EFFECT_PARAMS(rainbowWaveParams), EFFECT_STATE(RainbowWaveState, 0), effectRainbowWaveTile, effectRainbowWaveAdvance},
+    {"Color Wave", effectColorWave, 2, EFFECT_PARAMS(colorWaveParams), EFFECT_STATE(ColorWaveState, 0), effectColorWaveTile, effectColorWaveAdvance},
+    {"Oscillate", effectOscillate, 2, EFFECT_PARAMS(oscillateParams), EFFECT_STATE(OscillateState, 0), nullptr, nullptr},
+    {"Wavy", effectWavy, 2, EFFECT_PARAMS(wavyParams), EFFECT_STATE(WavyState, 0), nullptr, nullptr},
+    
+    // Category 3: Chase/Running
+    {"Theater Chase", effectTheaterChase, 3, EFFECT_PARAMS(theaterChaseParams), EFFECT_STATE(TheaterChaseState, 0), nullptr, nullptr},
+    {"Scanner", effectScanner, 3, EFFECT_PARAMS(scannerParams), EFFECT_STATE(ScannerState, PARTICLE_LED_STATE), nullptr, nullptr},
+    {"Comet", effectComet, 3, EFFECT_PARAMS(cometParams), EFFECT_STATE(CometState, PARTICLE_LED_STATE), nullptr, nullptr},
+    {"Running Lights", effectRunningLights, 3, EFFECT_PARAMS(runningLightsParams), EFFECT_STATE(RunningLightsState, 0), nullptr, nullptr},
+    {"Android", effectAndroid, 3, EFFECT_PARAMS(androidParams), EFFECT_STATE(AndroidState, 0), nullptr, nullptr},
+    
+    // Category 4: Twinkle/Sparkle
+    {"Twinkle", effectTwinkle, 4, EFFECT_PARAMS(twinkleParams), EFFECT_STATE(TwinkleState, ACTIVE_LED_STATE), nullptr, nullptr},
+    {"TwinkleFox", effectTwinkleFox, 4, EFFECT_PARAMS(twinkleFoxParams), EFFECT_STATE(TwinkleFoxState, ACTIVE_LED_STATE), nullptr, nullptr},
+    {"Sparkle", effectSparkle, 4, EFFECT_PARAMS(sparkleParams), EFFECT_STATE(SparkleState, 0), nullptr, nullptr},
+    {"Glitter", effectGlitter, 4, EFFECT_PARAMS(glitterParams), EFFECT_STATE(GlitterState, 0), nullptr, nullptr},
+    {"Starry Night", effectStarryNight, 4, EFFECT_PARAMS(starryNightParams), EFFECT_STATE(StarryNightState, 1), nullptr, nullptr},
+    
+    // Category 5: Fire/Organic
+    {"Fire", effectFire, 5, EFFECT_PARAMS(fireParams), EFFECT_LED_STATE(1), nullptr, nullptr},
+    {"Candle", effectCandle, 5, EFFECT_PARAMS(candleParams), EFFECT_STATE(CandleState, 1), nullptr, nullptr},
+    {"Fire Flicker", effectFireFlicker, 5, EFFECT_PARAMS(fireFlickerParams), EFFECT_STATE(FireFlickerState, 0), nullptr, nullptr},
+    {"Lava", effectLava, 5, EFFECT_PARAMS(lavaParams), EFFECT_STATE(LavaState, NOISE_FIELD_LED_STATE), effectLavaTile, effectLavaAdvance},
+    {"Aurora", effectAurora, 5, EFFECT_PARAMS(auroraParams), EFFECT_STATE(AuroraState, NOISE_FIELD_LED_STATE), effectAuroraTile, effectAuroraAdvance},
+    {"Pacifica", effectPacifica, 5, EFFECT_PARAMS(pacificaParams), EFFECT_STATE(PacificaState, 0), effectPacificaTile, effectPacificaAdvance},
+    {"Lake", effectLake, 5, EFFECT_PARAMS(lakeParams), EFFECT_STATE(LakeState, 0), effectLakeTile, effectLakeAdvance},
+    
+    // Category 6: Christmas/Seasonal
+    {"Fairy Lights", effectFairy, 6, EFFECT_PARAMS(fairyParams), EFFECT_STATE(FairyState, 3), nullptr, nullptr},
+    {"Christmas Chase", effectChristmasChase, 6, EFFECT_PARAMS(christmasChaseParams), EFFECT_STATE(ChristmasChaseState, ACTIVE_LED_STATE), nullptr, nullptr},
+    {"Halloween Eyes", effectHalloweenEyes, 6, EFFECT_PARAMS(halloweenEyesParams), EFFECT_STATE(HalloweenEyesState, 0), nullptr, nullptr},
+    {"Fireworks", effectFireworks, 6, EFFECT_PARAMS(fireworksParams), EFFECT_STATE(FireworksState, PARTICLE_LED_STATE), nullptr, nullptr},
+    {"Snow Sparkle", effectSnowSparkle, 6, EFFECT_PARAMS(snowSparkleParams), EFFECT_STATE(SnowSparkleState, ACTIVE_LED_STATE), nullptr, nullptr},
+    
+    // Category 7: Special
+    {"Bouncing Balls", effectBouncingBalls, 7, EFFECT_PARAMS(bouncingBallsParams), EFFECT_STATE(BouncingBallsState, PARTICLE_LED_STATE), nullptr, nullptr},
+    {"Popcorn", effectPopcorn, 7, EFFECT_PARAMS(popcornParams), EFFECT_STATE(PopcornState, PARTICLE_LED_STATE), nullptr, nullptr},
+    {"Drip", effectDrip, 7, EFFECT_PARAMS(dripParams), EFFECT_STATE(DripState, PARTICLE_LED_STATE), nullptr, nullptr},
+    {"Plasma", effectPlasma, 7, EFFECT_PARAMS(plasmaParams), EFFECT_STATE(PlasmaState, 0), effectPlasmaTile, effectPlasmaAdvance},
+    {"Lightning", effectLightning, 7, EFFECT_PARAMS(lightningParams), EFFECT_STATE(LightningState, 0), nullptr, nullptr},
+    {"Matrix", effectMatrix, 7, EFFECT_PARAMS(matrixParams), EFFECT_STATE(MatrixState, PARTICLE_LED_STATE), nullptr, nullptr},
+    {"Heartbeat", effectHeartbeat, 7, EFFECT_PARAMS(heartbeatParams), EFFECT_STATE(HeartbeatState, 0), nullptr, nullptr},
+    
+    // Category 8: Breathing/Fade
+    {"Breathe", effectBreathe, 8, EFFECT_PARAMS(breatheParams), EFFECT_STATE(BreatheState, 0), nullptr, nullptr},
+    {"Dissolve", effectDissolve, 8, EFFECT_PARAMS(dissolveParams), EFFECT_STATE(DissolveState, 1), nullptr, nullptr},
+    {"Fade", effectFade, 8, EFFECT_PARAMS(fadeParams), EFFECT_STATE(FadeState, 0), nullptr, nullptr},
+    
+    // Category 9: Alarm
+    {"Police Lights", effectPolice, 9, EFFECT_PARAMS(policeLightsParams), EFFECT_STATE(PoliceState, 0), nullptr, nullptr},
+    {"Strobe", effectStrobe, 9, EFFECT_PARAMS(strobeParams), EFFECT_STATE(StrobeState, 0), nullptr, nullptr}
+};
+
+const uint8_t NUM_EFFECT_ENTRIES = ARRAY_SIZE(effectTable);
+
+// Largest parameter struct - sizes the per-segment params storage
+constexpr uint8_t maxEffectParamsSize() {
+    uint8_t size = 0;
+    for (const EffectEntry& e : effectTable) {
+        if (e.paramsSize > size) size = e.paramsSize;
+    }
+    return size;
+}
+
+// Largest state struct and per-LED state - size every EffectInstance
+constexpr uint16_t maxEffectStateSize() {
+    uint16_t size = 0;
+    for (const EffectEntry& e : effectTable) {
+        if (e.stateSize > size) size = e.stateSize;
+    }
+    return size;
+}
+
+constexpr uint8_t maxEffectLedStateSize() {
+    uint8_t size = 0;
+    for (const EffectEntry& e : effectTable) {
+        if (e.ledStateSize > size) size = e.ledStateSize;
+    }
+    return size;
+}
+
+// Category 1 effects draw only from their params - output changes only when
+// params do, so a segment running one can skip re-rendering
+inline bool isStaticEffect(uint8_t id) {
+    return id < NUM_EFFECT_ENTRIES && effectTable[id].category == 1;
+}
+
+#endif // EFFECT_TABLE_H
@@ -6,11 +6,42 @@
 #define EFFECTS_H
 
 #include <FastLED.h>
+#include "Config.h"
 #include "EffectParams.h"
 #include "Palettes.h"
+#include "EffectDefs.h"     // leds[], NUM_LEDS (runtime strip length)
+#include "HDRFrame.h"       // 16-bit solid frames
+#include "LEDGeometry.h"    // Direction position tables
+#include "NoiseField.h"     // Cached noise for Lava/Aurora
+#include "Oscillators.h"    // Wave bank for the wave effects
+#include "Particles.h"      // Pool and subpixel drawing for moving dots
+#include "ActiveSet.h"      // Lit-pixel sets for twinkle effects
 
-// Configuration constants
-#define NUM_LEDS 75
+// ============================================================================
+// Effect Contract
+// ============================================================================
+// An effect call renders exactly one frame and returns. The LED task owns
+// frame timing and the output, so effects:
+//   - never sleep or wait (delay(), vTaskDelay(), FastLED.delay(), locks)
+//   - never touch the output (FastLED.show(), FastLED.clear(), brightness)
+//   - draw only into leds[0..NUM_LEDS) - it may be a segment buffer
+//   - keep animation state in their state struct / per-LED state
+//     (effectState(), effectLedState()), never in statics
+//   - get their pacing from effectTime (EffectDefs.h); an effect with nothing
+//     new to draw simply returns and leaves leds[] as it is
+//   - stay well inside one frame period (LED_EFFECT_SLICE_PCT of it)
+//   - may pass a finer version of a solid frame to HDRFrame::setSolid(),
+//     after filling leds[] as usual
+//
+// With LED_EFFECT_CHECKS the calls above are intercepted for everything
+// below and LEDStats logs offenders and effects that overrun their slice.
+// ============================================================================
+
+#if LED_EFFECT_CHECKS
+#define delay(ms)       effectBlockingCall("delay()")
+#define vTaskDelay(t)   effectBlockingCall("vTaskDelay()")
+#define FastLED         effectFastLEDGuard
+#endif
 
 // Forward declarations
 void effectSolid();
@@ -56,6 +87,23 @@ void effectFade();
 void effectPolice();
 void effectStrobe();
 
+// Tile-capable effects: tile renders [start, end), advance steps the
+// animation once per frame (see TileRenderer.h)
+void effectRainbowWaveTile(uint16_t start, uint16_t end);
+void effectRainbowWaveAdvance();
+void effectColorWaveTile(uint16_t start, uint16_t end);
+void effectColorWaveAdvance();
+void effectLavaTile(uint16_t start, uint16_t end);
+void effectLavaAdvance();
+void effectAuroraTile(uint16_t start, uint16_t end);
+void effectAuroraAdvance();
+void effectPacificaTile(uint16_t start, uint16_t end);
+void effectPacificaAdvance();
+void effectLakeTile(uint16_t start, uint16_t end);
+void effectLakeAdvance();
+void effectPlasmaTile(uint16_t start, uint16_t end);
+void effectPlasmaAdvance();
+
 // Helper functions
 uint16_t mapLed(uint16_t pos, Direction dir);
 void setLedSafe(uint16_t pos, CRGB color);
@@ -72,19 +120,19 @@ void effectSolid() {
     // Simplest effect - solid color
     CRGB col = solidParams.color;
     col.nscale8(solidParams.brightness);
-    fill_solid(leds, NUM_LEDS, col);
+    LEDKernels::fill(leds, NUM_LEDS, col);
 }
 
 void effectGradient() {
     // Apply style-specific gradient
     if (gradientParams.style == GRADIENT_MIRROR) {
         // MIRROR: symmetric gradient
-        uint8_t half = NUM_LEDS / 2;
+        uint16_t half = NUM_LEDS / 2;
         
         if (gradientParams.threePoint) {
             // 3-point mirror: create full gradient on first half, then mirror
             // First quarter: colorStart -> colorMiddle
-            uint8_t quarter = half / 2;
+            uint16_t quarter = half / 2;
             if (quarter > 0) {
                 fill_gradient_RGB(leds, 0, gradientParams.colorStart, 
                                  quarter, gradientParams.colorMiddle);
@@ -109,7 +157,7 @@ void effectGradient() {
         // SCATTERED: random-looking gradient with color clusters
         if (gradientParams.threePoint) {
             // Divide strip into random segments with different colors
-            uint8_t third = NUM_LEDS / 3;
+            uint16_t third = NUM_LEDS / 3;
             
             // Create 3 sections with smooth transitions
             fill_gradient_RGB(leds, 0, gradientParams.colorStart,
@@ -120,7 +168,7 @@ void effectGradient() {
                              NUM_LEDS - 1, gradientParams.colorEnd);
         } else {
             // 2-point: alternate gradient with middle mix
-            uint8_t third = NUM_LEDS / 3;
+            uint16_t third = NUM_LEDS / 3;
             CRGB mixColor = blend(gradientParams.colorStart, gradientParams.colorEnd, 128);
             
             fill_gradient_RGB(leds, 0, gradientParams.colorEnd, third, mixColor);
@@ -131,7 +179,7 @@ void effectGradient() {
     else {
         // LINEAR (default): normal gradient
         if (gradientParams.threePoint) {
-            uint8_t midPoint = NUM_LEDS / 2;
+            uint16_t midPoint = NUM_LEDS / 2;
             // colorStart -> colorMiddle -> colorEnd
             if (midPoint > 0) {
                 fill_gradient_RGB(leds, 0, gradientParams.colorStart, 
@@ -149,7 +197,7 @@ void effectGradient() {
 }
 
 void effectSpots() {
-    FastLED.clear();
+    clearLeds();
     
     for (uint16_t i = 0; i < NUM_LEDS; i += spotsParams.spread) {
         for (uint8_t w = 0; w < spotsParams.width && (i + w) < NUM_LEDS; w++) {
@@ -195,30 +243,52 @@ void effectPattern() {
 // CATEGORY 2: WAVE EFFECTS
 // ============================================================================
 
-void effectRainbowWave() {
-    static uint16_t hueOffset = 0;
+struct RainbowWaveState {
+    uint32_t hue8 = 0;     // Q8.8
+};
+
+void effectRainbowWaveTile(uint16_t start, uint16_t end) {
+    uint16_t hueOffset = effectState<RainbowWaveState>().hue8 >> 8;
+    const uint16_t* positions = ledPositions(rainbowWaveParams.direction);
     
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        uint16_t pos = mapLed(i, rainbowWaveParams.direction);
+    for (uint16_t i = start; i < end; i++) {
+        uint16_t pos = positions[i];
         uint8_t hue = (pos * 256 / rainbowWaveParams.size + hueOffset) & 0xFF;
         leds[i] = CHSV(hue, rainbowWaveParams.saturation, 255);
     }
-    
-    hueOffset += map(rainbowWaveParams.speed, 0, 255, 1, 10);
 }
 
-void effectColorWave() {
-    static float offset = 0;
-    
+void effectRainbowWaveAdvance() {
+    effectState<RainbowWaveState>().hue8 += effectStep8(map(rainbowWaveParams.speed, 0, 255, 1, 10));
+}
+
+void effectRainbowWave() {
+    effectRainbowWaveTile(0, NUM_LEDS);
+    effectRainbowWaveAdvance();
+}
+
+struct ColorWaveState {
+    uint32_t offset = 0;   // Q16.16 LEDs
+};
+
+// Length of one color band (0 if there are no colors)
+inline uint16_t colorWaveSegmentLen() {
+    if (colorWaveParams.numColors == 0) return 0;
+    uint16_t segmentLen = NUM_LEDS / colorWaveParams.numColors;
+    return segmentLen ? segmentLen : 1;  // Safety check
+}
+
+void effectColorWaveTile(uint16_t start, uint16_t end) {
     // Prevent division by zero
-    if (colorWaveParams.numColors == 0) return;
+    uint16_t segmentLen = colorWaveSegmentLen();
+    if (segmentLen == 0) return;
     
-    uint16_t segmentLen = NUM_LEDS / colorWaveParams.numColors;
-    if (segmentLen == 0) segmentLen = 1; // Safety check
+    uint16_t offset = q16Int(effectState<ColorWaveState>().offset);
+    const uint16_t* positions = ledPositions(colorWaveParams.direction);
     
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        uint16_t pos = mapLed(i, colorWaveParams.direction);
-        uint16_t adjustedPos = ((uint16_t)(pos + offset)) % NUM_LEDS;
+    for (uint16_t i = start; i < end; i++) {
+        uint16_t pos = positions[i];
+        uint16_t adjustedPos = (uint16_t)(pos + offset) % NUM_LEDS;
         
         uint8_t colorIdx = adjustedPos / segmentLen;
         uint8_t nextColorIdx = (colorIdx + 1) % colorWaveParams.numColors;
@@ -237,34 +307,49 @@ void effectColorWave() {
                            blendAmount);
         }
     }
+}
+
+void effectColorWaveAdvance() {
+    uint16_t segmentLen = colorWaveSegmentLen();
+    if (segmentLen == 0) return;
     
     // Normalize speed: higher numColors = smaller segments, so scale offset increment
-    // This keeps visual wave speed constant regardless of number of colors
-    float speedFactor = map(colorWaveParams.speed, 0, 255, 10, 100) / 100.0;
-    float normalizedIncrement = speedFactor * (float)segmentLen / 10.0;
-    
-    offset += normalizedIncrement;
-    if (offset >= NUM_LEDS) offset -= NUM_LEDS;
+    // This keeps visual wave speed constant regardless of number of colors.
+    // Per reference frame: speed 0.1-1.0 x segmentLen / 10 LEDs
+    uint32_t speedPct = map(colorWaveParams.speed, 0, 255, 10, 100);
+    uint32_t increment = ((uint64_t)speedPct * segmentLen << 16) / 1000;   // Q16.16
+    
+    uint32_t& offset = effectState<ColorWaveState>().offset;
+    offset += ((uint64_t)increment * effectTime.dt8) >> 8;
+    offset %= (uint32_t)NUM_LEDS << 16;
 }
 
+void effectColorWave() {
+    effectColorWaveTile(0, NUM_LEDS);
+    effectColorWaveAdvance();
+}
+
+struct OscillateState {
+    int16_t position = 0;
+    int8_t direction = 1;
+    uint32_t lastMove = 0;
+};
+
 void effectOscillate() {
-    static int16_t position = 0;
-    static int8_t direction = 1;
-    static uint32_t lastMove = 0;
+    auto& [position, direction, lastMove] = effectState<OscillateState>();
     
     uint16_t delayMs = map(oscillateParams.speed, 0, 255, 80, 5);
     
-    if (millis() - lastMove > delayMs) {
+    for (uint8_t s = effectSteps(lastMove, delayMs); s > 0; s--) {
         position += direction;
         if (position >= NUM_LEDS - 1 || position <= 0) {
             direction = -direction;
         }
-        lastMove = millis();
     }
     
     // Fade trail effect - softer fade for brightness
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        leds[i].nscale8(220); // 86% brightness retention, gentler fade
+    for (uint8_t f = 0; f < effectTime.frames; f++) {
+        LEDKernels::scale(leds, NUM_LEDS, 220); // 86% brightness retention, gentler fade
     }
     
     // Color based on position: left side = colorPrimary, right side = colorSecondary
@@ -295,42 +380,52 @@ void effectOscillate() {
     }
 }
 
+struct WavyState {
+    uint32_t phase8 = 0;
+};
+
 void effectWavy() {
-    static uint16_t phase = 0;
-    CRGBPalette16 pal = getPalette(wavyParams.palette);
-    
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        // Sinusoid with multiple waves
-        uint8_t sinVal = sin8(i * wavyParams.frequency * 256 / NUM_LEDS + phase);
-        uint8_t brightness = scale8(sinVal, wavyParams.amplitude);
-        
+    uint32_t& phase8 = effectState<WavyState>().phase8;
+    uint16_t phase = phase8 >> 8;
+    const CRGB* pal = PaletteCache::get(wavyParams.palette);
+    uint8_t lift = 255 - wavyParams.amplitude;
+    
+    // frequency waves over the strip, scaled by amplitude
+    const Oscillator wave = {
+        (uint16_t)((uint32_t)wavyParams.frequency * 65536 / NUM_LEDS),
+        OscillatorBank::whole(phase), wavyParams.amplitude, SHAPE_SINE
+    };
+    OscillatorBank::render(&wave, 1, 0, NUM_LEDS, [&](uint16_t i, uint8_t brightness) {
         uint8_t colorIndex = i * 256 / NUM_LEDS + phase / 2;
-        leds[i] = ColorFromPalette(pal, colorIndex, brightness + (255 - wavyParams.amplitude), LINEARBLEND);
-    }
+        leds[i] = paletteColor(pal, colorIndex, brightness + lift);
+    });
     
-    phase += map(wavyParams.speed, 0, 255, 1, 8);
+    phase8 += effectStep8(map(wavyParams.speed, 0, 255, 1, 8));
 }
 
 // ============================================================================
 // CATEGORY 3: CHASE/RUNNING EFFECTS
 // ============================================================================
 
+struct TheaterChaseState {
+    uint8_t step = 0;
+    uint32_t lastStep = 0;
+    uint8_t hue = 0;
+};
+
 void effectTheaterChase() {
-    static uint8_t step = 0;
-    static uint32_t lastStep = 0;
-    static uint8_t hue = 0;
+    auto& [step, lastStep, hue] = effectState<TheaterChaseState>();
     
     uint16_t delayMs = map(theaterChaseParams.speed, 0, 255, 150, 20);
     
-    if (millis() - lastStep > delayMs) {
+    for (uint8_t s = effectSteps(lastStep, delayMs); s > 0; s--) {
         step = (step + 1) % (theaterChaseParams.gapSize + 1);
         if (theaterChaseParams.rainbowMode) {
             hue += 2;
         }
-        lastStep = millis();
     }
     
-    FastLED.clear();
+    clearLeds();
     
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         if ((i + step) % (theaterChaseParams.gapSize + 1) == 0) {
@@ -343,170 +438,156 @@ void effectTheaterChase() {
     }
 }
 
+struct ScannerState {
+    ParticleSet dots;
+    uint32_t lastMove = 0;
+};
+
 void effectScanner() {
-    static int16_t positions[8] = {0};
-    static int8_t directions[8] = {1, 1, 1, 1, 1, 1, 1, 1};
-    static uint32_t lastMove = 0;
-    static bool initialized = false;
+    auto& [dots, lastMove] = effectState<ScannerState>();
+    ParticlePool pool = ParticlePool::bind(dots);
     
-    if (!initialized) {
-        // Distribute dots evenly
-        for (uint8_t i = 0; i < scannerParams.numDots; i++) {
-            positions[i] = i * (NUM_LEDS / scannerParams.numDots);
+    // Distribute dots evenly (again when their number changes)
+    uint8_t numDots = min<uint16_t>(min<uint8_t>(scannerParams.numDots, 8), pool.capacity);
+    if (pool.count() != numDots) {
+        pool.clear();
+        for (uint8_t d = 0; d < numDots; d++) {
+            pool.spawn((q16_16)(d * (NUM_LEDS / numDots)) << 16, Q16_ONE, scannerParams.colors[d]);
         }
-        initialized = true;
     }
     
     uint16_t delayMs = map(scannerParams.speed, 0, 255, 80, 10);
+    q16_16 bottom = (q16_16)(NUM_LEDS - 1) << 16;
     
     // Fade
     if (!scannerParams.overlay) {
         uint8_t fadeAmount = map(scannerParams.trailLength, 1, 50, 100, 20);
-        fadeAll(fadeAmount);
-    }
-    
-    if (millis() - lastMove > delayMs) {
-        for (uint8_t d = 0; d < scannerParams.numDots; d++) {
-            positions[d] += directions[d];
-            
-            if (positions[d] >= NUM_LEDS - 1) {
-                positions[d] = NUM_LEDS - 1;
-                directions[d] = -1;
-            } else if (positions[d] <= 0) {
-                positions[d] = 0;
-                directions[d] = 1;
-            }
+        for (uint8_t f = 0; f < effectTime.frames; f++) {
+            fadeAll(fadeAmount);
         }
-        lastMove = millis();
     }
     
-    // Draw dots - each dot has its own color
-    for (uint8_t d = 0; d < scannerParams.numDots; d++) {
-        if (positions[d] >= 0 && positions[d] < NUM_LEDS) {
-            leds[positions[d]] = scannerParams.colors[d % 8]; // Modulo 8 for safety
-        }
+    // One LED per step, turning at the ends
+    for (uint8_t s = effectSteps(lastMove, delayMs); s > 0; s--) {
+        pool.integrate(0);
+        pool.update([&](uint16_t d) {
+            if (pool.pos[d] >= bottom) {
+                pool.pos[d] = bottom;
+                pool.vel[d] = -Q16_ONE;
+            } else if (pool.pos[d] <= 0) {
+                pool.pos[d] = 0;
+                pool.vel[d] = Q16_ONE;
+            }
+            return true;
+        });
     }
     
-    // Dual mode - second set from the other side
-    if (scannerParams.dualMode) {
-        for (uint8_t d = 0; d < scannerParams.numDots; d++) {
-            int16_t mirrorPos = NUM_LEDS - 1 - positions[d];
-            if (mirrorPos >= 0 && mirrorPos < NUM_LEDS) {
-                leds[mirrorPos] = scannerParams.colors[d % 8]; // Same color for mirrored dot
-            }
+    // Draw dots between steps - each dot has its own color; dual mode adds
+    // a mirrored set from the other side
+    uint8_t fraction = effectStepFraction(lastMove, delayMs);
+    for (uint8_t d = 0; d < pool.count(); d++) {
+        q16_16 pos = constrain(pool.at(d, fraction), 0, bottom);
+        splat(pos, scannerParams.colors[d]);
+        if (scannerParams.dualMode) {
+            splat(bottom - pos, scannerParams.colors[d]);
         }
     }
 }
 
+// The comet runs along ledOrder(direction): position and sparkles are
+// steps along it, drawn on leds[order[step]]
+struct CometState {
+    q16_16 position = 0;       // Head (steps)
+    uint32_t lastMove = 0;
+    ParticleSet sparkles;      // life = sparkle brightness
+};
+
 void effectComet() {
-    static int16_t position = 0;
-    static uint32_t lastMove = 0;
-    static uint8_t sparkles[100]; // Sparkle brightness for each position
+    auto& [position, lastMove, sparkles] = effectState<CometState>();
+    ParticlePool pool = ParticlePool::bind(sparkles);
     
     uint16_t delayMs = map(cometParams.speed, 0, 255, 60, 5);
+    const uint16_t* order = ledOrder(cometParams.direction);
+    q16_16 trail = (q16_16)cometParams.trailLength << 16;
+    q16_16 end = (q16_16)NUM_LEDS << 16;
     
     // Fade existing sparkles FAST
-    for (uint16_t i = 0; i < NUM_LEDS && i < 100; i++) {
-        if (sparkles[i] > 50) sparkles[i] -= 50; // Very fast fade
-        else sparkles[i] = 0;
-    }
+    uint8_t sparkleFade = effectFrameAmount(50);
+    pool.update([&](uint16_t i) {
+        pool.life[i] = qsub8(pool.life[i], sparkleFade);  // Very fast fade
+        return pool.life[i] > 0;
+    });
     
-    if (millis() - lastMove > delayMs) {
-        if (cometParams.direction == DIR_FORWARD) {
-            position++;
-            if (position >= NUM_LEDS + cometParams.trailLength) {
-                position = -cometParams.trailLength;
-            }
-        } else {
-            position--;
-            if (position < -cometParams.trailLength) {
-                position = NUM_LEDS + cometParams.trailLength;
-            }
+    for (uint8_t s = effectSteps(lastMove, delayMs); s > 0; s--) {
+        position += Q16_ONE;
+        if (position >= end + trail) {
+            position = -trail;
         }
-        lastMove = millis();
     }
     
-    FastLED.clear();
+    clearLeds();
     
-    // Draw comet with trail
+    // Draw comet with trail, the head part way to its next LED
+    q16_16 head = position + ((q16_16)effectStepFraction(lastMove, delayMs) << 8);
+    uint64_t cube = (uint64_t)cometParams.trailLength * cometParams.trailLength * cometParams.trailLength;
     for (int16_t i = 0; i < cometParams.trailLength; i++) {
-        int16_t ledPos;
-        if (cometParams.direction == DIR_FORWARD) {
-            ledPos = position - i;
-        } else {
-            ledPos = position + i;
-        }
+        q16_16 pos = head - ((q16_16)i << 16);
         
-        if (ledPos >= 0 && ledPos < NUM_LEDS) {
-            float ratio = (float)i / cometParams.trailLength;
-            uint8_t brightness = 255 * (1.0 - ratio * ratio * ratio);
-            
-            CRGB col = cometParams.color;
-            col.nscale8(brightness);
-            leds[ledPos] = col;
-            
-            // Occasionally create sparkle in the trail
-            if (i > 4 && cometParams.sparkleEnabled && ledPos < 100) {
-                if (random8() < 12) { // Low chance
-                    sparkles[ledPos] = 255;
-                }
+        // 255 * (1 - (i / trailLength)^3), rounded down
+        uint8_t brightness = 255 - (255ull * i * i * i + cube - 1) / cube;
+        CRGB col = cometParams.color;
+        col.nscale8(brightness);
+        splatAdd(pos, col, order);
+        
+        // Occasionally create sparkle in the trail
+        int32_t step = q16Int(pos);
+        if (i > 4 && cometParams.sparkleEnabled && step >= 0 && step < NUM_LEDS) {
+            if (random8() < 12) { // Low chance
+                pool.spawn(step << 16, 0, cometParams.sparkleColor, 255);
             }
         }
     }
     
     // Draw sparkles - REPLACE pixel instead of adding
     if (cometParams.sparkleEnabled) {
-        for (uint16_t i = 0; i < NUM_LEDS && i < 100; i++) {
-            if (sparkles[i] > 30) {
-                // Replace with sparkle color (not add)
-                leds[i] = cometParams.sparkleColor;
-                leds[i].nscale8(sparkles[i]);
+        for (uint16_t i = 0; i < pool.count(); i++) {
+            if (pool.life[i] > 30) {
+                CRGB& led = leds[order[q16Int(pool.pos[i])]];
+                led = cometParams.sparkleColor;
+                led.nscale8(pool.life[i]);
             }
         }
     }
 }
 
+struct RunningLightsState {
+    uint16_t offset = 0;
+    uint32_t lastStep = 0;
+};
+
 void effectRunningLights() {
-    static uint16_t offset = 0;
-    static uint32_t lastStep = 0;
+    auto& [offset, lastStep] = effectState<RunningLightsState>();
     
     uint16_t delayMs = map(runningLightsParams.speed, 0, 255, 80, 10);
     
-    if (millis() - lastStep > delayMs) {
-        offset++;
-        lastStep = millis();
-    }
+    offset += effectSteps(lastStep, delayMs);
     
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        uint8_t wave;
-        uint16_t phase = (i * 256 / runningLightsParams.waveWidth) + offset * 8;
-        
-        switch (runningLightsParams.shape) {
-            case SHAPE_SINE:
-                wave = sin8(phase);
-                break;
-            case SHAPE_SAW:
-                wave = phase & 0xFF;
-                break;
-            case SHAPE_SQUARE:
-                wave = (sin8(phase) > 127) ? 255 : 0;
-                break;
-            case SHAPE_TRIANGLE:
-                wave = triwave8(phase);
-                break;
-            default:
-                wave = sin8(phase);
-        }
-        
-        // Color cycles: divide strip into numColors sections that shift with animation
-        uint8_t numC = runningLightsParams.numColors;
-        if (numC < 1) numC = 1;
-        if (numC > 4) numC = 4;
+    // Color cycles: divide strip into numColors sections that shift with animation
+    uint8_t numC = runningLightsParams.numColors;
+    if (numC < 1) numC = 1;
+    if (numC > 4) numC = 4;
+    
+    // One wave period every waveWidth LEDs
+    const Oscillator wave = {
+        (uint16_t)(65536 / max<uint8_t>(1, runningLightsParams.waveWidth)),
+        OscillatorBank::whole(offset * 8), 255, runningLightsParams.shape
+    };
+    OscillatorBank::render(&wave, 1, 0, NUM_LEDS, [&](uint16_t i, uint8_t level) {
         uint8_t colorIndex = ((i + offset) * numC / NUM_LEDS) % numC;
         CRGB col = runningLightsParams.colors[colorIndex];
-        col.nscale8(wave);
+        col.nscale8(level);
         leds[i] = col;
-    }
+    });
     
     // Dual mode - reverse wave overlaid
     if (runningLightsParams.dualMode) {
@@ -525,27 +606,30 @@ void effectRunningLights() {
     }
 }
 
+struct AndroidState {
+    int16_t position = 0;
+    int8_t direction = 1;
+    uint32_t lastMove = 0;
+};
+
 void effectAndroid() {
-    static int16_t position = 0;
-    static int8_t direction = 1;
-    static uint32_t lastMove = 0;
+    auto& [position, direction, lastMove] = effectState<AndroidState>();
     
     uint16_t sectionLen = NUM_LEDS * androidParams.sectionWidth / 100;
     if (sectionLen < 3) sectionLen = 3;
     
     uint16_t delayMs = map(androidParams.speed, 0, 255, 50, 5);
     
-    if (millis() - lastMove > delayMs) {
+    for (uint8_t s = effectSteps(lastMove, delayMs); s > 0; s--) {
         position += direction;
         if (position + sectionLen >= NUM_LEDS) {
             direction = -1;
         } else if (position <= 0) {
             direction = 1;
         }
-        lastMove = millis();
     }
     
-    fill_solid(leds, NUM_LEDS, androidParams.colorSecondary);
+    LEDKernels::fill(leds, NUM_LEDS, androidParams.colorSecondary);
     
     for (uint16_t i = 0; i < sectionLen; i++) {
         if (position + i >= 0 && position + i < NUM_LEDS) {
@@ -558,42 +642,36 @@ void effectAndroid() {
 // CATEGORY 4: TWINKLE/SPARKLE EFFECTS
 // ============================================================================
 
-// State for twinkle effects
-static uint8_t twinkleState[NUM_LEDS];
-static uint8_t twinkleBrightness[NUM_LEDS];
-static CRGB twinkleColors[NUM_LEDS];
+// Per LED: lit pixels (ActiveSet.h); phase 1 = brightening, 2 = dimming
+struct TwinkleState {
+    ActiveSet twinkles;
+    uint32_t lastUpdate = 0;
+};
 
 void effectTwinkle() {
-    static uint32_t lastUpdate = 0;
-    static bool initialized = false;
+    auto& [twinkles, lastUpdate] = effectState<TwinkleState>();
+    ActivePool pool = ActivePool::bind(twinkles);
     
-    CRGBPalette16 pal = getPalette(twinkleParams.palette);
-    
-    if (!initialized) {
-        memset(twinkleState, 0, NUM_LEDS);
-        memset(twinkleBrightness, 0, NUM_LEDS);
-        initialized = true;
-    }
+    const CRGB* pal = PaletteCache::get(twinkleParams.palette);
     
     uint16_t delayMs = map(twinkleParams.speed, 0, 255, 50, 5);
     
-    if (millis() - lastUpdate > delayMs) {
+    for (uint8_t s = effectSteps(lastUpdate, delayMs); s > 0; s--) {
         // Randomly light up new LEDs
         if (random8() < twinkleParams.intensity) {
-            uint16_t idx = random16(NUM_LEDS);
-            if (twinkleState[idx] == 0) {
-                twinkleState[idx] = 1;  // Brightening
-                twinkleBrightness[idx] = 0;
+            ActivePixel* p = pool.light(random16(NUM_LEDS));
+            if (p != nullptr) {
+                p->phase = 1;  // Brightening
                 
                 switch (twinkleParams.colorMode) {
                     case TWINKLE_SINGLE:
-                        twinkleColors[idx] = twinkleParams.twinkleColor;
+                        p->color = twinkleParams.twinkleColor;
                         break;
                     case TWINKLE_PALETTE:
-                        twinkleColors[idx] = ColorFromPalette(pal, random8(), 255, LINEARBLEND);
+                        p->color = paletteColor(pal, random8(), 255);
                         break;
                     case TWINKLE_RANDOM:
-                        twinkleColors[idx] = CHSV(random8(), 255, 255);
+                        p->color = CHSV(random8(), 255, 255);
                         break;
                 }
             }
@@ -602,87 +680,94 @@ void effectTwinkle() {
         // Update brightness
         uint8_t fadeStep = map(twinkleParams.fadeSpeed, 0, 255, 5, 30);
         
-        for (uint16_t i = 0; i < NUM_LEDS; i++) {
-            if (twinkleState[i] == 1) {
+        pool.update([&](ActivePixel& p) {
+            if (p.phase == 1) {
                 // Brightening
-                twinkleBrightness[i] = qadd8(twinkleBrightness[i], fadeStep * 2);
-                if (twinkleBrightness[i] >= 250) {
-                    twinkleState[i] = 2;  // Switch to dimming
-                }
-            } else if (twinkleState[i] == 2) {
-                // Dimming
-                twinkleBrightness[i] = qsub8(twinkleBrightness[i], fadeStep);
-                if (twinkleBrightness[i] <= 5) {
-                    twinkleState[i] = 0;
-                    twinkleBrightness[i] = 0;
+                p.level = qadd8(p.level, fadeStep * 2);
+                if (p.level >= 250) {
+                    p.phase = 2;  // Switch to dimming
                 }
+                return true;
             }
-        }
-        
-        lastUpdate = millis();
+            // Dimming
+            p.level = qsub8(p.level, fadeStep);
+            return p.level > 5;
+        });
     }
     
     // Render
-    FastLED.clear();
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        if (twinkleBrightness[i] > 0) {
-            CRGB col = twinkleColors[i];
-            col.nscale8(twinkleBrightness[i]);
-            leds[i] = col;
-        }
+    clearLeds();
+    for (uint16_t i = 0; i < pool.count(); i++) {
+        const ActivePixel& p = pool.pixels[i];
+        CRGB col = p.color;
+        col.nscale8(p.level);
+        leds[p.led] = col;
     }
 }
 
+// Per LED: lit pixels (ActiveSet.h)
+struct TwinkleFoxState {
+    ActiveSet twinkles;
+    uint32_t lastUpdate = 0;
+};
+
 void effectTwinkleFox() {
-    static uint8_t foxBrightness[NUM_LEDS];
-    static CRGB foxColors[NUM_LEDS];
-    static uint32_t lastUpdate = 0;
+    auto& [twinkles, lastUpdate] = effectState<TwinkleFoxState>();
+    ActivePool pool = ActivePool::bind(twinkles);
     
-    CRGBPalette16 pal = getPalette(twinkleFoxParams.palette);
+    const CRGB* pal = PaletteCache::get(twinkleFoxParams.palette);
     
     uint16_t delayMs = map(twinkleFoxParams.speed, 0, 255, 30, 5);
     
-    if (millis() - lastUpdate > delayMs) {
-        // Randomly light up
+    for (uint8_t s = effectSteps(lastUpdate, delayMs); s > 0; s--) {
+        // Randomly light up (or relight)
         if (random8() < twinkleFoxParams.twinkleRate) {
-            uint16_t idx = random16(NUM_LEDS);
-            foxBrightness[idx] = 255;
-            foxColors[idx] = ColorFromPalette(pal, random8(), 255, LINEARBLEND);
+            ActivePixel* p = pool.touch(random16(NUM_LEDS));
+            CRGB color = paletteColor(pal, random8(), 255);
+            if (p != nullptr) {
+                p->level = 255;
+                p->color = color;
+            }
         }
         
         // Slowly fade all
         uint8_t fadeAmount = map(twinkleFoxParams.fadeOut, 0, 255, 1, 15);
-        for (uint16_t i = 0; i < NUM_LEDS; i++) {
-            foxBrightness[i] = qsub8(foxBrightness[i], fadeAmount);
-        }
-        
-        lastUpdate = millis();
+        pool.update([&](ActivePixel& p) {
+            p.level = qsub8(p.level, fadeAmount);
+            return p.level > 0;
+        });
     }
     
     // Render
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        CRGB col = foxColors[i];
-        col.nscale8(foxBrightness[i]);
-        leds[i] = col;
+    clearLeds();
+    for (uint16_t i = 0; i < pool.count(); i++) {
+        const ActivePixel& p = pool.pixels[i];
+        CRGB col = p.color;
+        col.nscale8(p.level);
+        leds[p.led] = col;
     }
 }
 
+struct SparkleState {
+    uint32_t lastSpark = 0;
+};
+
 void effectSparkle() {
-    static uint32_t lastSpark = 0;
+    uint32_t& lastSpark = effectState<SparkleState>().lastSpark;
     
     // Background
     if (!sparkleParams.overlay) {
-        fill_solid(leds, NUM_LEDS, sparkleParams.colorBg);
+        LEDKernels::fill(leds, NUM_LEDS, sparkleParams.colorBg);
     } else {
         // In overlay mode always fade sparkles
-        for (uint16_t i = 0; i < NUM_LEDS; i++) {
-            leds[i] = blend(leds[i], sparkleParams.colorBg, 30);
+        for (uint8_t f = 0; f < effectTime.frames; f++) {
+            LEDKernels::blendToward(leds, NUM_LEDS, sparkleParams.colorBg, 30);
         }
     }
     
     uint16_t delayMs = map(sparkleParams.speed, 0, 255, 80, 10);
     
-    if (millis() - lastSpark > delayMs) {
+    for (uint8_t step = effectSteps(lastSpark, delayMs); step > 0; step--) {
         // Random sparkles
         uint8_t numSparks = map(sparkleParams.intensity, 0, 255, 1, 10);
         for (uint8_t s = 0; s < numSparks; s++) {
@@ -693,31 +778,35 @@ void effectSparkle() {
                 leds[idx] = sparkleParams.colorSpark;
             }
         }
-        lastSpark = millis();
     }
 }
 
+struct GlitterState {
+    uint32_t hue8 = 0;
+};
+
 void effectGlitter() {
-    static uint8_t hue = 0;
+    uint32_t& hue8 = effectState<GlitterState>().hue8;
+    uint8_t hue = hue8 >> 8;
+    hue8 += effectStep8(1);
     
     if (!glitterParams.overlay) {
         // Without overlay: normal background (immediate)
         if (glitterParams.rainbowBg) {
-            fill_rainbow(leds, NUM_LEDS, hue++, 7);
+            fill_rainbow(leds, NUM_LEDS, hue, 7);
         } else {
-            fill_solid(leds, NUM_LEDS, glitterParams.bgColor);
+            LEDKernels::fill(leds, NUM_LEDS, glitterParams.bgColor);
         }
     } else {
         // With overlay: smooth transition to background (glitter fades slower)
-        if (glitterParams.rainbowBg) {
-            for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                CRGB rainbowColor = CHSV(hue + (i * 7), 255, 255);
-                leds[i] = blend(leds[i], rainbowColor, 30);
-            }
-            hue++;
-        } else {
-            for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                leds[i] = blend(leds[i], glitterParams.bgColor, 30);
+        for (uint8_t f = 0; f < effectTime.frames; f++) {
+            if (glitterParams.rainbowBg) {
+                for (uint16_t i = 0; i < NUM_LEDS; i++) {
+                    CRGB rainbowColor = CHSV(hue + (i * 7), 255, 255);
+                    leds[i] = blend(leds[i], rainbowColor, 30);
+                }
+            } else {
+                LEDKernels::blendToward(leds, NUM_LEDS, glitterParams.bgColor, 30);
             }
         }
     }
@@ -731,15 +820,20 @@ void effectGlitter() {
     }
 }
 
+// Per LED: star brightness
+struct StarryNightState {
+    q16_16 shootingPos = -1;   // Head (LEDs), < 0 = none
+    uint32_t lastUpdate = 0;
+    uint32_t lastShoot = 0;
+};
+
 void effectStarryNight() {
-    static uint8_t starBrightness[NUM_LEDS];
-    static int16_t shootingPos = -1;
-    static uint32_t lastUpdate = 0;
-    static uint32_t lastShoot = 0;
+    auto& [shootingPos, lastUpdate, lastShoot] = effectState<StarryNightState>();
+    uint8_t* starBrightness = effectLedState();
     
     uint16_t delayMs = map(starryNightParams.speed, 0, 255, 200, 5);
     
-    if (millis() - lastUpdate > delayMs) {
+    for (uint8_t s = effectSteps(lastUpdate, delayMs); s > 0; s--) {
         // Star twinkling
         for (uint16_t i = 0; i < NUM_LEDS; i++) {
             if (starBrightness[i] > 0) {
@@ -759,26 +853,26 @@ void effectStarryNight() {
                 }
             }
         }
-        lastUpdate = millis();
     }
     
     // Shooting star
     if (starryNightParams.shootingStars) {
-        if (shootingPos < 0 && millis() - lastShoot > 3000 + random16(5000)) {
+        if (shootingPos < 0 && millis() - lastShoot > (uint32_t)(3000 + random16(5000))) {
             shootingPos = 0;
             lastShoot = millis();
         }
         
         if (shootingPos >= 0) {
-            shootingPos += 3;
-            if (shootingPos >= NUM_LEDS) {
+            // 3 LEDs per reference frame, moved by this frame's share
+            shootingPos += (q16_16)(3 * effectTime.dt8) << 8;
+            if (q16Int(shootingPos) >= NUM_LEDS) {
                 shootingPos = -1;
             }
         }
     }
     
     // Render
-    FastLED.clear();
+    clearLeds();
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         if (starBrightness[i] > 0) {
             CRGB col = starryNightParams.colorStars;
@@ -787,14 +881,11 @@ void effectStarryNight() {
         }
     }
     
-    // Draw shooting star
+    // Draw shooting star between LEDs, over the stars
     if (shootingPos >= 0) {
         for (int8_t t = 0; t < 8; t++) {
-            int16_t pos = shootingPos - t;
-            if (pos >= 0 && pos < NUM_LEDS) {
-                uint8_t bright = 255 - t * 30;
-                leds[pos] = CRGB(bright, bright, bright);
-            }
+            uint8_t bright = 255 - t * 30;
+            splatAdd(shootingPos - ((q16_16)t << 16), CRGB(bright, bright, bright));
         }
     }
 }
@@ -803,51 +894,58 @@ void effectStarryNight() {
 // CATEGORY 5: FIRE/ORGANIC EFFECTS
 // ============================================================================
 
-// Buffer for fire effect
-static uint8_t heat[NUM_LEDS];
-
+// Per LED: heat (no other state)
 void effectFire() {
-    CRGBPalette16 pal = getPalette(fireParams.palette);
+    uint8_t* heat = effectLedState();
+    const CRGB* pal = PaletteCache::get(fireParams.palette);
     
-    // Cooling
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        heat[i] = qsub8(heat[i], random8(0, ((fireParams.cooling * 10) / NUM_LEDS) + 2));
-    }
-    
-    // Move heat upwards
-    for (uint16_t k = NUM_LEDS - 1; k >= 2; k--) {
-        heat[k] = (heat[k - 1] + heat[k - 2] + heat[k - 2]) / 3;
-    }
-    
-    // Random sparks at bottom
-    if (random8() < fireParams.sparking) {
-        uint8_t y = random8(7);
-        if (y < NUM_LEDS) {
-            heat[y] = qadd8(heat[y], random8(160, 255));
+    // One simulation step per reference frame
+    for (uint8_t f = 0; f < effectTime.frames; f++) {
+        // Cooling
+        for (uint16_t i = 0; i < NUM_LEDS; i++) {
+            heat[i] = qsub8(heat[i], random8(0, ((fireParams.cooling * 10) / NUM_LEDS) + 2));
         }
-    }
-    
-    // Boost
-    if (fireParams.boost) {
-        for (uint16_t i = 0; i < 3 && i < NUM_LEDS; i++) {
-            heat[i] = qadd8(heat[i], 50);
+        
+        // Move heat upwards
+        for (uint16_t k = NUM_LEDS - 1; k >= 2; k--) {
+            heat[k] = (heat[k - 1] + heat[k - 2] + heat[k - 2]) / 3;
+        }
+        
+        // Random sparks at bottom
+        if (random8() < fireParams.sparking) {
+            uint8_t y = random8(7);
+            if (y < NUM_LEDS) {
+                heat[y] = qadd8(heat[y], random8(160, 255));
+            }
+        }
+        
+        // Boost
+        if (fireParams.boost) {
+            for (uint16_t i = 0; i < 3 && i < NUM_LEDS; i++) {
+                heat[i] = qadd8(heat[i], 50);
+            }
         }
     }
     
     // Map to colors
     for (uint16_t j = 0; j < NUM_LEDS; j++) {
         uint8_t colorIndex = scale8(heat[j], 240);
-        leds[j] = ColorFromPalette(pal, colorIndex, 255, LINEARBLEND);
+        leds[j] = paletteColor(pal, colorIndex, 255);
     }
 }
 
+// Per LED: brightness
+struct CandleState {
+    uint32_t lastFlicker = 0;
+};
+
 void effectCandle() {
-    static uint8_t candleBrightness[NUM_LEDS];
-    static uint32_t lastFlicker = 0;
+    uint32_t& lastFlicker = effectState<CandleState>().lastFlicker;
+    uint8_t* candleBrightness = effectLedState();
     
     uint16_t delayMs = map(candleParams.speed, 0, 255, 80, 5);
     
-    if (millis() - lastFlicker > delayMs) {
+    for (uint8_t s = effectSteps(lastFlicker, delayMs); s > 0; s--) {
         // Intensity controls the RANGE of brightness fluctuations
         // 0 = almost no fluctuations (±5), 255 = dramatic fluctuations (±127)
         uint8_t flickerRange = map(candleParams.intensity, 0, 255, 5, 127);
@@ -868,7 +966,6 @@ void effectCandle() {
                 candleBrightness[i] = newBright;
             }
         }
-        lastFlicker = millis();
     }
     
     // Render
@@ -891,27 +988,44 @@ void effectCandle() {
     }
 }
 
+struct FireFlickerState {
+    uint32_t lastFlicker = 0;
+};
+
 void effectFireFlicker() {
+    uint32_t& lastFlicker = effectState<FireFlickerState>().lastFlicker;
+    
+    // New flicker pattern every 100-20 ms; in between the last one stays up
+    if (effectSteps(lastFlicker, map(fireFlickerParams.speed, 0, 255, 100, 20)) == 0) {
+        return;
+    }
+    
     for (uint16_t i = 0; i < NUM_LEDS; i++) {
         uint8_t flicker = random8(fireFlickerParams.intensity);
         CRGB col = fireFlickerParams.color;
         col.nscale8(255 - flicker);
         leds[i] = col;
     }
-    
-    FastLED.delay(map(fireFlickerParams.speed, 0, 255, 100, 20));
 }
 
-void effectLava() {
-    static uint16_t offset = 0;
+// Per LED: noise field rows (NoiseField.h)
+struct LavaState {
+    uint32_t offset8 = 0;     // Q8.8
+    NoiseField field;
+};
+
+// Two noise layers for blob effect, averaged
+constexpr NoiseLayer lavaLayers[] = { { 0, 0 }, { 1000, 5000 } };
+
+void effectLavaTile(uint16_t start, uint16_t end) {
+    LavaState& state = effectState<LavaState>();
+    uint16_t offset = state.offset8 >> 8;
     
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        // Two noise layers for blob effect
-        uint8_t noise1 = inoise8(i * lavaParams.blobSize, offset);
-        uint8_t noise2 = inoise8(i * lavaParams.blobSize + 1000, offset + 5000);
-        
-        uint8_t combined = (noise1 + noise2) / 2;
-        
+    // Smoothing - higher value = smoother transitions (min 10 to prevent animation freezing)
+    uint8_t blendAmount = map(lavaParams.smoothness, 0, 255, 255, 30);
+    
+    NoiseEngine::forEach(state.field, effectLedState(), start, end, lavaParams.blobSize, offset,
+                         lavaLayers, 2, [blendAmount](uint16_t i, uint8_t combined) {
         // Map to colors
         CRGB col;
         if (combined < 128) {
@@ -920,93 +1034,150 @@ void effectLava() {
             col = blend(CRGB::DarkRed, CRGB::Yellow, (combined - 128) * 2);
         }
         
-        // Smoothing - higher value = smoother transitions (min 10 to prevent animation freezing)
-        uint8_t blendAmount = map(lavaParams.smoothness, 0, 255, 255, 30);
         leds[i] = blend(leds[i], col, blendAmount);
-    }
-    
-    offset += map(lavaParams.speed, 0, 255, 5, 30);
+    });
 }
 
-void effectAurora() {
-    static uint16_t offset = 0;
-    CRGBPalette16 pal = getPalette(auroraParams.palette);
-    
-    // Intensity = wave size (low = thin, high = wide)
-    uint8_t waveScale = map(auroraParams.intensity, 0, 255, 30, 8);
+void effectLavaAdvance() {
+    LavaState& state = effectState<LavaState>();
+    state.offset8 += effectStep8(map(lavaParams.speed, 0, 255, 5, 30));
+    NoiseEngine::update(state.field, effectLedState(), lavaParams.blobSize, state.offset8 >> 8,
+                        lavaLayers, 2);
+}
+
+void effectLava() {
+    effectLavaTile(0, NUM_LEDS);
+    effectLavaAdvance();
+}
+
+// Per LED: noise field rows (NoiseField.h)
+struct AuroraState {
+    uint32_t offset8 = 0;     // Q8.8
+    NoiseField field;
+};
+
+constexpr NoiseLayer auroraLayers[] = { { 0, 0 } };
+
+// Intensity = wave size (low = thin, high = wide)
+inline uint8_t auroraWaveScale() {
+    return map(auroraParams.intensity, 0, 255, 30, 8);
+}
+
+void effectAuroraTile(uint16_t start, uint16_t end) {
+    AuroraState& state = effectState<AuroraState>();
+    uint16_t offset = state.offset8 >> 8;
+    const CRGB* pal = PaletteCache::get(auroraParams.palette);
     
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        uint8_t noise = inoise8(i * waveScale, offset);
+    NoiseEngine::forEach(state.field, effectLedState(), start, end, auroraWaveScale(), offset,
+                         auroraLayers, 1, [pal, offset](uint16_t i, uint8_t noise) {
         uint8_t colorIdx = noise + (offset >> 4);
         uint8_t brightness = map(noise, 0, 255, 100, 255);
         
-        leds[i] = ColorFromPalette(pal, colorIdx, brightness, LINEARBLEND);
-    }
-    
-    offset += map(auroraParams.speed, 0, 255, 3, 30);
+        leds[i] = paletteColor(pal, colorIdx, brightness);
+    });
 }
 
-void effectPacifica() {
+void effectAuroraAdvance() {
+    AuroraState& state = effectState<AuroraState>();
+    state.offset8 += effectStep8(map(auroraParams.speed, 0, 255, 3, 30));
+    NoiseEngine::update(state.field, effectLedState(), auroraWaveScale(), state.offset8 >> 8,
+                        auroraLayers, 1);
+}
+
+void effectAurora() {
+    effectAuroraTile(0, NUM_LEDS);
+    effectAuroraAdvance();
+}
+
+struct PacificaState {
+    uint32_t offset8 = 0;     // Q8.8
+};
+
+void effectPacificaTile(uint16_t start, uint16_t end) {
     // Simple ocean effect - color waves from palette
-    static uint16_t offset = 0;
-    CRGBPalette16 pal = getPalette(pacificaParams.palette);
+    uint16_t offset = effectState<PacificaState>().offset8 >> 8;
+    const CRGB* pal = PaletteCache::get(pacificaParams.palette);
     
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        // Three overlapping waves with different frequencies
-        uint8_t wave1 = sin8(i * 7 + offset);
-        uint8_t wave2 = sin8(i * 11 - offset / 2);
-        uint8_t wave3 = sin8(i * 5 + offset / 3);
-        
-        // Combine waves
-        uint8_t combined = (wave1 + wave2 + wave3) / 3;
-        
+    // Three overlapping waves with different frequencies
+    const Oscillator waves[] = {
+        { OscillatorBank::whole(7),  OscillatorBank::whole(offset),            255, SHAPE_SINE },
+        { OscillatorBank::whole(11), OscillatorBank::whole(-(offset / 2)),     255, SHAPE_SINE },
+        { OscillatorBank::whole(5),  OscillatorBank::whole(offset / 3),        255, SHAPE_SINE },
+    };
+    
+    OscillatorBank::render(waves, 3, start, end, [&](uint16_t i, uint8_t combined) {
         // Use combination as color index from palette
         uint8_t colorIdx = combined + (offset >> 3);
         
-        // Brightness based on wave
-        uint8_t brightness = map(combined, 0, 255, 120, 255);
+        // Brightness based on wave (120..255)
+        uint8_t brightness = 120 + combined * 135 / 255;
         
-        leds[i] = ColorFromPalette(pal, colorIdx, brightness, LINEARBLEND);
-    }
-    
-    offset += map(pacificaParams.speed, 0, 255, 1, 15);
+        leds[i] = paletteColor(pal, colorIdx, brightness);
+    });
+}
+
+void effectPacificaAdvance() {
+    effectState<PacificaState>().offset8 += effectStep8(map(pacificaParams.speed, 0, 255, 1, 15));
+}
+
+void effectPacifica() {
+    effectPacificaTile(0, NUM_LEDS);
+    effectPacificaAdvance();
+}
+
+struct LakeState {
+    uint32_t offset8 = 0;     // Q8.8
+};
+
+void effectLakeTile(uint16_t start, uint16_t end) {
+    uint16_t offset = effectState<LakeState>().offset8 >> 8;
+    const CRGB* pal = PaletteCache::get(lakeParams.palette);
+    
+    // Slow, calm rippling
+    const Oscillator waves[] = {
+        { OscillatorBank::whole(5), OscillatorBank::whole(offset / 3),    255, SHAPE_SINE },
+        { OscillatorBank::whole(7), OscillatorBank::whole(-(offset / 2)), 255, SHAPE_SINE },
+    };
+    uint8_t drift = offset / 10;
+    
+    OscillatorBank::render(waves, 2, start, end, [&](uint16_t i, uint8_t combined) {
+        uint8_t colorIdx = i * 256 / NUM_LEDS + drift;
+        leds[i] = paletteColor(pal, colorIdx, combined);
+    });
+}
+
+void effectLakeAdvance() {
+    effectState<LakeState>().offset8 += effectStep8(map(lakeParams.speed, 0, 255, 2, 15));
 }
 
 void effectLake() {
-    static uint16_t offset = 0;
-    CRGBPalette16 pal = getPalette(lakeParams.palette);
-    
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        // Slow, calm rippling
-        uint8_t wave1 = sin8(i * 5 + offset / 3);
-        uint8_t wave2 = sin8(i * 7 - offset / 2);
-        uint8_t combined = (wave1 + wave2) / 2;
-        
-        uint8_t colorIdx = i * 256 / NUM_LEDS + offset / 10;
-        leds[i] = ColorFromPalette(pal, colorIdx, combined, LINEARBLEND);
-    }
-    
-    offset += map(lakeParams.speed, 0, 255, 2, 15);
+    effectLakeTile(0, NUM_LEDS);
+    effectLakeAdvance();
 }
 
 // ============================================================================
 // CATEGORY 6: HOLIDAY EFFECTS
 // ============================================================================
 
+// Per LED: flasher brightness, hue, state (3 bytes)
+struct FairyState {
+    uint32_t lastUpdate = 0;
+    bool initialized = false;
+};
+
 void effectFairy() {
-    static uint8_t flasherBrightness[NUM_LEDS];
-    static uint8_t flasherHue[NUM_LEDS];
-    static uint8_t flasherState[NUM_LEDS];
-    static uint32_t lastUpdate = 0;
-    static bool initialized = false;
+    auto& [lastUpdate, initialized] = effectState<FairyState>();
+    uint8_t* flasherBrightness = effectLedState();
+    uint8_t* flasherHue = flasherBrightness + NUM_LEDS;
+    uint8_t* flasherState = flasherHue + NUM_LEDS;
     
     // Normalize numFlashers: slider 1-255 -> 1-NUM_LEDS
-    uint8_t numFlashers = map(fairyParams.numFlashers, 1, 255, 1, NUM_LEDS);
+    uint16_t numFlashers = map(fairyParams.numFlashers, 1, 255, 1, NUM_LEDS);
     if (numFlashers < 1) numFlashers = 1;
     if (numFlashers > NUM_LEDS) numFlashers = NUM_LEDS;
     
     if (!initialized) {
-        for (uint8_t i = 0; i < NUM_LEDS; i++) {
+        for (uint16_t i = 0; i < NUM_LEDS; i++) {
             flasherBrightness[i] = random8(50, 200);
             flasherHue[i] = random8();
             flasherState[i] = random8(3);
@@ -1016,8 +1187,8 @@ void effectFairy() {
     
     uint16_t delayMs = map(fairyParams.speed, 0, 255, 60, 8);
     
-    if (millis() - lastUpdate > delayMs) {
-        for (uint8_t i = 0; i < numFlashers; i++) {
+    for (uint8_t s = effectSteps(lastUpdate, delayMs); s > 0; s--) {
+        for (uint16_t i = 0; i < numFlashers; i++) {
             switch (flasherState[i]) {
                 case 0: // Off
                     if (random8() < 25) flasherState[i] = 1;
@@ -1035,16 +1206,15 @@ void effectFairy() {
                     break;
             }
         }
-        lastUpdate = millis();
     }
     
     // Black background
-    FastLED.clear();
+    clearLeds();
     
     // Distribute lights evenly
-    uint16_t spacing = NUM_LEDS / max((uint8_t)1, numFlashers);
+    uint16_t spacing = NUM_LEDS / max((uint16_t)1, numFlashers);
     
-    for (uint8_t i = 0; i < numFlashers; i++) {
+    for (uint16_t i = 0; i < numFlashers; i++) {
         uint16_t pos = (i * spacing + i * 7) % NUM_LEDS;
         
         CRGB col;
@@ -1061,8 +1231,8 @@ void effectFairy() {
                 break;
             case 3: // Palette
             default:
-                CRGBPalette16 pal = getPalette(fairyParams.palette);
-                col = ColorFromPalette(pal, flasherHue[i], 255, LINEARBLEND);
+                const CRGB* pal = PaletteCache::get(fairyParams.palette);
+                col = paletteColor(pal, flasherHue[i], 255);
                 break;
         }
         
@@ -1071,18 +1241,20 @@ void effectFairy() {
     }
 }
 
+// Per LED: lit sparks for XMAS_SPARKLE (ActiveSet.h)
+struct ChristmasChaseState {
+    uint16_t offset = 0;
+    uint32_t lastStep = 0;
+    uint32_t lastSparkle = 0;
+    ActiveSet sparks;
+};
+
 void effectChristmasChase() {
-    static uint16_t offset = 0;
-    static uint32_t lastStep = 0;
-    static uint8_t sparkleBrightness[NUM_LEDS]; // Sparkle brightness for XMAS_SPARKLE
-    static uint32_t lastSparkle = 0;
+    auto& [offset, lastStep, lastSparkle, sparks] = effectState<ChristmasChaseState>();
     
     uint16_t delayMs = map(christmasChaseParams.speed, 0, 255, 100, 15);
     
-    if (millis() - lastStep > delayMs) {
-        offset++;
-        lastStep = millis();
-    }
+    offset += effectSteps(lastStep, delayMs);
     
     switch (christmasChaseParams.pattern) {
         case XMAS_ALTERNATING:
@@ -1096,7 +1268,7 @@ void effectChristmasChase() {
             break;
             
         case XMAS_CHASE:
-            FastLED.clear();
+            clearLeds();
             for (uint16_t i = 0; i < NUM_LEDS; i += 6) {
                 uint16_t pos = (i + offset) % NUM_LEDS;
                 leds[pos] = christmasChaseParams.color1;
@@ -1104,58 +1276,59 @@ void effectChristmasChase() {
             }
             break;
             
-        case XMAS_SPARKLE:
+        case XMAS_SPARKLE: {
+            ActivePool pool = ActivePool::bind(sparks);
+            
             // Alternating background
             for (uint16_t i = 0; i < NUM_LEDS; i++) {
                 leds[i] = (i % 2) ? christmasChaseParams.color1 : christmasChaseParams.color2;
             }
             
             // Fade out existing sparks - fade speed depends on speed
-            uint8_t fadeAmount = map(christmasChaseParams.speed, 0, 255, 5, 30);
-            for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                if (sparkleBrightness[i] > fadeAmount) {
-                    sparkleBrightness[i] -= fadeAmount;
-                } else {
-                    sparkleBrightness[i] = 0;
-                }
-            }
+            uint8_t fadeAmount = effectFrameAmount(map(christmasChaseParams.speed, 0, 255, 5, 30));
+            pool.update([&](ActivePixel& p) {
+                p.level = qsub8(p.level, fadeAmount);
+                return p.level > 0;
+            });
             
             // Add new sparks according to speed
-            if (millis() - lastSparkle > delayMs) {
+            for (uint8_t step = effectSteps(lastSparkle, delayMs); step > 0; step--) {
                 for (uint8_t s = 0; s < 5; s++) {
                     if (random8() < 80) {
-                        sparkleBrightness[random16(NUM_LEDS)] = 255;
+                        ActivePixel* p = pool.touch(random16(NUM_LEDS));
+                        if (p != nullptr) p->level = 255;
                     }
                 }
-                lastSparkle = millis();
             }
             
             // Overlay sparks on background
-            for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                if (sparkleBrightness[i] > 0) {
-                    CRGB sparkle = CRGB::White;
-                    sparkle.nscale8(sparkleBrightness[i]);
-                    leds[i] = blend(leds[i], CRGB::White, sparkleBrightness[i]);
-                }
+            for (uint16_t i = 0; i < pool.count(); i++) {
+                const ActivePixel& p = pool.pixels[i];
+                leds[p.led] = blend(leds[p.led], CRGB::White, p.level);
             }
             break;
+        }
     }
 }
 
+struct HalloweenEyesState {
+    int16_t eyePositions[4] = {-1, -1, -1, -1};  // Eye pairs
+    uint8_t eyeBrightness[4] = {0};
+    uint8_t eyeState[4] = {0};  // 0=inactive, 1=appearing, 2=blinking, 3=fading
+    uint32_t eyeTimers[4] = {0};
+    uint32_t lastUpdate = 0;
+};
+
 void effectHalloweenEyes() {
-    static int16_t eyePositions[4] = {-1, -1, -1, -1};  // Eye pairs
-    static uint8_t eyeBrightness[4] = {0};
-    static uint8_t eyeState[4] = {0};  // 0=inactive, 1=appearing, 2=blinking, 3=fading
-    static uint32_t eyeTimers[4] = {0};
-    static uint32_t lastUpdate = 0;
+    auto& [eyePositions, eyeBrightness, eyeState, eyeTimers, lastUpdate] = effectState<HalloweenEyesState>();
     
-    if (millis() - lastUpdate > 30) {
+    for (uint8_t s = effectSteps(lastUpdate, 30); s > 0; s--) {
         // Manage eye pairs
         for (uint8_t e = 0; e < 2; e++) {
             switch (eyeState[e]) {
                 case 0:  // Inactive - randomly activate
                     if (random8() < 20) {
-                        eyePositions[e] = random8(NUM_LEDS - 5);
+                        eyePositions[e] = random16(NUM_LEDS - 5);
                         eyeState[e] = 1;
                         eyeBrightness[e] = 0;
                     }
@@ -1196,12 +1369,11 @@ void effectHalloweenEyes() {
                     break;
             }
         }
-        lastUpdate = millis();
     }
     
     // Render
     if (!halloweenEyesParams.overlay) {
-        FastLED.clear();
+        clearLeds();
     }
     
     for (uint8_t e = 0; e < 2; e++) {
@@ -1222,149 +1394,128 @@ void effectHalloweenEyes() {
     }
 }
 
-// Structure for firework fragment
-struct FireworkFragment {
-    int16_t position;
-    int8_t velocity;
-    uint8_t brightness;
-    CRGB color;
-    bool active;
+struct FireworksState {
+    ParticleSet fragments;     // life = brightness
+    uint32_t lastUpdate = 0;
 };
 
-static FireworkFragment fragments[32];  // Max fragments
-
 void effectFireworks() {
-    static uint32_t lastLaunch = 0;
-    static uint32_t lastUpdate = 0;
-    
-    // Normalize gravity: 0-255 -> 1-8 (visible effect on falling)
-    uint8_t gravityForce = map(fireworksParams.gravity, 0, 255, 1, 8);
-    
-    if (millis() - lastUpdate > 20) {
-        // Randomly launch new firework
-        if (random8() < fireworksParams.chance / 4) {
-            // Find free fragments
-            int16_t launchPos = random8(NUM_LEDS);
-            CRGB launchColor = CHSV(random8(), 255, 255);
-            
-            // Normalize fragments: 4-16 -> use directly
-            uint8_t targetFragments = constrain(fireworksParams.fragments, 4, 16);
-            
-            uint8_t fragCount = 0;
-            for (uint8_t f = 0; f < 32 && fragCount < targetFragments; f++) {
-                if (!fragments[f].active) {
-                    fragments[f].active = true;
-                    fragments[f].position = launchPos * 10;  // Fixed point
-                    fragments[f].velocity = random8(10, 30) * (random8(2) ? 1 : -1);
-                    fragments[f].brightness = 255;
-                    fragments[f].color = launchColor;
-                    fragCount++;
-                }
-            }
-            lastLaunch = millis();
-        }
-        
-        // Update fragments
-        for (uint8_t f = 0; f < 32; f++) {
-            if (fragments[f].active) {
-                fragments[f].position += fragments[f].velocity;
-                
-                // Gravity - now with visible effect
-                fragments[f].velocity -= gravityForce;
-                
-                // Fading
-                fragments[f].brightness = qsub8(fragments[f].brightness, 8);
+    auto& [fragments, lastUpdate] = effectState<FireworksState>();
+    ParticlePool pool = ParticlePool::bind(fragments);
+    
+    // Normalize gravity: 0-255 -> 0.1-0.8 LEDs per step (visible effect on falling)
+    q16_16 gravity = q16Ratio(map(fireworksParams.gravity, 0, 255, 1, 8), 10);
+    q16_16 end = (q16_16)NUM_LEDS << 16;
+    
+    // Normalize fragments: 4-16 -> use directly
+    uint8_t targetFragments = constrain(fireworksParams.fragments, 4, 16);
+    
+    // One launch site per 300 LEDs keeps the sky as busy on long strips
+    uint8_t launchers = (NUM_LEDS + 299) / 300;
+    
+    for (uint8_t s = effectSteps(lastUpdate, 20); s > 0; s--) {
+        // Randomly launch new fireworks
+        for (uint8_t l = 0; l < launchers; l++) {
+            if (random8() < fireworksParams.chance / 4) {
+                q16_16 launchPos = (q16_16)random16(NUM_LEDS) << 16;
+                CRGB launchColor = CHSV(random8(), 255, 255);
                 
-                // Deactivation
-                if (fragments[f].brightness < 10 || 
-                    fragments[f].position < 0 || 
-                    fragments[f].position >= NUM_LEDS * 10) {
-                    fragments[f].active = false;
+                for (uint8_t f = 0; f < targetFragments && !pool.full(); f++) {
+                    q16_16 speed = q16Ratio(random8(10, 30), 10);
+                    pool.spawn(launchPos, random8(2) ? speed : -speed, launchColor, 255);
                 }
             }
         }
         
-        lastUpdate = millis();
+        // Move, fade, and retire fragments that burn out or leave the strip
+        pool.integrate(-gravity);
+        pool.update([&](uint16_t f) {
+            pool.life[f] = qsub8(pool.life[f], 8);
+            return pool.life[f] >= 10 && pool.pos[f] >= 0 && pool.pos[f] < end;
+        });
     }
     
     // Render
-    if (!fireworksParams.overlay) {
-        fadeAll(50);  // Normal fading
-    } else {
-        fadeAll(10);  // Gentle fading in overlay mode to prevent saturation
+    for (uint8_t f = 0; f < effectTime.frames; f++) {
+        if (!fireworksParams.overlay) {
+            fadeAll(50);  // Normal fading
+        } else {
+            fadeAll(10);  // Gentle fading in overlay mode to prevent saturation
+        }
     }
     
-    for (uint8_t f = 0; f < 32; f++) {
-        if (fragments[f].active) {
-            int16_t ledPos = fragments[f].position / 10;
-            if (ledPos >= 0 && ledPos < NUM_LEDS) {
-                CRGB col = fragments[f].color;
-                col.nscale8(fragments[f].brightness);
-                // Use blend instead of += to avoid cumulation to white
-                leds[ledPos] = blend(leds[ledPos], col, 180);
-            }
-        }
+    uint8_t fraction = effectStepFraction(lastUpdate, 20);
+    for (uint16_t f = 0; f < pool.count(); f++) {
+        CRGB col = pool.color[f];
+        col.nscale8(pool.life[f]);
+        // Blend instead of += to avoid cumulation to white
+        splat(pool.at(f, fraction), col, 180);
     }
 }
 
+// Per LED: lit flakes (ActiveSet.h). Flakes fall along
+// ledOrder(direction) - forward is down the strip from LED 0, down is down
+// the tree - and are stored as steps along it; reverse is the random mode.
+struct SnowSparkleState {
+    ActiveSet flakes;
+    uint32_t lastUpdate = 0;
+    uint32_t lastSpawn = 0;
+};
+
 void effectSnowSparkle() {
-    static uint8_t snowBrightness[NUM_LEDS];
-    static uint32_t lastUpdate = 0;
-    static uint32_t lastSpawn = 0;
+    auto& [flakes, lastUpdate, lastSpawn] = effectState<SnowSparkleState>();
+    ActivePool pool = ActivePool::bind(flakes);
     
     uint16_t moveDelayMs = map(snowSparkleParams.speed, 0, 255, 80, 15);  // Movement speed
     uint16_t spawnDelayMs = map(snowSparkleParams.density, 0, 255, 500, 30);  // Frequency of new flakes
     
-    if (snowSparkleParams.direction == DIR_FORWARD) {
+    bool falling = snowSparkleParams.direction != DIR_REVERSE;
+    const uint16_t* order = ledOrder(falling ? snowSparkleParams.direction : DIR_FORWARD);
+    
+    if (falling) {
         // Falling mode
         
-        // Move flakes downward
-        if (millis() - lastUpdate > moveDelayMs) {
-            for (int16_t i = NUM_LEDS - 1; i > 0; i--) {
-                snowBrightness[i] = snowBrightness[i - 1];
-            }
-            snowBrightness[0] = 0;  // Clear top
-            lastUpdate = millis();
+        // Move flakes one step along the order
+        for (uint8_t s = effectSteps(lastUpdate, moveDelayMs); s > 0; s--) {
+            pool.shift(1);
         }
         
-        // Add new flakes at top
-        if (millis() - lastSpawn > spawnDelayMs) {
-            // Add flake in random position near top (0-2)
+        // Add new flakes at its start
+        for (uint8_t s = effectSteps(lastSpawn, spawnDelayMs); s > 0; s--) {
+            // Add flake in random position near the start (0-2)
             uint8_t startPos = random8(3);
             if (startPos < NUM_LEDS) {
-                snowBrightness[startPos] = 255;
+                ActivePixel* p = pool.touch(startPos);
+                if (p != nullptr) p->level = 255;
             }
-            lastSpawn = millis();
         }
         
     } else {
         // Random mode
-        if (millis() - lastUpdate > moveDelayMs) {
+        for (uint8_t step = effectSteps(lastUpdate, moveDelayMs); step > 0; step--) {
             // New random flakes - add several at once depending on density
             uint8_t numSpawns = map(snowSparkleParams.density, 0, 255, 1, 5);
             for (uint8_t s = 0; s < numSpawns; s++) {
                 if (random8() < 120) {  // High chance
-                    snowBrightness[random16(NUM_LEDS)] = 255;
+                    ActivePixel* p = pool.touch(random16(NUM_LEDS));
+                    if (p != nullptr) p->level = 255;
                 }
             }
             
             // Fade out in random mode - slower fade
-            for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                snowBrightness[i] = qsub8(snowBrightness[i], 8);
-            }
-            
-            lastUpdate = millis();
+            pool.update([](ActivePixel& p) {
+                p.level = qsub8(p.level, 8);
+                return p.level > 0;
+            });
         }
     }
     
     // Render
-    FastLED.clear();
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        if (snowBrightness[i] > 0) {
-            CRGB col = snowSparkleParams.color;
-            col.nscale8(snowBrightness[i]);
-            leds[i] = col;
-        }
+    clearLeds();
+    for (uint16_t i = 0; i < pool.count(); i++) {
+        CRGB col = snowSparkleParams.color;
+        col.nscale8(pool.pixels[i].level);
+        leds[order[pool.pixels[i].led]] = col;
     }
 }
 
@@ -1372,105 +1523,94 @@ void effectSnowSparkle() {
 // CATEGORY 7: SPECIAL EFFECTS
 // ============================================================================
 
-// Structure for ball
-struct Ball {
-    float position;
-    float velocity;
-    float height;
-    CRGB color;
+struct BouncingBallsState {
+    ParticleSet balls;
+    uint32_t lastUpdate = 0;
+    Q16Step gravity;
 };
 
-static Ball balls[8];
-
 void effectBouncingBalls() {
-    static bool initialized = false;
-    static uint32_t lastUpdate = 0;
-    static uint8_t lastNumBalls = 0;
+    auto& [balls, lastUpdate, gravity] = effectState<BouncingBallsState>();
+    ParticlePool pool = ParticlePool::bind(balls);
     
-    CRGBPalette16 pal = getPalette(bouncingBallsParams.palette);
+    const CRGB* pal = PaletteCache::get(bouncingBallsParams.palette);
     
     // Reinitialize when number of balls changes or on first run
-    if (!initialized || lastNumBalls != bouncingBallsParams.numBalls) {
-        for (uint8_t i = 0; i < 8; i++) {
+    uint8_t numBalls = min<uint16_t>(min<uint8_t>(bouncingBallsParams.numBalls, 8), pool.capacity);
+    if (pool.count() != numBalls) {
+        pool.clear();
+        for (uint8_t i = 0; i < numBalls; i++) {
             // Distribute balls at different starting positions
-            balls[i].position = (i * NUM_LEDS / 8);
-            balls[i].velocity = 0;
-            balls[i].height = random8(NUM_LEDS / 2, NUM_LEDS);
+            pool.spawn((q16_16)(i * NUM_LEDS / 8) << 16, 0, paletteColor(pal, i * 32, 255));
         }
-        lastNumBalls = bouncingBallsParams.numBalls;
-        initialized = true;
     }
     
-    float gravity = (float)bouncingBallsParams.gravity / 5000.0;
-    float damping = 0.9;
+    q16_16 bottom = (q16_16)(NUM_LEDS - 1) << 16;
     
-    if (millis() - lastUpdate > 15) {
-        for (uint8_t i = 0; i < bouncingBallsParams.numBalls && i < 8; i++) {
-            balls[i].velocity += gravity;
-            balls[i].position += balls[i].velocity;
+    for (uint8_t s = effectSteps(lastUpdate, 15); s > 0; s--) {
+        pool.integrate(gravity.next(bouncingBallsParams.gravity, 5000));
+        pool.update([&](uint16_t i) {
+            q16_16& position = pool.pos[i];
+            q16_16& velocity = pool.vel[i];
             
-            // Bounce from bottom
-            if (balls[i].position >= NUM_LEDS - 1) {
-                balls[i].position = NUM_LEDS - 1;
-                balls[i].velocity = -balls[i].velocity * damping;
+            // Bounce from bottom, damping 0.9
+            if (position >= bottom) {
+                position = bottom;
+                velocity = -velocity * 9 / 10;
                 
                 // Reset if too slow
-                if (abs(balls[i].velocity) < 0.5) {
-                    balls[i].position = 0;
-                    balls[i].velocity = 0;
+                if (abs(velocity) < q16Ratio(1, 2)) {
+                    position = 0;
+                    velocity = 0;
                 }
             }
             
             // Bounce from top
-            if (balls[i].position < 0) {
-                balls[i].position = 0;
-                balls[i].velocity = -balls[i].velocity * damping;
+            if (position < 0) {
+                position = 0;
+                velocity = -velocity * 9 / 10;
             }
-        }
-        lastUpdate = millis();
+            return true;
+        });
     }
     
     // Render - use only trail to control fading
-    fadeAll(bouncingBallsParams.trail > 0 ? 50 : 255);
+    for (uint8_t f = 0; f < effectTime.frames; f++) {
+        fadeAll(bouncingBallsParams.trail > 0 ? 50 : 255);
+    }
     
-    for (uint8_t i = 0; i < bouncingBallsParams.numBalls && i < 8; i++) {
-        int16_t pos = (int16_t)balls[i].position;
+    uint8_t fraction = effectStepFraction(lastUpdate, 15);
+    for (uint8_t i = 0; i < pool.count(); i++) {
+        q16_16 pos = constrain(pool.at(i, fraction), 0, bottom);
         // Get color from palette dynamically - responds to palette change
-        CRGB ballColor = ColorFromPalette(pal, i * 32, 255, LINEARBLEND);
+        CRGB ballColor = paletteColor(pal, i * 32, 255);
         
-        if (pos >= 0 && pos < NUM_LEDS) {
-            leds[pos] = ballColor;
-            
-            // Trail
-            if (bouncingBallsParams.trail > 0) {
-                for (uint8_t t = 1; t <= bouncingBallsParams.trail; t++) {
-                    int16_t trailPos = pos - (balls[i].velocity > 0 ? t : -t);
-                    if (trailPos >= 0 && trailPos < NUM_LEDS) {
-                        CRGB col = ballColor;
-                        col.nscale8(255 - t * (255 / bouncingBallsParams.trail));
-                        // Use blend instead of += to avoid saturation
-                        leds[trailPos] = blend(leds[trailPos], col, 180);
-                    }
-                }
+        // Trail behind the direction of travel, far end first so the
+        // ball lands on top
+        if (bouncingBallsParams.trail > 0) {
+            int8_t back = pool.vel[i] > 0 ? -1 : 1;
+            for (uint8_t t = bouncingBallsParams.trail; t >= 1; t--) {
+                CRGB col = ballColor;
+                col.nscale8(255 - t * (255 / bouncingBallsParams.trail));
+                // Use blend instead of += to avoid saturation
+                splat(pos + back * ((q16_16)t << 16), col, 180);
             }
         }
+        splat(pos, ballColor);
     }
 }
 
-struct PopcornKernel {
-    float position;
-    float velocity;
-    CRGB color;
-    bool active;
+struct PopcornState {
+    ParticleSet kernels;
+    uint32_t lastUpdate = 0;
+    uint32_t lastPop = 0;
 };
 
-static PopcornKernel kernels[20];
-
 void effectPopcorn() {
-    static uint32_t lastUpdate = 0;
-    static uint32_t lastPop = 0;
+    auto& [kernels, lastUpdate, lastPop] = effectState<PopcornState>();
+    ParticlePool pool = ParticlePool::bind(kernels);
     
-    CRGBPalette16 pal = getPalette(popcornParams.palette);
+    const CRGB* pal = PaletteCache::get(popcornParams.palette);
     
     // Speed controls physics update tempo
     uint16_t updateDelay = map(popcornParams.speed, 0, 255, 40, 10);
@@ -1478,156 +1618,125 @@ void effectPopcorn() {
     uint16_t popDelay = map(popcornParams.intensity, 0, 255, 800, 50);
     
     // Adding new kernels
-    if (millis() - lastPop > popDelay) {
-        for (uint8_t k = 0; k < 20; k++) {
-            if (!kernels[k].active) {
-                kernels[k].active = true;
-                // Kernels start from random position near bottom (simulating pan frying)
-                kernels[k].position = random8(5);
-                // Different jump heights - most small/medium, but sometimes "super" jump
-                if (random8() < 20) {
-                    // ~8% chance for super jump - flies to the very top
-                    kernels[k].velocity = (float)random8(90, 120) / 10.0;  // 9.0 - 12.0
-                } else {
-                    // Normal jump
-                    kernels[k].velocity = (float)random8(20, 80) / 10.0;   // 2.0 - 8.0
-                }
-                // Dynamic color from palette
-                kernels[k].color = ColorFromPalette(pal, random8(), 255, LINEARBLEND);
-                break;
-            }
+    for (uint8_t s = effectSteps(lastPop, popDelay); s > 0; s--) {
+        // Kernels start from random position near bottom (simulating pan frying)
+        q16_16 position = (q16_16)random8(5) << 16;
+        // Different jump heights - most small/medium, but sometimes "super" jump
+        q16_16 velocity;
+        if (random8() < 20) {
+            // ~8% chance for super jump - flies to the very top
+            velocity = q16Ratio(random8(90, 120), 10);  // 9.0 - 12.0
+        } else {
+            // Normal jump
+            velocity = q16Ratio(random8(20, 80), 10);   // 2.0 - 8.0
         }
-        lastPop = millis();
+        // Dynamic color from palette
+        pool.spawn(position, velocity, paletteColor(pal, random8(), 255));
     }
     
     // Physics update
-    if (millis() - lastUpdate > updateDelay) {
-        for (uint8_t k = 0; k < 20; k++) {
-            if (kernels[k].active) {
-                // Gravity
-                kernels[k].velocity -= 0.25;
-                kernels[k].position += kernels[k].velocity;
+    for (uint8_t s = effectSteps(lastUpdate, updateDelay); s > 0; s--) {
+        // Gravity
+        pool.integrate(-q16Ratio(1, 4));
+        pool.update([&](uint16_t k) {
+            // Bounce from ground with damping (simulating bouncing)
+            if (pool.pos[k] < 0) {
+                pool.pos[k] = 0;
+                pool.vel[k] = -pool.vel[k] * 6 / 10;  // Bounce with energy loss
                 
-                // Bounce from ground with damping (simulating bouncing)
-                if (kernels[k].position < 0) {
-                    kernels[k].position = 0;
-                    kernels[k].velocity = -kernels[k].velocity * 0.6;  // Bounce with energy loss
-                    
-                    // Deactivate if too little energy
-                    if (abs(kernels[k].velocity) < 0.3) {
-                        kernels[k].active = false;
-                    }
-                }
-                
-                // Deactivate if flew too high
-                if (kernels[k].position >= NUM_LEDS) {
-                    kernels[k].active = false;
+                // Deactivate if too little energy
+                if (abs(pool.vel[k]) < q16Ratio(3, 10)) {
+                    return false;
                 }
             }
-        }
-        lastUpdate = millis();
+            
+            // Deactivate if flew too high
+            return q16Int(pool.pos[k]) < NUM_LEDS;
+        });
     }
     
     // Render
-    fadeAll(80);
+    for (uint8_t f = 0; f < effectTime.frames; f++) {
+        fadeAll(80);
+    }
     
-    for (uint8_t k = 0; k < 20; k++) {
-        if (kernels[k].active) {
-            int16_t pos = (int16_t)kernels[k].position;
-            if (pos >= 0 && pos < NUM_LEDS) {
-                leds[pos] = kernels[k].color;
-            }
-        }
+    uint8_t fraction = effectStepFraction(lastUpdate, updateDelay);
+    for (uint16_t k = 0; k < pool.count(); k++) {
+        splat(max<q16_16>(0, pool.at(k, fraction)), pool.color[k]);
     }
 }
 
-struct Drip {
-    float position;
-    float velocity;
-    bool active;
+// Falling drips and splashes share the pool: a splash is a drip that has
+// stopped at the bottom (vel 0), life = its brightness
+struct DripState {
+    ParticleSet drips;
+    uint32_t lastUpdate = 0;
+    uint32_t nextDripTime = 0;
+    Q16Step gravity;
 };
 
-static Drip drips[8];
-
 void effectDrip() {
-    static uint32_t lastUpdate = 0;
-    static uint8_t dripState[8] = {0};      // 0=ready, 1=falling, 2=splashing
-    static uint8_t splashBrightness[8] = {0};
-    static uint32_t nextDripTime = 0;
-    
-    float gravity = (float)dripParams.gravity / 2500.0;
-    
-    if (millis() - lastUpdate > 20) {
-        // Try to add new drip - only if time has passed
-        if (millis() > nextDripTime) {
-            for (uint8_t d = 0; d < dripParams.numDrips && d < 8; d++) {
-                if (dripState[d] == 0) {  // Ready for new drip
-                    dripState[d] = 1;
-                    drips[d].active = true;
-                    drips[d].position = 0;
-                    drips[d].velocity = 0.2;
-                    // Next drip after 800-1500ms
-                    nextDripTime = millis() + 800 + random16(700);
-                    break;
-                }
-            }
+    auto& [drips, lastUpdate, nextDripTime, gravity] = effectState<DripState>();
+    ParticlePool pool = ParticlePool::bind(drips);
+    
+    q16_16 bottom = (q16_16)(NUM_LEDS - 1) << 16;
+    
+    for (uint8_t s = effectSteps(lastUpdate, 20); s > 0; s--) {
+        // Try to add new drip - only if time has passed and a drip is free
+        if (millis() > nextDripTime && pool.count() < dripParams.numDrips) {
+            pool.spawn(0, q16Ratio(1, 5), dripParams.color);
+            // Next drip after 800-1500ms
+            nextDripTime = millis() + 800 + random16(700);
         }
         
         // Update all drips
-        for (uint8_t d = 0; d < 8; d++) {
-            if (dripState[d] == 1) {
+        q16_16 g = gravity.next(dripParams.gravity, 2500);
+        pool.update([&](uint16_t d) {
+            if (pool.vel[d] != 0) {
                 // Falling
-                drips[d].velocity += gravity;
-                drips[d].position += drips[d].velocity;
+                pool.vel[d] += g;
+                pool.pos[d] += pool.vel[d];
                 
                 // Reached bottom - splash!
-                if (drips[d].position >= NUM_LEDS - 1) {
-                    dripState[d] = 2;
-                    splashBrightness[d] = 255;
-                    drips[d].active = false;
-                }
-            } else if (dripState[d] == 2) {
-                // Splash fades
-                splashBrightness[d] = qsub8(splashBrightness[d], 12);
-                if (splashBrightness[d] < 5) {
-                    dripState[d] = 0;  // Ready for next drip
+                if (pool.pos[d] >= bottom) {
+                    pool.pos[d] = bottom;
+                    pool.vel[d] = 0;
+                    pool.life[d] = 255;
                 }
+                return true;
             }
-        }
-        
-        lastUpdate = millis();
+            // Splash fades; the drip is ready again once it is gone
+            pool.life[d] = qsub8(pool.life[d], 12);
+            return pool.life[d] >= 5;
+        });
     }
     
     // Render
-    if (!dripParams.overlay) {
-        fadeAll(30);
-    } else {
-        fadeAll(10);
+    for (uint8_t f = 0; f < effectTime.frames; f++) {
+        if (!dripParams.overlay) {
+            fadeAll(30);
+        } else {
+            fadeAll(10);
+        }
     }
     
-    for (uint8_t d = 0; d < 8; d++) {
-        if (dripState[d] == 1 && drips[d].active) {
-            // Falling drip
-            int16_t pos = (int16_t)drips[d].position;
-            
-            if (pos >= 0 && pos < NUM_LEDS) {
-                leds[pos] = dripParams.color;
-            }
-            
-            // Tail
-            uint8_t tailLen = constrain((int)(drips[d].velocity * 1.5), 1, 6);
-            for (uint8_t t = 1; t <= tailLen; t++) {
-                int16_t tailPos = pos - t;
-                if (tailPos >= 0 && tailPos < NUM_LEDS) {
-                    CRGB col = dripParams.color;
-                    col.nscale8(255 - (t * 40));
-                    leds[tailPos] = col;
-                }
+    uint8_t fraction = effectStepFraction(lastUpdate, 20);
+    for (uint16_t d = 0; d < pool.count(); d++) {
+        if (pool.vel[d] != 0) {
+            // Falling drip, tail first
+            q16_16 pos = min(pool.at(d, fraction), bottom);
+            uint8_t tailLen = constrain(q16Int(pool.vel[d] * 3 / 2), 1, 6);
+            for (uint8_t t = tailLen; t >= 1; t--) {
+                CRGB col = dripParams.color;
+                col.nscale8(255 - (t * 40));
+                splat(pos - ((q16_16)t << 16), col);
             }
-        } else if (dripState[d] == 2) {
+            splat(pos, dripParams.color);
+        } else {
             // Splash at bottom
+            uint8_t splashBrightness = pool.life[d];
             CRGB splashCol = dripParams.color;
-            splashCol.nscale8(splashBrightness[d]);
+            splashCol.nscale8(splashBrightness);
             
             // Main impact point
             leds[NUM_LEDS - 1] = splashCol;
@@ -1637,51 +1746,73 @@ void effectDrip() {
                 int16_t splashPos = NUM_LEDS - 1 - s;
                 if (splashPos >= 0) {
                     CRGB col = dripParams.color;
-                    col.nscale8(splashBrightness[d] * (9 - s) / 9);
-                    leds[splashPos] = blend(leds[splashPos], col, splashBrightness[d]);
+                    col.nscale8(splashBrightness * (9 - s) / 9);
+                    leds[splashPos] = blend(leds[splashPos], col, splashBrightness);
                 }
             }
         }
     }
 }
 
-void effectPlasma() {
-    static uint16_t phase1 = 0;
-    static uint16_t phase2 = 0;
+struct PlasmaState {
+    uint32_t phase1_8 = 0;     // Q8.8
+    uint32_t phase2_8 = 0;
+};
+
+void effectPlasmaTile(uint16_t start, uint16_t end) {
+    const PlasmaState& st = effectState<PlasmaState>();
+    uint16_t phase1 = st.phase1_8 >> 8;
+    uint16_t phase2 = st.phase2_8 >> 8;
     
     // Intensity controls wave scale (1-20)
     uint8_t waveScale = map(plasmaParams.intensity, 0, 255, 3, 20);
     
-    for (uint16_t i = 0; i < NUM_LEDS; i++) {
-        uint8_t sin1 = sin8(i * waveScale + phase1);
-        uint8_t sin2 = sin8(i * (waveScale + 5) - phase2);
-        uint8_t sin3 = sin8(i * (waveScale / 2) + phase1 / 2);
-        
-        uint8_t colorIndex = (sin1 + sin2 + sin3) / 3;
-        
-        leds[i] = CHSV(colorIndex + plasmaParams.phase, 255, 255);
-    }
-    
-    phase1 += map(plasmaParams.speed, 0, 255, 2, 15);
-    phase2 += map(plasmaParams.speed, 0, 255, 3, 20);
+    const Oscillator waves[] = {
+        { OscillatorBank::whole(waveScale),     OscillatorBank::whole(phase1),     255, SHAPE_SINE },
+        { OscillatorBank::whole(waveScale + 5), OscillatorBank::whole(-phase2),    255, SHAPE_SINE },
+        { OscillatorBank::whole(waveScale / 2), OscillatorBank::whole(phase1 / 2), 255, SHAPE_SINE },
+    };
+    const CRGB* hues = PaletteCache::hues();
+    uint8_t hueShift = plasmaParams.phase;
+    
+    OscillatorBank::render(waves, 3, start, end, [&](uint16_t i, uint8_t colorIndex) {
+        leds[i] = hues[(uint8_t)(colorIndex + hueShift)];
+    });
 }
 
+void effectPlasmaAdvance() {
+    PlasmaState& st = effectState<PlasmaState>();
+    st.phase1_8 += effectStep8(map(plasmaParams.speed, 0, 255, 2, 15));
+    st.phase2_8 += effectStep8(map(plasmaParams.speed, 0, 255, 3, 20));
+}
+
+void effectPlasma() {
+    effectPlasmaTile(0, NUM_LEDS);
+    effectPlasmaAdvance();
+}
+
+struct LightningState {
+    uint32_t lastFlash = 0;
+    uint8_t flashState = 0;
+    uint8_t flashCount = 0;
+    int16_t flashStart = 0;
+    int16_t flashLen = 0;
+};
+
 void effectLightning() {
-    static uint32_t lastFlash = 0;
-    static uint8_t flashState = 0;
-    static uint8_t flashCount = 0;
-    static int16_t flashStart = 0;
-    static int16_t flashLen = 0;
+    auto& [lastFlash, flashState, flashCount, flashStart, flashLen] = effectState<LightningState>();
     
     // Frequency mapped: 0=rarely, 255=often
     uint8_t flashChance = map(lightningParams.frequency, 0, 255, 3, 80);
     
-    // New flash
-    if (flashState == 0 && random8() < flashChance) {
-        flashState = 1;
-        flashCount = random8(2, 5);  // 2-4 flashes in series
-        flashStart = random8(NUM_LEDS / 4, NUM_LEDS * 3 / 4);  // Middle section
-        flashLen = random8(8, 25);
+    // New flash (one chance per reference frame)
+    for (uint8_t f = 0; f < effectTime.frames && flashState == 0; f++) {
+        if (random8() < flashChance) {
+            flashState = 1;
+            flashCount = random8(2, 5);  // 2-4 flashes in series
+            flashStart = random16(NUM_LEDS / 4, NUM_LEDS * 3 / 4);  // Middle section
+            flashLen = random8(8, 25);
+        }
     }
     
     // Stormy background
@@ -1689,13 +1820,13 @@ void effectLightning() {
     
     if (lightningParams.overlay) {
         // Overlay - fade first, then gently add background
-        fadeAll(25);
-        for (uint16_t i = 0; i < NUM_LEDS; i++) {
-            leds[i] = blend(leds[i], bgColor, 30);  // Gentle blend with background
+        for (uint8_t f = 0; f < effectTime.frames; f++) {
+            fadeAll(25);
+            LEDKernels::blendToward(leds, NUM_LEDS, bgColor, 30);  // Gentle blend with background
         }
     } else {
         // Normal mode - full background
-        fill_solid(leds, NUM_LEDS, bgColor);
+        LEDKernels::fill(leds, NUM_LEDS, bgColor);
     }
     
     // Flash handling
@@ -1731,7 +1862,7 @@ void effectLightning() {
             
             flashState = 2;
             lastFlash = millis();
-        } else if (flashState == 2 && millis() - lastFlash > 40 + random8(60)) {
+        } else if (flashState == 2 && millis() - lastFlash > (uint32_t)(40 + random8(60))) {
             // Pause between flashes
             flashCount--;
             if (flashCount > 0) {
@@ -1745,84 +1876,70 @@ void effectLightning() {
     }
 }
 
-struct MatrixDrop {
-    int16_t position;
-    uint8_t speed;
-    bool active;
+struct MatrixState {
+    ParticleSet drops;
+    uint32_t lastUpdate = 0;
 };
 
-static MatrixDrop matrixDrops[20];
-
 void effectMatrix() {
-    static uint32_t lastUpdate = 0;
+    auto& [drops, lastUpdate] = effectState<MatrixState>();
+    ParticlePool pool = ParticlePool::bind(drops);
     
     // Always use color from parameters
     CRGB dropColor = matrixParams.color;
     
     uint16_t delayMs = map(matrixParams.speed, 0, 255, 80, 15);
+    q16_16 end = (q16_16)(NUM_LEDS + matrixParams.trailLength) << 16;
     
-    if (millis() - lastUpdate > delayMs) {
+    // One spawn chance per 300 LEDs, so long strips rain as densely
+    uint8_t spawners = (NUM_LEDS + 299) / 300;
+    
+    for (uint8_t s = effectSteps(lastUpdate, delayMs); s > 0; s--) {
         // spawningRate - minimum 10 to always have drops
         uint8_t spawnChance = max((uint8_t)10, matrixParams.spawningRate);
         
-        // New drops
-        if (random8() < spawnChance) {
-            for (uint8_t d = 0; d < 20; d++) {
-                if (!matrixDrops[d].active) {
-                    matrixDrops[d].active = true;
-                    matrixDrops[d].position = 0;
-                    matrixDrops[d].speed = random8(1, 3);
-                    break;
-                }
+        // New drops, 1-2 LEDs per step
+        for (uint8_t n = 0; n < spawners; n++) {
+            if (random8() < spawnChance) {
+                pool.spawn(0, (q16_16)random8(1, 3) << 16, dropColor);
             }
         }
         
         // Update drops
-        for (uint8_t d = 0; d < 20; d++) {
-            if (matrixDrops[d].active) {
-                matrixDrops[d].position += matrixDrops[d].speed;
-                
-                if (matrixDrops[d].position >= NUM_LEDS + matrixParams.trailLength) {
-                    matrixDrops[d].active = false;
-                }
-            }
-        }
-        
-        lastUpdate = millis();
+        pool.integrate(0);
+        pool.update([&](uint16_t d) { return pool.pos[d] < end; });
     }
     
     // Render
-    FastLED.clear();
+    clearLeds();
     
-    for (uint8_t d = 0; d < 20; d++) {
-        if (matrixDrops[d].active) {
-            int16_t headPos = matrixDrops[d].position;
-            
-            // Head of drop (white/bright)
-            if (headPos >= 0 && headPos < NUM_LEDS) {
-                leds[headPos] = CRGB::White;
-            }
-            
-            // Tail - trailLength now works clearly
-            uint8_t actualTrail = constrain(matrixParams.trailLength, 3, 30);
-            for (uint8_t t = 1; t <= actualTrail; t++) {
-                int16_t tailPos = headPos - t;
-                if (tailPos >= 0 && tailPos < NUM_LEDS) {
-                    // Better gradient - exponential fade
-                    uint8_t fadeAmount = 255 * (actualTrail - t + 1) / (actualTrail + 1);
-                    CRGB col = dropColor;
-                    col.nscale8(fadeAmount);
-                    leds[tailPos] = col;
-                }
-            }
+    uint8_t fraction = effectStepFraction(lastUpdate, delayMs);
+    uint8_t actualTrail = constrain(matrixParams.trailLength, 3, 30);
+    for (uint16_t d = 0; d < pool.count(); d++) {
+        q16_16 headPos = pool.at(d, fraction);
+        
+        // Head of drop (white/bright)
+        splatAdd(headPos, CRGB::White);
+        
+        // Tail - trailLength now works clearly
+        for (uint8_t t = 1; t <= actualTrail; t++) {
+            // Better gradient - exponential fade
+            uint8_t fadeAmount = 255 * (actualTrail - t + 1) / (actualTrail + 1);
+            CRGB col = dropColor;
+            col.nscale8(fadeAmount);
+            splatAdd(headPos - ((q16_16)t << 16), col);
         }
     }
 }
 
+struct HeartbeatState {
+    uint32_t lastBeat = 0;
+    uint8_t beatPhase = 0;  // 0=pause, 1=first, 2=pause2, 3=second
+    uint8_t brightness = 0;
+};
+
 void effectHeartbeat() {
-    static uint32_t lastBeat = 0;
-    static uint8_t beatPhase = 0;  // 0=pause, 1=first, 2=pause2, 3=second
-    static uint8_t brightness = 0;
+    auto& [lastBeat, beatPhase, brightness] = effectState<HeartbeatState>();
     
     uint32_t beatInterval = 60000 / heartbeatParams.bpm;
     uint32_t now = millis();
@@ -1834,7 +1951,7 @@ void effectHeartbeat() {
                 beatPhase = 1;
                 lastBeat = now;
             }
-            brightness = qsub8(brightness, 10);
+            brightness = qsub8(brightness, effectFrameAmount(10));
             break;
             
         case 1:  // First beat (stronger)
@@ -1847,7 +1964,7 @@ void effectHeartbeat() {
             break;
             
         case 2:  // Short pause
-            brightness = qsub8(brightness, 30);
+            brightness = qsub8(brightness, effectFrameAmount(30));
             if (now - lastBeat > 100) {
                 beatPhase = 3;
                 lastBeat = now;
@@ -1866,21 +1983,26 @@ void effectHeartbeat() {
     
     // Fade outside beats
     if (beatPhase == 0 || beatPhase == 2) {
-        brightness = qsub8(brightness, 15);
+        brightness = qsub8(brightness, effectFrameAmount(15));
     }
     
     // Render
     CRGB col = heartbeatParams.color;
     col.nscale8(brightness);
-    fill_solid(leds, NUM_LEDS, col);
+    LEDKernels::fill(leds, NUM_LEDS, col);
 }
 
 // ============================================================================
 // CATEGORY 8: BREATHING/FADE EFFECTS
 // ============================================================================
 
+struct BreatheState {
+    uint32_t phase8 = 0;
+};
+
 void effectBreathe() {
-    static uint16_t phase = 0;
+    uint32_t& phase8 = effectState<BreatheState>().phase8;
+    uint16_t phase = phase8 >> 8;
     
     // Sinusoidal breathing
     uint8_t breath = sin8(phase);
@@ -1893,21 +2015,32 @@ void effectBreathe() {
         col.nscale8(breath);
     }
     
-    fill_solid(leds, NUM_LEDS, col);
+    LEDKernels::fill(leds, NUM_LEDS, col);
+    
+    // Same curve at 16 bits, so the dim end of a breath doesn't step
+    uint16_t breath16 = sin16(phase8) + 32768;
+    HDRFrame::setSolid(breatheParams.twoColor
+        ? blendRGB16(breatheParams.colorPrimary, breatheParams.colorSecondary, breath16)
+        : scaleRGB16(breatheParams.colorPrimary, breath16));
     
-    phase += map(breatheParams.speed, 0, 255, 1, 8);
+    phase8 += effectStep8(map(breatheParams.speed, 0, 255, 1, 8));
 }
 
+// Per LED: 0=off, 1=on
+struct DissolveState {
+    uint8_t dissolvePhase = 0;      // 0=filling, 1=dissolving
+    uint16_t activeCount = 0;
+    uint32_t lastStep = 0;
+    CRGB currentColor = CRGB::Black;
+};
+
 void effectDissolve() {
-    static uint8_t pixelState[NUM_LEDS];  // 0=off, 1=on
-    static uint8_t dissolvePhase = 0;      // 0=filling, 1=dissolving
-    static uint16_t activeCount = 0;
-    static uint32_t lastStep = 0;
-    static CRGB currentColor;
+    auto& [dissolvePhase, activeCount, lastStep, currentColor] = effectState<DissolveState>();
+    uint8_t* pixelState = effectLedState();
     
     uint16_t delayMs = map(dissolveParams.repeatSpeed, 0, 255, 50, 10);
     
-    if (millis() - lastStep > delayMs) {
+    for (uint8_t s = effectSteps(lastStep, delayMs); s > 0; s--) {
         if (dissolvePhase == 0) {
             // Filling phase
             uint8_t toFill = map(dissolveParams.dissolveSpeed, 0, 255, 1, 5);
@@ -1953,8 +2086,6 @@ void effectDissolve() {
                 }
             }
         }
-        
-        lastStep = millis();
     }
     
     // Render
@@ -1967,11 +2098,15 @@ void effectDissolve() {
     }
 }
 
+struct FadeState {
+    uint32_t phase8 = 0;
+    uint8_t currentColor = 0;
+};
+
 void effectFade() {
-    static uint16_t phase = 0;
-    static uint8_t currentColor = 0;
+    auto& [phase8, currentColor] = effectState<FadeState>();
     
-    uint8_t blendAmount = phase & 0xFF;
+    uint8_t blendAmount = (phase8 >> 8) & 0xFF;
     uint8_t nextColor = currentColor + 1;
     bool isLastToFirst = false;
     
@@ -1982,22 +2117,28 @@ void effectFade() {
     }
     
     CRGB col;
+    CRGB16 col16;
     
     // If loop is off and we're going from last to first, don't blend - just show current color
     if (!fadeParams.loop && isLastToFirst) {
         col = fadeParams.colors[currentColor];
+        col16 = toRGB16(col);
     } else {
         col = blend(fadeParams.colors[currentColor], 
                     fadeParams.colors[nextColor], 
                     blendAmount);
+        col16 = blendRGB16(fadeParams.colors[currentColor],
+                           fadeParams.colors[nextColor],
+                           phase8 & 0xFFFF);
     }
     
-    fill_solid(leds, NUM_LEDS, col);
+    LEDKernels::fill(leds, NUM_LEDS, col);
+    HDRFrame::setSolid(col16);
     
-    phase += map(fadeParams.speed, 0, 255, 1, 8);
+    phase8 += effectStep8(map(fadeParams.speed, 0, 255, 1, 8));
     
-    if (phase >= 256) {
-        phase = 0;
+    if (phase8 >= (256 << 8)) {
+        phase8 = 0;
         currentColor = nextColor;
     }
 }
@@ -2006,32 +2147,35 @@ void effectFade() {
 // CATEGORY 9: ALARM EFFECTS
 // ============================================================================
 
+struct PoliceState {
+    uint32_t lastSwitch = 0;
+    bool side = false;
+    uint8_t flashCount = 0;
+};
+
 void effectPolice() {
-    static uint32_t lastSwitch = 0;
-    static bool side = false;
-    static uint8_t flashCount = 0;
+    auto& [lastSwitch, side, flashCount] = effectState<PoliceState>();
     
     uint16_t flashInterval = map(policeLightsParams.speed, 0, 255, 150, 30);
     
-    if (millis() - lastSwitch > flashInterval) {
+    for (uint8_t s = effectSteps(lastSwitch, flashInterval); s > 0; s--) {
         flashCount++;
         if (flashCount >= 3) {
             flashCount = 0;
             side = !side;
         }
-        lastSwitch = millis();
     }
     
     switch (policeLightsParams.style) {
         case POLICE_SINGLE:
-            fill_solid(leds, NUM_LEDS, side ? policeLightsParams.color1 : policeLightsParams.color2);
+            LEDKernels::fill(leds, NUM_LEDS, side ? policeLightsParams.color1 : policeLightsParams.color2);
             break;
             
         case POLICE_SOLID:
             if (flashCount % 2 == 0) {
-                fill_solid(leds, NUM_LEDS, side ? policeLightsParams.color1 : policeLightsParams.color2);
+                LEDKernels::fill(leds, NUM_LEDS, side ? policeLightsParams.color1 : policeLightsParams.color2);
             } else {
-                FastLED.clear();
+                clearLeds();
             }
             break;
             
@@ -2045,33 +2189,34 @@ void effectPolice() {
             }
             // Flash effect
             if (flashCount % 2 == 1) {
-                for (uint16_t i = 0; i < NUM_LEDS; i++) {
-                    leds[i].nscale8(50);
-                }
+                LEDKernels::scale(leds, NUM_LEDS, 50);
             }
             break;
     }
 }
 
+struct StrobeState {
+    uint32_t lastFlash = 0;
+    bool on = false;
+    uint8_t hue = 0;
+    uint8_t megaFlashCount = 0;
+};
+
 void effectStrobe() {
-    static uint32_t lastFlash = 0;
-    static bool on = false;
-    static uint8_t hue = 0;
-    static uint8_t megaFlashCount = 0;
+    auto& [lastFlash, on, hue, megaFlashCount] = effectState<StrobeState>();
     
     uint16_t interval = map(strobeParams.frequency, 0, 255, 200, 20);
     
     switch (strobeParams.mode) {
         case STROBE_NORMAL:
             // Single flash with chosen color
-            if (millis() - lastFlash > (on ? 30 : interval)) {
+            if (effectSteps(lastFlash, on ? 30 : interval)) {
                 on = !on;
-                lastFlash = millis();
             }
             if (on) {
-                fill_solid(leds, NUM_LEDS, strobeParams.color);
+                LEDKernels::fill(leds, NUM_LEDS, strobeParams.color);
             } else {
-                FastLED.clear();
+                clearLeds();
             }
             break;
             
@@ -2079,44 +2224,46 @@ void effectStrobe() {
             // Rapid triple flashes - first 2 in color, 3rd in white
             {
                 uint16_t megaInterval = interval / 2; // 2x faster base
-                if (millis() - lastFlash > (on ? 15 : megaInterval)) {
+                if (effectSteps(lastFlash, on ? 15 : megaInterval)) {
                     on = !on;
-                    lastFlash = millis();
                     if (!on) {
                         megaFlashCount++;
                         if (megaFlashCount >= 3) {
                             megaFlashCount = 0;
-                            // Extra pause after burst
-                            lastFlash = millis() - megaInterval + interval / 2;
                         }
                     }
                 }
                 if (on) {
                     // Flash 1 and 2 = chosen color, flash 3 = white
                     CRGB flashColor = (megaFlashCount < 2) ? strobeParams.color : CRGB::White;
-                    fill_solid(leds, NUM_LEDS, flashColor);
+                    LEDKernels::fill(leds, NUM_LEDS, flashColor);
                 } else {
-                    FastLED.clear();
+                    clearLeds();
                 }
             }
             break;
             
         case STROBE_RAINBOW:
             // Rainbow color cycling strobe
-            if (millis() - lastFlash > (on ? 25 : interval)) {
+            if (effectSteps(lastFlash, on ? 25 : interval)) {
                 on = !on;
-                lastFlash = millis();
                 if (on) {
                     hue += 15; // Change color each flash
                 }
             }
             if (on) {
-                fill_solid(leds, NUM_LEDS, CHSV(hue, 255, 255));
+                LEDKernels::fill(leds, NUM_LEDS, CHSV(hue, 255, 255));
             } else {
-                FastLED.clear();
+                clearLeds();
             }
             break;
     }
 }
 
+#if LED_EFFECT_CHECKS
+#undef delay
+#undef vTaskDelay
+#undef FastLED
+#endif
+
 #endif // EFFECTS_H
@@ -53,6 +53,24 @@ void setup() {
         while (1) { delay(100); }
     }
     
+    // Initialize LED Controller with the stored strip length and layout (runs on Core 0)
+    if (LEDController::begin(NVSManager::loadLedCount(), NVSManager::loadOutputMap(),
+                             NVSManager::loadGeometry())) {
+        LOG_INFO("LED Controller started successfully");
+    } else {
+        LOG_ERROR("Failed to start LED Controller!");
+    }
+    
+    // Restore output color correction
+    LEDController::loadColorFromJson(NVSManager::loadColor());
+    
+    // Restore the effect transition before the first effect fades in
+    uint16_t savedTransitionMs;
+    uint8_t savedCurve;
+    if (NVSManager::loadTransition(savedTransitionMs, savedCurve)) {
+        LEDController::setTransition(savedTransitionMs, (TransitionCurve)savedCurve);
+    }
+    
     // Load and set saved effect immediately (before WiFi connection)
     // This ensures smooth transition from startup animation
     uint8_t savedEffect = NVSManager::loadEffect();
@@ -68,6 +86,18 @@ void setup() {
         }
     }
     
+    // Restore segments (if the strip was split into independent effects)
+    String savedSegments = NVSManager::loadSegments();
+    if (!savedSegments.isEmpty()) {
+        LEDController::loadSegmentsFromJson(savedSegments);
+    }
+    
+    // Restore the playlist (takes over from the saved effect)
+    String savedPlaylist = NVSManager::loadPlaylist();
+    if (!savedPlaylist.isEmpty()) {
+        LEDController::loadPlaylistFromJson(savedPlaylist);
+    }
+    
     // Load saved brightness
     uint8_t savedBrightness = NVSManager::loadBrightness();
     if (savedBrightness != 0xFF) {
@@ -132,8 +162,8 @@ void setup() {
             LOG_INFO("Device is online - BLE provisioning not needed");
             
             // Effect was already loaded above, but ensure effectReady is set
-            // in case there was no stored effect
-            if (!hasStoredEffect) {
+            // in case there was no stored effect (or playlist)
+            if (!LEDController::isEffectReady()) {
                 LEDController::setEffect(0);  // Default to Solid
                 LOG_INFO("No saved effect, using default: Solid");
             }
@@ -272,13 +302,6 @@ void initGPIO() {
     pinMode(LED_BUILTIN_PIN, OUTPUT);
     digitalWrite(LED_BUILTIN_PIN, LOW);
     LOG_PRINTF("INFO ", "  Status LED: GPIO%d", LED_BUILTIN_PIN);
-    
-    // Initialize LED Controller (runs on Core 0)
-    if (LEDController::begin()) {
-        LOG_INFO("LED Controller started successfully");
-    } else {
-        LOG_ERROR("Failed to start LED Controller!");
-    }
 }
 
 // Start provisioning mode (BLE + AP + HTTP)
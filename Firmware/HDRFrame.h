@@ -0,0 +1,291 @@
+/*
+ * HDRFrame.h - 16-bit frame and temporal dithering
+ *
+ * Carries frames with more than 8 bits per channel to the output stage,
+ * which dithers them down to the 8 bits the LEDs take
+ */
+
+#ifndef HDR_FRAME_H
+#define HDR_FRAME_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "EffectDefs.h"
+
+// ============================================================================
+// CRGB16 - 8.8 fixed point color (0xFF00 = full)
+// ============================================================================
+
+struct CRGB16 {
+    uint16_t r, g, b;
+};
+
+inline CRGB16 toRGB16(CRGB c) {
+    return { (uint16_t)(c.r << 8), (uint16_t)(c.g << 8), (uint16_t)(c.b << 8) };
+}
+
+// c at level/65536 of full
+inline CRGB16 scaleRGB16(CRGB c, uint16_t level) {
+    return { (uint16_t)((c.r * (uint32_t)level) >> 8),
+             (uint16_t)((c.g * (uint32_t)level) >> 8),
+             (uint16_t)((c.b * (uint32_t)level) >> 8) };
+}
+
+// a faded towards b by amountOfB/65536
+inline CRGB16 blendRGB16(CRGB a, CRGB b, uint16_t amountOfB) {
+    auto mix = [amountOfB](uint8_t x, uint8_t y) {
+        return (uint16_t)((x << 8) + (((int32_t)y - x) * amountOfB >> 8));
+    };
+    return { mix(a.r, b.r), mix(a.g, b.g), mix(a.b, b.b) };
+}
+
+// ============================================================================
+// HDRFrame - Frame handed to LEDOutput at more than 8 bits
+// ============================================================================
+// leds[] stays the 8-bit frame every effect renders and reads back. A frame
+// can additionally come with a 16-bit version, which the output stage then
+// uses instead of leds[]:
+//
+//   FRAME_SOLID   one color for the whole strip (effects that fill_solid a
+//                 slowly changing color - Breathe, Fade), before color
+//                 correction; set by the effect, only when it renders the
+//                 main frame
+//   FRAME_MIXED   a full frame of output values, color correction and
+//                 brightness already applied (transition crossfades, which
+//                 blend in linear light)
+//
+// The mode is consumed by the next present(); a frame that sets nothing is
+// plain 8-bit. Either way, everything leaves through the same 16-bit output
+// path (brightness and correction tables are 8.8 as well) and is quantized
+// by temporal error diffusion: each channel of each LED keeps the fraction
+// it could not show and adds it to its next frame, so over a few frames the
+// average hits the 16-bit value. The error starts out random per channel,
+// so neighbouring LEDs at the same level don't flip in step.
+//
+// That average only exists over several frames: while any value of the
+// last frame fell between two output levels (isDithering()), the output
+// stage keeps sending frames even if the scene is static, and the LED task
+// does not go idle - one dithered frame held on the strip would just be a
+// fixed speckle. With the strip correction and brightness in the output
+// tables nearly every color falls between levels, so that is bounded:
+// after LED_DITHER_HOLD_FRAMES unchanged frames the error is set to one
+// half, the next frame is every value rounded (the same on every LED at
+// the same level) and the scene rests until something changes
+// (beginFrame()/endFrame() around the output copy).
+// ============================================================================
+
+class HDRFrame {
+public:
+    enum Mode : uint8_t {
+        FRAME_8BIT = 0,
+        FRAME_SOLID,
+        FRAME_MIXED
+    };
+
+    // Allocate the 16-bit frame and the dither error (after allocLeds())
+    static bool begin() {
+        target = leds;
+        pixels = allocLedBuffer<CRGB16>(NUM_LEDS);
+        error = allocLedBuffer<uint8_t>(NUM_LEDS * 3, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (pixels == nullptr || error == nullptr) {
+            return false;
+        }
+        seedError();
+        return true;
+    }
+
+    static bool isAvailable() { return pixels != nullptr; }
+
+    // Last frame had values between output levels - it needs more frames
+    static bool isDithering() { return dithering; }
+
+    // Before the output copy; changed = the frame differs from the one on
+    // the strip. Returns false if there is nothing to send. An unchanged
+    // frame is sent while dithering, the last one of them rounded.
+    static bool beginFrame(bool changed) {
+        if (changed) {
+            if (rounded) {
+                seedError();
+                rounded = false;
+            }
+            heldFrames = 0;
+            return true;
+        }
+        if (!dithering) {
+            return false;
+        }
+        if (++heldFrames >= LED_DITHER_HOLD_FRAMES && error != nullptr) {
+            memset(error, 0x80, NUM_LEDS * 3);
+            rounded = true;
+        }
+        return true;
+    }
+
+    // After the output copy; fraction = OR of what apply(), ditherRange()
+    // and ditherFill() returned for the frame
+    static void endFrame(uint8_t fraction) {
+        dithering = fraction != 0 && !rounded;
+    }
+
+    // Buffer for a FRAME_MIXED frame (nullptr if not allocated)
+    static CRGB16* mixBuffer() { return pixels; }
+
+    // Dither error of a logical LED (3 bytes)
+    static uint8_t* errorAt(uint16_t led) { return error + led * 3; }
+
+    // Whole frame is color (ignored unless leds[] is the main frame)
+    static void setSolid(CRGB16 color) {
+        if (leds == target && pixels != nullptr) {
+            solid = color;
+            mode = FRAME_SOLID;
+        }
+    }
+
+    // mixBuffer() holds this frame
+    static void setMixed() {
+        mode = FRAME_MIXED;
+    }
+
+    static const CRGB16& solidColor() { return solid; }
+
+    // Mode of the frame being presented; the next one starts as 8-bit
+    static Mode take() {
+        Mode m = mode;
+        mode = FRAME_8BIT;
+        return m;
+    }
+
+    // ========================================================================
+    // Dithering
+    // ========================================================================
+
+    // One channel: value plus carried error, top byte out, fraction kept
+    static inline uint8_t dither(uint16_t value, uint8_t& err) {
+        uint16_t acc = value + err;   // value <= 0xFF00, cannot overflow
+        err = (uint8_t)acc;
+        return acc >> 8;
+    }
+
+    // Take back a dither() of value: err as it was before (the carry out
+    // of the low byte is all dither() dropped)
+    static inline void undither(uint16_t value, uint8_t& err) {
+        err -= (uint8_t)value;
+    }
+
+    // 8.8 value scaled the way nscale8(scale) scales a byte - (scale + 1)/256
+    static inline uint16_t scaleValue(uint16_t value, uint8_t scale) {
+        return (uint32_t)value * (scale + 1) >> 8;
+    }
+
+    static CRGB16 scaleColor(CRGB16 c, uint8_t scale) {
+        return { scaleValue(c.r, scale), scaleValue(c.g, scale), scaleValue(c.b, scale) };
+    }
+
+    // count pixels of 8.8 values into dst, scaled by scale (255 = as they
+    // are); reversed reads src (and the error of the LEDs it belongs to)
+    // backwards from its last pixel. Returns non-zero if any value fell
+    // between output levels.
+    static uint8_t ditherRange(CRGB* dst, const CRGB16* src, uint8_t* err,
+                               uint16_t count, bool reversed, uint8_t scale = 255) {
+        uint16_t fraction = 0;
+        if (!reversed && scale != 255) {
+            const uint16_t* s = (const uint16_t*)src;
+            uint8_t* d = (uint8_t*)dst;
+            for (uint32_t i = 0; i < count * 3u; i++) {
+                uint16_t v = scaleValue(s[i], scale);
+                fraction |= v;
+                d[i] = dither(v, err[i]);
+            }
+            return (uint8_t)fraction;
+        }
+        if (!reversed) {
+            // Flat, branch-free: the compiler can vectorize this one
+            uint8_t* __restrict__ d = (uint8_t*)dst;
+            const uint16_t* __restrict__ s = (const uint16_t*)src;
+            uint8_t* __restrict__ e = err;
+            uint32_t n = count * 3;
+            for (uint32_t i = 0; i < n; i++) {
+                uint16_t acc = s[i] + e[i];
+                fraction |= s[i];
+                e[i] = (uint8_t)acc;
+                d[i] = acc >> 8;
+            }
+            return (uint8_t)fraction;
+        }
+
+        src += count - 1;
+        err += (count - 1) * 3;
+        for (uint16_t i = 0; i < count; i++, src--, err -= 3) {
+            CRGB16 v = scaleColor(*src, scale);
+            fraction |= v.r | v.g | v.b;
+            dst[i].r = dither(v.r, err[0]);
+            dst[i].g = dither(v.g, err[1]);
+            dst[i].b = dither(v.b, err[2]);
+        }
+        return (uint8_t)fraction;
+    }
+
+    // Take back a ditherRange() of the same (unscaled) values - the error
+    // of each LED goes with its value whichever way the range was read
+    static void undoRange(const CRGB16* src, uint8_t* err, uint16_t count) {
+        const uint16_t* s = (const uint16_t*)src;
+        for (uint32_t i = 0; i < count * 3u; i++) {
+            undither(s[i], err[i]);
+        }
+    }
+
+    // count pixels of one color into dst (return as ditherRange())
+    static uint8_t ditherFill(CRGB* dst, CRGB16 color, uint8_t* err,
+                              uint16_t count, bool reversed) {
+        int step = reversed ? -3 : 3;
+        if (reversed) err += (count - 1) * 3;
+        for (uint16_t i = 0; i < count; i++, err += step) {
+            dst[i].r = dither(color.r, err[0]);
+            dst[i].g = dither(color.g, err[1]);
+            dst[i].b = dither(color.b, err[2]);
+        }
+        return count ? (uint8_t)(color.r | color.g | color.b) : 0;
+    }
+
+    // Take back a ditherFill() of the same color
+    static void undoFill(CRGB16 color, uint8_t* err, uint16_t count) {
+        for (uint16_t i = 0; i < count; i++, err += 3) {
+            undither(color.r, err[0]);
+            undither(color.g, err[1]);
+            undither(color.b, err[2]);
+        }
+    }
+
+private:
+    static CRGB* target;       // Main frame buffer (leds[] outside transitions/segments)
+    static CRGB16* pixels;
+    static uint8_t* error;
+    static CRGB16 solid;
+    static Mode mode;
+    static bool dithering;
+    static bool rounded;           // Error was set to one half - scene is resting
+    static uint16_t heldFrames;    // Unchanged frames sent in a row
+
+    // Random start per channel
+    static void seedError() {
+        for (uint32_t i = 0; i < NUM_LEDS * 3; i++) {
+            error[i] = random8();
+        }
+    }
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+CRGB* HDRFrame::target = nullptr;
+CRGB16* HDRFrame::pixels = nullptr;
+uint8_t* HDRFrame::error = nullptr;
+CRGB16 HDRFrame::solid = { 0, 0, 0 };
+HDRFrame::Mode HDRFrame::mode = HDRFrame::FRAME_8BIT;
+bool HDRFrame::dithering = false;
+bool HDRFrame::rounded = false;
+uint16_t HDRFrame::heldFrames = 0;
+
+#endif // HDR_FRAME_H
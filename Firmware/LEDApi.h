@@ -20,11 +20,25 @@
 // LEDApi - HTTP REST API for LED Control
 // ============================================================================
 // Endpoints:
-// - GET  /api/led/status     → Current state
+// - GET  /api/led/status     → Current state and estimated power draw
 // - POST /api/led/effect     → Change effect
 // - POST /api/led/params     → Update parameters  
 // - POST /api/led/power      → Power on/off
 // - POST /api/led/brightness → Set brightness
+// - POST /api/led/transition → Set effect crossfade (duration, curve)
+// - GET  /api/led/color      → Output color correction
+// - POST /api/led/color      → Set gamma, white point, temperature, hue/saturation
+// - POST /api/led/count      → Set strip length (applied after reboot)
+// - GET  /api/led/outputs    → Data pins, output map and current per output
+// - POST /api/led/outputs    → Set output map (applied after reboot)
+// - GET  /api/led/geometry   → Tree layout of the strip
+// - POST /api/led/geometry   → Set tree layout (applied after reboot)
+// - GET  /api/led/segments   → List segments
+// - POST /api/led/segments   → Replace all segments (empty = whole strip)
+// - POST /api/led/segment    → Update one segment
+// - GET  /api/led/playlist   → Playlist and position
+// - POST /api/led/playlist   → Replace and start playlist (empty = stop)
+// - GET  /api/led/stats      → Frame timing (?reset=1 clears it)
 // - GET  /api/led/effects    → List all effects
 // ============================================================================
 
@@ -83,6 +97,80 @@ public:
         );
         server->addHandler(brightnessHandler);
         
+        // POST /api/led/transition - Set effect crossfade
+        AsyncCallbackJsonWebHandler* transitionHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/transition",
+            handleTransition
+        );
+        server->addHandler(transitionHandler);
+        
+        // GET /api/led/color - Output color correction
+        server->on("/api/led/color", HTTP_GET, handleGetColor);
+        
+        // POST /api/led/color - Set output color correction
+        AsyncCallbackJsonWebHandler* colorHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/color",
+            handleSetColor
+        );
+        server->addHandler(colorHandler);
+        
+        // POST /api/led/count - Set strip length
+        AsyncCallbackJsonWebHandler* countHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/count",
+            handleLedCount
+        );
+        server->addHandler(countHandler);
+        
+        // GET /api/led/outputs - Get data pins and output map
+        server->on("/api/led/outputs", HTTP_GET, handleGetOutputs);
+        
+        // POST /api/led/outputs - Set output map
+        AsyncCallbackJsonWebHandler* outputsHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/outputs",
+            handleSetOutputs
+        );
+        server->addHandler(outputsHandler);
+        
+        // GET /api/led/geometry - Tree layout of the strip
+        server->on("/api/led/geometry", HTTP_GET, handleGetGeometry);
+        
+        // POST /api/led/geometry - Set tree layout
+        AsyncCallbackJsonWebHandler* geometryHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/geometry",
+            handleSetGeometry
+        );
+        server->addHandler(geometryHandler);
+        
+        // GET /api/led/segments - List segments
+        server->on("/api/led/segments", HTTP_GET, handleGetSegments);
+        
+        // POST /api/led/segments - Replace all segments
+        AsyncCallbackJsonWebHandler* segmentsHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/segments",
+            handleSetSegments
+        );
+        server->addHandler(segmentsHandler);
+        
+        // POST /api/led/segment - Update one segment
+        AsyncCallbackJsonWebHandler* segmentHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/segment",
+            handleUpdateSegment
+        );
+        server->addHandler(segmentHandler);
+        
+        // GET /api/led/playlist - Playlist and position
+        server->on("/api/led/playlist", HTTP_GET, handleGetPlaylist);
+        
+        // POST /api/led/playlist - Replace and start playlist
+        AsyncCallbackJsonWebHandler* playlistHandler = new AsyncCallbackJsonWebHandler(
+            "/api/led/playlist",
+            handleSetPlaylist
+        );
+        server->addHandler(playlistHandler);
+        
+        // GET /api/led/stats - Render/show timing per stage and effect
+        server->on("/api/led/stats", HTTP_GET, handleGetStats);
+        
         LOG_INFO("LED API endpoints registered");
         LOG_INFO("  GET  /api/led/status");
         LOG_INFO("  GET  /api/led/effects");
@@ -91,6 +179,20 @@ public:
         LOG_INFO("  POST /api/led/params");
         LOG_INFO("  POST /api/led/power");
         LOG_INFO("  POST /api/led/brightness");
+        LOG_INFO("  POST /api/led/transition");
+        LOG_INFO("  GET  /api/led/color");
+        LOG_INFO("  POST /api/led/color");
+        LOG_INFO("  POST /api/led/count");
+        LOG_INFO("  GET  /api/led/outputs");
+        LOG_INFO("  POST /api/led/outputs");
+        LOG_INFO("  GET  /api/led/geometry");
+        LOG_INFO("  POST /api/led/geometry");
+        LOG_INFO("  GET  /api/led/segments");
+        LOG_INFO("  POST /api/led/segments");
+        LOG_INFO("  POST /api/led/segment");
+        LOG_INFO("  GET  /api/led/playlist");
+        LOG_INFO("  POST /api/led/playlist");
+        LOG_INFO("  GET  /api/led/stats");
     }
 
 private:
@@ -161,6 +263,10 @@ private:
             return;
         }
         
+        // A manual pick ends the playlist, also after reboot
+        if (LEDController::stopPlaylist()) {
+            NVSManager::savePlaylist("");
+        }
         LEDController::setEffect(effectId);
         
         // Save to NVS so effect persists after reboot
@@ -272,6 +378,375 @@ private:
         request->send(res);
     }
     
+    // POST /api/led/transition - {"duration": 800, "curve": "easeInOut"},
+    // either field may be omitted
+    static void handleTransition(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/transition");
+        
+        JsonObject jsonObj = json.as<JsonObject>();
+        uint16_t duration = LEDTransition::getDuration();
+        TransitionCurve curve = LEDTransition::getCurve();
+        
+        if (jsonObj.containsKey("duration")) {
+            if (!jsonObj["duration"].is<uint16_t>() || jsonObj["duration"].as<uint16_t>() > LED_TRANSITION_MAX_MS) {
+                sendError(request, 400, "Invalid duration");
+                return;
+            }
+            duration = jsonObj["duration"].as<uint16_t>();
+        }
+        if (jsonObj.containsKey("curve") && !LEDTransition::parseCurve(jsonObj["curve"], curve)) {
+            sendError(request, 400, "Invalid curve");
+            return;
+        }
+        
+        LEDController::setTransition(duration, curve);
+        NVSManager::saveTransition(duration, curve);
+        
+        StaticJsonDocument<128> doc;
+        doc["status"] = "ok";
+        doc["duration"] = duration;
+        doc["curve"] = LEDTransition::curveName(curve);
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // GET /api/led/color
+    static void handleGetColor(AsyncWebServerRequest *request) {
+        LOG_DEBUG("GET /api/led/color");
+        
+        StaticJsonDocument<256> doc;
+        LEDController::getColorJson(doc.to<JsonObject>());
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // POST /api/led/color - {"gamma": 2.2, "white": "#FFE0C0", "kelvin": 4000,
+    // "hue": 0, "saturation": 100}, any field may be omitted
+    static void handleSetColor(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/color");
+        
+        const char* error = LEDController::setColor(json.as<JsonObject>());
+        if (error != nullptr) {
+            sendError(request, 400, error);
+            return;
+        }
+        
+        StaticJsonDocument<256> doc;
+        LEDController::getColorJson(doc.to<JsonObject>());
+        
+        String colorJson;
+        serializeJson(doc, colorJson);
+        NVSManager::saveColor(colorJson);
+        
+        doc["status"] = "ok";
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // POST /api/led/count
+    static void handleLedCount(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/count");
+        
+        JsonObject jsonObj = json.as<JsonObject>();
+        
+        if (!jsonObj.containsKey("count")) {
+            sendError(request, 400, "Missing 'count' field");
+            return;
+        }
+        
+        uint32_t count = jsonObj["count"].as<uint32_t>();
+        if (count == 0 || count > ARGB_MAX_LEDS) {
+            sendError(request, 400, "Invalid LED count");
+            return;
+        }
+        
+        // Buffers are sized at boot, so the new length takes effect after reboot
+        NVSManager::saveLedCount(count);
+        
+        StaticJsonDocument<128> doc;
+        doc["status"] = "ok";
+        doc["count"] = count;
+        doc["rebootRequired"] = (count != LEDController::getNumLeds());
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // GET /api/led/outputs
+    static void handleGetOutputs(AsyncWebServerRequest *request) {
+        LOG_DEBUG("GET /api/led/outputs");
+        
+        StaticJsonDocument<1024> doc;
+        LEDOutput::getOutputsJson(doc);
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // POST /api/led/outputs - {"outputs": [{"start":0,"count":250,"reversed":false,"maxMa":3000}, ...]}
+    // An empty array restores the default even split.
+    static void handleSetOutputs(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/outputs");
+        
+        JsonObject jsonObj = json.as<JsonObject>();
+        
+        if (!jsonObj.containsKey("outputs")) {
+            sendError(request, 400, "Missing 'outputs' field");
+            return;
+        }
+        
+        String mapJson;
+        if (jsonObj["outputs"].size() > 0) {
+            OutputMapping outputs[LEDOutput::NUM_OUTPUT_PINS];
+            uint8_t count = 0;
+            if (!LEDOutput::parseMap(jsonObj["outputs"], outputs, count)) {
+                sendError(request, 400, "Invalid output map");
+                return;
+            }
+            serializeJson(jsonObj["outputs"], mapJson);
+        }
+        
+        // Output buffers are sized at boot, so the new map takes effect after reboot
+        NVSManager::saveOutputMap(mapJson);
+        
+        StaticJsonDocument<128> doc;
+        doc["status"] = "ok";
+        doc["rebootRequired"] = true;
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // GET /api/led/geometry
+    static void handleGetGeometry(AsyncWebServerRequest *request) {
+        LOG_DEBUG("GET /api/led/geometry");
+        
+        StaticJsonDocument<256> doc;
+        LEDController::getGeometryJson(LEDGeometry::getConfig(), doc.to<JsonObject>());
+        doc["mapped"] = LEDGeometry::isMapped();
+        doc["ledsPerTurn"] = LEDGeometry::getLedsPerTurn();
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // POST /api/led/geometry - {"type": "spiral", "turns": 12, "taper": 0.1,
+    // "height": 3, "wind": "cw", "topFirst": false}; omitted fields keep
+    // their current value
+    static void handleSetGeometry(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/geometry");
+        
+        GeometryConfig cfg = LEDGeometry::getConfig();
+        const char* error = LEDController::parseGeometry(json.as<JsonObject>(), cfg);
+        if (error != nullptr) {
+            sendError(request, 400, error);
+            return;
+        }
+        
+        StaticJsonDocument<256> doc;
+        LEDController::getGeometryJson(cfg, doc.to<JsonObject>());
+        
+        // Tables are built at boot, so the new layout takes effect after reboot
+        String geometryJson;
+        serializeJson(doc, geometryJson);
+        NVSManager::saveGeometry(geometryJson);
+        
+        doc["status"] = "ok";
+        doc["rebootRequired"] = true;
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // GET /api/led/segments
+    static void handleGetSegments(AsyncWebServerRequest *request) {
+        LOG_DEBUG("GET /api/led/segments");
+        
+        StaticJsonDocument<4096> doc;
+        LEDController::getSegmentsJson(doc);
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // GET /api/led/stats
+    static void handleGetStats(AsyncWebServerRequest *request) {
+        LOG_DEBUG("GET /api/led/stats");
+        
+        StaticJsonDocument<4096> doc;
+        LEDStats::getJson(doc);
+        
+        // Report first, then start a new measurement window
+        if (request->hasParam("reset") && request->getParam("reset")->value() == "1") {
+            LEDStats::requestReset();
+        }
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // POST /api/led/segments
+    static void handleSetSegments(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/segments");
+        
+        JsonObject jsonObj = json.as<JsonObject>();
+        
+        if (!jsonObj.containsKey("segments")) {
+            sendError(request, 400, "Missing 'segments' field");
+            return;
+        }
+        
+        const char* error = LEDController::setSegments(jsonObj["segments"].as<JsonArray>());
+        if (error != nullptr) {
+            sendError(request, 400, error);
+            return;
+        }
+        
+        sendSegments(request);
+    }
+    
+    // POST /api/led/segment
+    static void handleUpdateSegment(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/segment");
+        
+        JsonObject jsonObj = json.as<JsonObject>();
+        
+        if (!jsonObj.containsKey("id")) {
+            sendError(request, 400, "Missing 'id' field");
+            return;
+        }
+        
+        const char* error = LEDController::updateSegment(jsonObj);
+        if (error != nullptr) {
+            sendError(request, 400, error);
+            return;
+        }
+        
+        sendSegments(request);
+    }
+    
+    // GET /api/led/playlist
+    static void handleGetPlaylist(AsyncWebServerRequest *request) {
+        LOG_DEBUG("GET /api/led/playlist");
+        
+        StaticJsonDocument<4096> doc;
+        LEDController::getPlaylistJson(doc);
+        
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // POST /api/led/playlist - {"entries":[...], "loop":true}
+    static void handleSetPlaylist(AsyncWebServerRequest *request, JsonVariant &json) {
+        LOG_DEBUG("POST /api/led/playlist");
+        
+        JsonObject jsonObj = json.as<JsonObject>();
+        
+        if (!jsonObj.containsKey("entries")) {
+            sendError(request, 400, "Missing 'entries' field");
+            return;
+        }
+        
+        const char* error = LEDController::setPlaylist(jsonObj["entries"].as<JsonArray>(),
+                                                       jsonObj["loop"] | true);
+        if (error != nullptr) {
+            sendError(request, 400, error);
+            return;
+        }
+        
+        // Stored once here - steps themselves never touch NVS
+        StaticJsonDocument<4096> doc;
+        LEDController::getPlaylistJson(doc);
+        
+        String playlistJson;
+        if (doc["entries"].size() > 0) {
+            serializeJson(doc, playlistJson);
+        }
+        // Running, but would be lost on reboot - tell the client
+        if (doc.overflowed() || !NVSManager::savePlaylist(playlistJson)) {
+            sendError(request, 413, "Playlist too large to save");
+            return;
+        }
+        
+        doc["status"] = "ok";
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
+    // Persist the segment list to NVS and send it back as the response
+    static void sendSegments(AsyncWebServerRequest *request) {
+        StaticJsonDocument<4096> doc;
+        LEDController::getSegmentsJson(doc);
+        
+        String segmentsJson;
+        if (doc["segments"].size() > 0) {
+            serializeJson(doc, segmentsJson);
+        }
+        // Applied, but would be lost on reboot - tell the client
+        if (doc.overflowed() || !NVSManager::saveSegments(segmentsJson)) {
+            sendError(request, 413, "Segments too large to save");
+            return;
+        }
+        
+        doc["status"] = "ok";
+        String response;
+        serializeJson(doc, response);
+        
+        AsyncWebServerResponse *res = request->beginResponse(200, "application/json", response);
+        addCorsHeaders(res);
+        request->send(res);
+    }
+    
     // ========================================================================
     // Helpers
     // ========================================================================
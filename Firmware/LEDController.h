@@ -16,6 +16,16 @@
 // Include effect definitions (must come before Effects.h)
 #include "EffectDefs.h"
 #include "Effects.h"
+#include "EffectTable.h"
+#include "EffectInstance.h"
+#include "LEDOutput.h"
+#include "TileRenderer.h"
+#include "LEDSegments.h"
+#include "LEDStats.h"
+#include "LEDTransition.h"
+#include "LEDPlaylist.h"
+#include "ColorPipeline.h"
+#include "LEDGeometry.h"
 
 // ============================================================================
 // LEDController - FreeRTOS Task for LED Animations
@@ -23,37 +33,58 @@
 // Features:
 // - Runs on Core 0 (separate from WiFi on Core 1)
 // - Non-blocking effect rendering at ~60 FPS
+// - Per-pixel effects split across both cores on long strips (TileRenderer)
 // - Live parameter updates via setParam()
+// - Optional segments: independent effects on sub-ranges, layered with
+//   blend modes where they overlap (LEDSegments, Compositor)
+// - Frames handed to LEDOutput, which sends them while the next one renders
+// - Static scenes render once; the task then sleeps until something changes
+// - Effect changes crossfade with both effects animating (LEDTransition)
+// - Playlist: timed effect rotation on the task's own clock (LEDPlaylist)
+// - Output color correction in the copy to the driver (ColorPipeline)
+// - Current estimate and per-output power limits in the same copy (LEDPower)
+// - Tree layout behind the up/down/cw/ccw effect directions (LEDGeometry)
 // ============================================================================
 
 class LEDController {
 public:
-    // Effect definition
-    struct EffectEntry {
-        const char* name;
-        void (*func)();
-        uint8_t category;
-    };
-
     // Initialize LED controller and start FreeRTOS task
-    static bool begin() {
+    static bool begin(uint16_t ledCount = ARGB_NUM_LEDS, const String& outputMap = "",
+                      const String& geometry = "") {
         LOG_SECTION("Initializing LED Controller");
         
-        // Initialize FastLED
-        FastLED.addLeds<WS2812, ARGB_DATA_PIN, GRB>(leds, ARGB_NUM_LEDS)
-               .setCorrection(TypicalLEDStrip);
-        FastLED.setBrightness(brightness);
-        FastLED.setMaxPowerInMilliWatts(45000); // 45W max
+        // Allocate frame and effect state buffers for this strip length
+        if (!allocLeds(ledCount) || !mainEffect.init(NUM_LEDS)) {
+            LOG_ERROR("Failed to allocate LED buffers!");
+            return false;
+        }
+        if (!LEDTransition::begin() || !beginGeometry(geometry)) {
+            return false;
+        }
+        
+        // Initialize FastLED output (strip registration + show task)
+        if (!LEDOutput::begin(outputMap)) {
+            return false;
+        }
+        TileRenderer::begin();  // Falls back to single-core rendering on failure
+        if (!LEDKernels::begin()) {
+            LOG_WARN("PIE kernels disagree with the portable ones - disabled");
+        }
+        logKernels();
+        if (!LEDSegments::begin()) {
+            return false;
+        }
+        LEDOutput::setBrightness(brightness);
         
         // Clear LEDs
-        FastLED.clear();
-        FastLED.show();
+        clearLeds();
+        LEDOutput::present();
         
         // Init random seed
         random16_set_seed(esp_random());
         
-        LOG_PRINTF("INFO ", "LED Data Pin: GPIO%d", ARGB_DATA_PIN);
-        LOG_PRINTF("INFO ", "Number of LEDs: %d", ARGB_NUM_LEDS);
+        LOG_PRINTF("INFO ", "LED Data Pins: %d (first GPIO%d)", LEDOutput::NUM_OUTPUT_PINS, LEDOutput::outputPins[0]);
+        LOG_PRINTF("INFO ", "Number of LEDs: %d", NUM_LEDS);
         
         // Play startup animation (blocking - before FreeRTOS task starts)
         playStartupAnimation();
@@ -94,43 +125,108 @@ public:
             currentEffect = id;
             effectChanged = true;
             effectReady = true;  // Effect is now set, task can proceed
+            requestFrame();
             LOG_PRINTF("INFO ", "Effect changed to: %s", effects[id].name);
         }
     }
     
     static void setPower(bool on) {
-        powerOn = on;
-        if (!on) {
-            FastLED.clear();
-            FastLED.show();
-        }
+        powerOn = on;  // LED task blanks the strip on its next frame
+        requestFrame();
         LOG_PRINTF("INFO ", "LED Power: %s", on ? "ON" : "OFF");
     }
     
+    // Crossfade used on effect changes (0 ms = hard cut)
+    static void setTransition(uint16_t durationMs, TransitionCurve curve) {
+        LEDTransition::configure(durationMs, curve);
+        LOG_PRINTF("INFO ", "LED Transition: %d ms, %s", LEDTransition::getDuration(),
+                   LEDTransition::curveName(LEDTransition::getCurve()));
+    }
+    
     static void setBrightness(uint8_t b) {
         brightness = b;
-        FastLED.setBrightness(brightness);
+        LEDOutput::setBrightness(brightness);  // Same pixels, sent again
+        requestFrame();
         LOG_PRINTF("INFO ", "LED Brightness: %d", brightness);
     }
     
+    // Wake the LED task if it is sleeping on a static scene. Every setter
+    // that changes what is shown calls this.
+    static void requestFrame() {
+        if (ledTaskHandle != NULL) {
+            xTaskNotifyGive(ledTaskHandle);
+        }
+    }
+    
+    // Lay out the strip from the stored geometry (plain strip if unset/invalid)
+    static bool beginGeometry(const String& geometryJson) {
+        GeometryConfig cfg = GeometryConfig::defaults();
+        if (!geometryJson.isEmpty()) {
+            StaticJsonDocument<256> doc;
+            const char* err = deserializeJson(doc, geometryJson) ? "invalid JSON"
+                                                                 : parseGeometry(doc.as<JsonObject>(), cfg);
+            if (err != nullptr) {
+                LOG_PRINTF("WARN ", "Stored geometry not used: %s", err);
+                cfg = GeometryConfig::defaults();
+            }
+        }
+        
+        if (!LEDGeometry::begin(cfg)) {
+            LOG_ERROR("Failed to allocate LED geometry!");
+            return false;
+        }
+        if (LEDGeometry::isMapped()) {
+            LOG_PRINTF("INFO ", "LED geometry: spiral, %.1f turns, %d LEDs per turn",
+                       cfg.turns, LEDGeometry::getLedsPerTurn());
+        }
+        return true;
+    }
+    
+    // Log which pixel kernels run and what a full-strip fade costs with
+    // and without the vector unit (leds[] is cleared right after)
+    static void logKernels() {
+        if (!LEDKernels::isVector()) {
+            LOG_PRINTF("INFO ", "LED kernels: %s", LEDKernels::name());
+            return;
+        }
+        
+        uint32_t cycles[2];
+        for (uint8_t vector = 0; vector < 2; vector++) {
+            LEDKernels::setVector(vector);
+            uint32_t start = LEDStats::cycles();
+            for (uint8_t i = 0; i < 8; i++) {
+                fadeAll(32);
+            }
+            cycles[vector] = (LEDStats::cycles() - start) / 8;
+        }
+        LOG_PRINTF("INFO ", "LED kernels: %s - fade of %d LEDs: %lu cycles (portable %lu)",
+                   LEDKernels::name(), NUM_LEDS, (unsigned long)cycles[1], (unsigned long)cycles[0]);
+    }
+    
     // Play startup "build" animation - LEDs light up one by one, then crossfade to effect
     static void playStartupAnimation() {
         LOG_INFO("Playing startup animation...");
         
         // Clear all LEDs first
-        FastLED.clear();
-        FastLED.show();
+        clearLeds();
+        LEDOutput::present();
         
-        // Calculate delay per LED (aim for ~2 second total animation)
-        uint16_t delayPerLed = max(5, min(30, 2000 / ARGB_NUM_LEDS));
+        // Calculate delay per step (aim for ~2 second total animation).
+        // Long strips light several LEDs per step to stay within that.
+        uint16_t ledsPerStep = (NUM_LEDS + 99) / 100;
+        uint16_t steps = (NUM_LEDS + ledsPerStep - 1) / ledsPerStep;
+        uint16_t delayPerStep = max(5, min(30, 2000 / steps));
         
         // Build animation: light up each LED sequentially with rainbow
-        for (uint16_t i = 0; i < ARGB_NUM_LEDS; i++) {
+        for (uint16_t i = 0; i < NUM_LEDS; i++) {
             uint8_t hue = (i * 256 / 15) & 0xFF;  // Use default size=15
             leds[i] = CHSV(hue, 255, brightness);  // Use current brightness
-            FastLED.show();
-            delay(delayPerLed);
+            if ((i + 1) % ledsPerStep == 0 || i == NUM_LEDS - 1) {
+                LEDOutput::present();
+                delay(delayPerStep);
+            }
         }
+        LEDOutput::waitIdle();
         
         LOG_INFO("Startup animation complete - ready for effect");
         // Don't set any effect here - let setup() determine the right one
@@ -157,20 +253,35 @@ public:
         LOG_INFO("Effect parameters restored from NVS");
     }
     
-    // Set parameter from JSON key-value
+    // Set parameter from JSON key-value (current effect)
     static void setParam(const String& key, JsonVariant value) {
+        // Segments swap params through the same globals while rendering
+        LEDSegments::lock();
+        setParamFor(currentEffect, key, value);
+        // A playlist entry on the strip renders its own copy - show the edit
+        if (currentEffect == entryEffect) {
+            LEDSegments::withParams(entryEffect, entryParams, [&]() {
+                setParamFor(entryEffect, key, value);
+            });
+        }
+        LEDSegments::unlock();
+        requestFrame();
+    }
+    
+    // Set parameter of a given effect (params live in its global xxxParams struct)
+    static void setParamFor(uint8_t effectId, const String& key, JsonVariant value) {
         // Speed parameter
         if (key == "speed" && value.is<uint8_t>()) {
-            applySpeedParam(value.as<uint8_t>());
+            applySpeedParam(effectId, value.as<uint8_t>());
         }
         // Generic color parameter
         else if (key == "color" && value.is<const char*>()) {
             CRGB color = parseColor(value.as<const char*>());
-            applyColorParam(color);
+            applyColorParam(effectId, color);
         }
         // Intensity parameter
         else if (key == "intensity" && value.is<uint8_t>()) {
-            applyIntensityParam(value.as<uint8_t>());
+            applyIntensityParam(effectId, value.as<uint8_t>());
         }
         // Gradient colors
         else if (key == "colorStart" && value.is<const char*>()) {
@@ -186,8 +297,8 @@ public:
             gradientParams.threePoint = value.as<bool>();
         }
         else if (key == "style" && value.is<uint8_t>()) {
-            if (currentEffect == 1) gradientParams.style = (GradientStyle)value.as<uint8_t>();
-            else if (currentEffect == 40) policeLightsParams.style = (PoliceStyle)constrain(value.as<uint8_t>(), 0, 2);
+            if (effectId == 1) gradientParams.style = (GradientStyle)value.as<uint8_t>();
+            else if (effectId == 40) policeLightsParams.style = (PoliceStyle)constrain(value.as<uint8_t>(), 0, 2);
         }
         // Spots parameters
         else if (key == "spread" && value.is<uint8_t>()) {
@@ -205,9 +316,9 @@ public:
         }
         else if (key == "colorBg" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 3) patternParams.colorBg = c;  // Pattern effect
-            else if (currentEffect == 15) sparkleParams.colorBg = c;  // Sparkle
-            else if (currentEffect == 16) glitterParams.bgColor = c;  // Glitter
+            if (effectId == 3) patternParams.colorBg = c;  // Pattern effect
+            else if (effectId == 15) sparkleParams.colorBg = c;  // Sparkle
+            else if (effectId == 16) glitterParams.bgColor = c;  // Glitter
         }
         else if (key == "fgSize" && value.is<uint8_t>()) {
             patternParams.fgSize = value.as<uint8_t>();
@@ -218,65 +329,66 @@ public:
         // Color Wave, Scanner, and Running Lights parameters (color1-8)
         else if (key == "color1" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[0] = c;
-            else if (currentEffect == 9) scannerParams.colors[0] = c;
-            else if (currentEffect == 11) runningLightsParams.colors[0] = c;
-            else if (currentEffect == 26) christmasChaseParams.color1 = c;
-            else if (currentEffect == 40) policeLightsParams.color1 = c;
-            else if (currentEffect == 39) fadeParams.colors[0] = c;
+            if (effectId == 5) colorWaveParams.colors[0] = c;
+            else if (effectId == 9) scannerParams.colors[0] = c;
+            else if (effectId == 11) runningLightsParams.colors[0] = c;
+            else if (effectId == 26) christmasChaseParams.color1 = c;
+            else if (effectId == 40) policeLightsParams.color1 = c;
+            else if (effectId == 39) fadeParams.colors[0] = c;
         }
         else if (key == "color2" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[1] = c;
-            else if (currentEffect == 9) scannerParams.colors[1] = c;
-            else if (currentEffect == 11) runningLightsParams.colors[1] = c;
-            else if (currentEffect == 26) christmasChaseParams.color2 = c;
-            else if (currentEffect == 40) policeLightsParams.color2 = c;
-            else if (currentEffect == 39) fadeParams.colors[1] = c;
+            if (effectId == 5) colorWaveParams.colors[1] = c;
+            else if (effectId == 9) scannerParams.colors[1] = c;
+            else if (effectId == 11) runningLightsParams.colors[1] = c;
+            else if (effectId == 26) christmasChaseParams.color2 = c;
+            else if (effectId == 40) policeLightsParams.color2 = c;
+            else if (effectId == 39) fadeParams.colors[1] = c;
         }
         else if (key == "color3" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[2] = c;
-            else if (currentEffect == 9) scannerParams.colors[2] = c;
-            else if (currentEffect == 11) runningLightsParams.colors[2] = c;
-            else if (currentEffect == 39) fadeParams.colors[2] = c;
+            if (effectId == 5) colorWaveParams.colors[2] = c;
+            else if (effectId == 9) scannerParams.colors[2] = c;
+            else if (effectId == 11) runningLightsParams.colors[2] = c;
+            else if (effectId == 39) fadeParams.colors[2] = c;
         }
         else if (key == "color4" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[3] = c;
-            else if (currentEffect == 9) scannerParams.colors[3] = c;
-            else if (currentEffect == 11) runningLightsParams.colors[3] = c;
-            else if (currentEffect == 39) fadeParams.colors[3] = c;
+            if (effectId == 5) colorWaveParams.colors[3] = c;
+            else if (effectId == 9) scannerParams.colors[3] = c;
+            else if (effectId == 11) runningLightsParams.colors[3] = c;
+            else if (effectId == 39) fadeParams.colors[3] = c;
         }
         else if (key == "color5" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[4] = c;
-            else if (currentEffect == 9) scannerParams.colors[4] = c;
-            else if (currentEffect == 39) fadeParams.colors[4] = c;
+            if (effectId == 5) colorWaveParams.colors[4] = c;
+            else if (effectId == 9) scannerParams.colors[4] = c;
+            else if (effectId == 39) fadeParams.colors[4] = c;
         }
         else if (key == "color6" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[5] = c;
-            else if (currentEffect == 9) scannerParams.colors[5] = c;
-            else if (currentEffect == 39) fadeParams.colors[5] = c;
+            if (effectId == 5) colorWaveParams.colors[5] = c;
+            else if (effectId == 9) scannerParams.colors[5] = c;
+            else if (effectId == 39) fadeParams.colors[5] = c;
         }
         else if (key == "color7" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[6] = c;
-            else if (currentEffect == 9) scannerParams.colors[6] = c;
-            else if (currentEffect == 39) fadeParams.colors[6] = c;
+            if (effectId == 5) colorWaveParams.colors[6] = c;
+            else if (effectId == 9) scannerParams.colors[6] = c;
+            else if (effectId == 39) fadeParams.colors[6] = c;
         }
         else if (key == "color8" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 5) colorWaveParams.colors[7] = c;
-            else if (currentEffect == 9) scannerParams.colors[7] = c;
-            else if (currentEffect == 39) fadeParams.colors[7] = c;
+            if (effectId == 5) colorWaveParams.colors[7] = c;
+            else if (effectId == 9) scannerParams.colors[7] = c;
+            else if (effectId == 39) fadeParams.colors[7] = c;
         }
         else if (key == "direction" && value.is<uint8_t>()) {
-            Direction dir = (Direction)value.as<uint8_t>();
-            if (currentEffect == 5) colorWaveParams.direction = dir;
-            else if (currentEffect == 10) cometParams.direction = dir;
-            else if (currentEffect == 29) snowSparkleParams.direction = dir;
+            Direction dir = (Direction)min<uint8_t>(value.as<uint8_t>(), DIR_CCW);
+            if (effectId == 4) rainbowWaveParams.direction = dir;
+            else if (effectId == 5) colorWaveParams.direction = dir;
+            else if (effectId == 10) cometParams.direction = dir;
+            else if (effectId == 29) snowSparkleParams.direction = dir;
         }
         // Rainbow wave size
         else if (key == "size" && value.is<uint8_t>()) {
@@ -290,22 +402,22 @@ public:
             wavyParams.amplitude = value.as<uint8_t>();
         }
         else if (key == "frequency" && value.is<uint8_t>()) {
-            if (currentEffect == 7) wavyParams.frequency = value.as<uint8_t>();
-            else if (currentEffect == 34) lightningParams.frequency = value.as<uint8_t>();
-            else if (currentEffect == 41) strobeParams.frequency = value.as<uint8_t>();
+            if (effectId == 7) wavyParams.frequency = value.as<uint8_t>();
+            else if (effectId == 34) lightningParams.frequency = value.as<uint8_t>();
+            else if (effectId == 41) strobeParams.frequency = value.as<uint8_t>();
         }
         // Two-color effects
         else if (key == "colorPrimary" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 6) oscillateParams.colorPrimary = c;
-            else if (currentEffect == 12) androidParams.colorPrimary = c;
-            else if (currentEffect == 37) breatheParams.colorPrimary = c;
+            if (effectId == 6) oscillateParams.colorPrimary = c;
+            else if (effectId == 12) androidParams.colorPrimary = c;
+            else if (effectId == 37) breatheParams.colorPrimary = c;
         }
         else if (key == "colorSecondary" && value.is<const char*>()) {
             CRGB c = parseColor(value.as<const char*>());
-            if (currentEffect == 6) oscillateParams.colorSecondary = c;
-            else if (currentEffect == 12) androidParams.colorSecondary = c;
-            else if (currentEffect == 37) breatheParams.colorSecondary = c;
+            if (effectId == 6) oscillateParams.colorSecondary = c;
+            else if (effectId == 12) androidParams.colorSecondary = c;
+            else if (effectId == 37) breatheParams.colorSecondary = c;
         }
         else if (key == "pointSize" && value.is<uint8_t>()) {
             oscillateParams.pointSize = value.as<uint8_t>();
@@ -315,9 +427,9 @@ public:
             theaterChaseParams.gapSize = value.as<uint8_t>();
         }
         else if (key == "trailLength" && value.is<uint8_t>()) {
-            if (currentEffect == 9) scannerParams.trailLength = value.as<uint8_t>();
-            else if (currentEffect == 10) cometParams.trailLength = value.as<uint8_t>();
-            else if (currentEffect == 35) matrixParams.trailLength = constrain(value.as<uint8_t>(), 3, 30);
+            if (effectId == 9) scannerParams.trailLength = value.as<uint8_t>();
+            else if (effectId == 10) cometParams.trailLength = value.as<uint8_t>();
+            else if (effectId == 35) matrixParams.trailLength = constrain(value.as<uint8_t>(), 3, 30);
         }
         else if (key == "sparkleColor" && value.is<const char*>()) {
             cometParams.sparkleColor = parseColor(value.as<const char*>());
@@ -339,13 +451,13 @@ public:
             runningLightsParams.shape = (WaveShape)value.as<uint8_t>();
         }
         else if (key == "numColors" && value.is<uint8_t>()) {
-            if (currentEffect == 5) colorWaveParams.numColors = value.as<uint8_t>();
-            else if (currentEffect == 11) runningLightsParams.numColors = value.as<uint8_t>();
-            else if (currentEffect == 39) fadeParams.numColors = constrain(value.as<uint8_t>(), 2, 8);
+            if (effectId == 5) colorWaveParams.numColors = value.as<uint8_t>();
+            else if (effectId == 11) runningLightsParams.numColors = value.as<uint8_t>();
+            else if (effectId == 39) fadeParams.numColors = constrain(value.as<uint8_t>(), 2, 8);
         }
         else if (key == "dualMode" && value.is<bool>()) {
-            if (currentEffect == 9) scannerParams.dualMode = value.as<bool>();
-            else if (currentEffect == 11) runningLightsParams.dualMode = value.as<bool>();
+            if (effectId == 9) scannerParams.dualMode = value.as<bool>();
+            else if (effectId == 11) runningLightsParams.dualMode = value.as<bool>();
         }
         else if (key == "sectionWidth" && value.is<uint8_t>()) {
             androidParams.sectionWidth = value.as<uint8_t>();
@@ -353,24 +465,25 @@ public:
         // Palette (for Twinkle, TwinkleFox, Fire, etc.)
         else if (key == "palette") {
             int p = value.as<int>();
-            if (currentEffect == 7) wavyParams.palette = (PaletteType)p;
-            else if (currentEffect == 13) twinkleParams.palette = (PaletteType)p;
-            else if (currentEffect == 14) twinkleFoxParams.palette = (PaletteType)p;
-            else if (currentEffect == 18) fireParams.palette = (PaletteType)p;
-            else if (currentEffect == 22) auroraParams.palette = (PaletteType)p;
-            else if (currentEffect == 23) pacificaParams.palette = (PaletteType)p;
-            else if (currentEffect == 24) lakeParams.palette = (PaletteType)p;
-            else if (currentEffect == 25) fairyParams.palette = (PaletteType)p;
-            else if (currentEffect == 30) bouncingBallsParams.palette = (PaletteType)p;
-            else if (currentEffect == 31) popcornParams.palette = (PaletteType)p;
+            PaletteCache::prepare((PaletteType)p);  // Expand now, not in the next frame
+            if (effectId == 7) wavyParams.palette = (PaletteType)p;
+            else if (effectId == 13) twinkleParams.palette = (PaletteType)p;
+            else if (effectId == 14) twinkleFoxParams.palette = (PaletteType)p;
+            else if (effectId == 18) fireParams.palette = (PaletteType)p;
+            else if (effectId == 22) auroraParams.palette = (PaletteType)p;
+            else if (effectId == 23) pacificaParams.palette = (PaletteType)p;
+            else if (effectId == 24) lakeParams.palette = (PaletteType)p;
+            else if (effectId == 25) fairyParams.palette = (PaletteType)p;
+            else if (effectId == 30) bouncingBallsParams.palette = (PaletteType)p;
+            else if (effectId == 31) popcornParams.palette = (PaletteType)p;
         }
         else if (key == "fadeSpeed" && value.is<uint8_t>()) {
             twinkleParams.fadeSpeed = value.as<uint8_t>();
         }
         else if (key == "colorMode") {
-            if (currentEffect == 13) {
+            if (effectId == 13) {
                 twinkleParams.colorMode = (TwinkleMode)value.as<int>();
-            } else if (currentEffect == 25) {
+            } else if (effectId == 25) {
                 fairyParams.colorMode = (FairyMode)value.as<uint8_t>();
             }
         }
@@ -385,12 +498,12 @@ public:
             sparkleParams.colorSpark = parseColor(value.as<const char*>());
         }
         else if (key == "overlay" && value.is<bool>()) {
-            if (currentEffect == 15) sparkleParams.overlay = value.as<bool>();
-            else if (currentEffect == 16) glitterParams.overlay = value.as<bool>();
-            else if (currentEffect == 27) halloweenEyesParams.overlay = value.as<bool>();
-            else if (currentEffect == 28) fireworksParams.overlay = value.as<bool>();
-            else if (currentEffect == 32) dripParams.overlay = value.as<bool>();
-            else if (currentEffect == 34) lightningParams.overlay = value.as<bool>();
+            if (effectId == 15) sparkleParams.overlay = value.as<bool>();
+            else if (effectId == 16) glitterParams.overlay = value.as<bool>();
+            else if (effectId == 27) halloweenEyesParams.overlay = value.as<bool>();
+            else if (effectId == 28) fireworksParams.overlay = value.as<bool>();
+            else if (effectId == 32) dripParams.overlay = value.as<bool>();
+            else if (effectId == 34) lightningParams.overlay = value.as<bool>();
         }
         else if (key == "darkMode" && value.is<bool>()) {
             sparkleParams.darkMode = value.as<bool>();
@@ -401,8 +514,8 @@ public:
         }
         // Starry Night specific
         else if (key == "density" && value.is<uint8_t>()) {
-            if (currentEffect == 17) starryNightParams.density = value.as<uint8_t>();
-            else if (currentEffect == 29) snowSparkleParams.density = value.as<uint8_t>();
+            if (effectId == 17) starryNightParams.density = value.as<uint8_t>();
+            else if (effectId == 29) snowSparkleParams.density = value.as<uint8_t>();
         }
         else if (key == "colorStars" && value.is<const char*>()) {
             starryNightParams.colorStars = parseColor(value.as<const char*>());
@@ -457,9 +570,9 @@ public:
             fireworksParams.fragments = value.as<uint8_t>();
         }
         else if (key == "gravity" && value.is<uint8_t>()) {
-            if (currentEffect == 28) fireworksParams.gravity = value.as<uint8_t>();
-            else if (currentEffect == 30) bouncingBallsParams.gravity = value.as<uint8_t>();
-            else if (currentEffect == 32) dripParams.gravity = value.as<uint8_t>();
+            if (effectId == 28) fireworksParams.gravity = value.as<uint8_t>();
+            else if (effectId == 30) bouncingBallsParams.gravity = value.as<uint8_t>();
+            else if (effectId == 32) dripParams.gravity = value.as<uint8_t>();
         }
         // BouncingBalls specific (effect 30)
         else if (key == "numBalls" && value.is<uint8_t>()) {
@@ -517,6 +630,7 @@ public:
     static uint8_t getBrightness() { return brightness; }
     static const char* getEffectName() { return effects[currentEffect].name; }
     static uint8_t getNumEffects() { return NUM_EFFECTS; }
+    static uint16_t getNumLeds() { return NUM_LEDS; }
     
     // Get current effect params as JSON
     static void getStatusJson(JsonDocument& doc) {
@@ -526,6 +640,13 @@ public:
         doc["effectName"] = effects[currentEffect].name;
         doc["category"] = effects[currentEffect].category;
         doc["numEffects"] = NUM_EFFECTS;
+        doc["numLeds"] = NUM_LEDS;
+        doc["fps"] = 1000 / framePeriodMs;
+        doc["playlist"] = LEDPlaylist::isRunning();
+        JsonObject transition = doc["transition"].to<JsonObject>();
+        transition["duration"] = LEDTransition::getDuration();
+        transition["curve"] = LEDTransition::curveName(LEDTransition::getCurve());
+        LEDPower::getStatusJson(doc["draw"].to<JsonObject>());
     }
     
     // Get all effects list as JSON
@@ -541,14 +662,19 @@ public:
     
     // Get parameters for current effect
     static void getParamsJson(JsonDocument& doc) {
-        // Return current effect's parameters
+        // Return current effect's parameters (the user's - the LED task
+        // swaps a playlist entry's in while it renders, under the lock)
+        LEDSegments::lock();
         doc["effect"] = currentEffect;
-        
-        JsonObject params = doc["params"].to<JsonObject>();
-        
-        // Add params based on current effect
+        writeParamsJson(currentEffect, doc["params"].to<JsonObject>());
+        LEDSegments::unlock();
+    }
+    
+    // Write parameters of a given effect into a JSON object
+    static void writeParamsJson(uint8_t effectId, JsonObject params) {
+        // Add params based on effect
         // This is a simplified version - full implementation would map all params
-        switch (currentEffect) {
+        switch (effectId) {
             case 0: // Solid
                 params["color"] = colorToHex(solidParams.color);
                 break;
@@ -575,6 +701,7 @@ public:
                 params["speed"] = rainbowWaveParams.speed;
                 params["size"] = rainbowWaveParams.size;
                 params["saturation"] = rainbowWaveParams.saturation;
+                params["direction"] = rainbowWaveParams.direction;
                 break;
             case 5: // Color Wave
                 params["color1"] = colorToHex(colorWaveParams.colors[0]);
@@ -824,6 +951,401 @@ public:
         }
     }
 
+    // ========================================================================
+    // Segments
+    // ========================================================================
+    
+    // Get segment list as JSON
+    static void getSegmentsJson(JsonDocument& doc) {
+        JsonArray arr = doc["segments"].to<JsonArray>();
+        
+        LEDSegments::lock();
+        for (uint8_t i = 0; i < LEDSegments::count(); i++) {
+            Segment& seg = LEDSegments::get(i);
+            JsonObject obj = arr.add<JsonObject>();
+            obj["id"] = i;
+            obj["start"] = seg.start;
+            obj["length"] = seg.length;
+            obj["effect"] = seg.effect;
+            obj["effectName"] = effects[seg.effect].name;
+            obj["brightness"] = seg.brightness;
+            obj["fpsDivider"] = seg.fpsDivider;
+            obj["blend"] = Compositor::modeName(seg.blend);
+            JsonObject params = obj["params"].to<JsonObject>();
+            LEDSegments::withParams(seg, [&]() {
+                writeParamsJson(seg.effect, params);
+            });
+        }
+        LEDSegments::unlock();
+    }
+    
+    // Replace all segments: [{"start":0,"length":50,"effect":4,"brightness":255,
+    // "fpsDivider":1,"blend":"normal","params":{...}}, ...]. Segments are
+    // layers, first = bottom, and may overlap. An empty list returns the whole
+    // strip to the current effect. Returns an error message or nullptr.
+    static const char* setSegments(JsonArray arr) {
+        if (arr.size() > LED_MAX_SEGMENTS) {
+            return "Too many segments";
+        }
+        for (JsonObject obj : arr) {
+            uint32_t start = obj["start"] | 0;
+            uint32_t length = obj["length"] | 0;
+            uint8_t effect = obj["effect"] | 0;
+            if (length == 0 || start + length > NUM_LEDS) {
+                return "Segment out of range";
+            }
+            if (effect >= NUM_EFFECTS) {
+                return "Invalid effect ID";
+            }
+            BlendMode blend;
+            if (obj.containsKey("blend") && !Compositor::parseMode(obj["blend"], blend)) {
+                return "Invalid blend mode";
+            }
+        }
+        
+        LEDSegments::lock();
+        LEDSegments::clear();
+        for (JsonObject obj : arr) {
+            BlendMode blend = BLEND_NORMAL;
+            Compositor::parseMode(obj["blend"], blend);
+            if (!LEDSegments::add(obj["start"] | 0, obj["length"] | 0, obj["effect"] | 0,
+                                  obj["brightness"] | 255, obj["fpsDivider"] | 1, blend)) {
+                LEDSegments::clear();
+                LEDSegments::unlock();
+                return "Failed to allocate segment";
+            }
+            applySegmentParams(LEDSegments::get(LEDSegments::count() - 1), obj["params"]);
+        }
+        LEDSegments::unlock();
+        
+        if (!arr.isNull() && arr.size() > 0) {
+            effectReady = true;
+        }
+        requestFrame();
+        LOG_PRINTF("INFO ", "Segments: %d", LEDSegments::count());
+        return nullptr;
+    }
+    
+    // Update one segment: {"id":0, "effect":5, "brightness":128, "fpsDivider":2,
+    // "blend":"add", "params":{...}} - all fields except id are optional
+    static const char* updateSegment(JsonObject obj) {
+        uint8_t id = obj["id"] | 0xFF;
+        
+        LEDSegments::lock();
+        if (id >= LEDSegments::count()) {
+            LEDSegments::unlock();
+            return "Invalid segment ID";
+        }
+        
+        Segment& seg = LEDSegments::get(id);
+        if (obj.containsKey("effect")) {
+            uint8_t effect = obj["effect"].as<uint8_t>();
+            if (effect >= NUM_EFFECTS) {
+                LEDSegments::unlock();
+                return "Invalid effect ID";
+            }
+            if (effect != seg.effect) {
+                LEDSegments::setEffect(seg, effect);
+            }
+        }
+        if (obj.containsKey("brightness")) {
+            seg.brightness = obj["brightness"].as<uint8_t>();
+        }
+        if (obj.containsKey("fpsDivider")) {
+            seg.fpsDivider = max((uint8_t)1, obj["fpsDivider"].as<uint8_t>());
+        }
+        if (obj.containsKey("blend")) {
+            BlendMode blend;
+            if (!Compositor::parseMode(obj["blend"], blend)) {
+                LEDSegments::unlock();
+                return "Invalid blend mode";
+            }
+            seg.blend = blend;
+        }
+        applySegmentParams(seg, obj["params"]);
+        LEDSegments::unlock();
+        requestFrame();
+        
+        return nullptr;
+    }
+    
+    // Restore segments from NVS (output of getSegmentsJson)
+    static void loadSegmentsFromJson(const String& jsonStr) {
+        if (jsonStr.isEmpty()) return;
+        
+        StaticJsonDocument<4096> doc;
+        DeserializationError error = deserializeJson(doc, jsonStr);
+        
+        if (error) {
+            LOG_PRINTF("WARN ", "Failed to parse segments JSON: %s", error.c_str());
+            return;
+        }
+        
+        const char* err = setSegments(doc["segments"].as<JsonArray>());
+        if (err != nullptr) {
+            LOG_PRINTF("WARN ", "Stored segments not restored: %s", err);
+            return;
+        }
+        
+        LOG_INFO("Segments restored from NVS");
+    }
+    
+    // ========================================================================
+    // Playlist
+    // ========================================================================
+    
+    // Get the playlist as JSON (also the format stored in NVS)
+    static void getPlaylistJson(JsonDocument& doc) {
+        LEDSegments::lock();
+        doc["running"] = LEDPlaylist::isRunning();
+        doc["loop"] = LEDPlaylist::isLooping();
+        doc["index"] = LEDPlaylist::currentIndex();
+        JsonArray arr = doc["entries"].to<JsonArray>();
+        for (uint8_t i = 0; i < LEDPlaylist::count(); i++) {
+            PlaylistEntry& entry = LEDPlaylist::get(i);
+            JsonObject obj = arr.add<JsonObject>();
+            obj["effect"] = entry.effect;
+            obj["effectName"] = effects[entry.effect].name;
+            obj["duration"] = entry.durationMs;
+            obj["transition"] = entry.transitionMs;
+            obj["curve"] = LEDTransition::curveName(entry.curve);
+            JsonObject params = obj["params"].to<JsonObject>();
+            LEDSegments::withParams(entry.effect, entry.params, [&]() {
+                writeParamsJson(entry.effect, params);
+            });
+        }
+        LEDSegments::unlock();
+    }
+    
+    // Replace the playlist and start it: [{"effect":4,"duration":30000,
+    // "transition":1000,"curve":"easeInOut","params":{...}}, ...].
+    // transition/curve default to the current transition setting, params to
+    // the effect's current params. An empty list stops the playlist.
+    // Returns an error message or nullptr.
+    static const char* setPlaylist(JsonArray arr, bool loop) {
+        if (arr.size() > LED_MAX_PLAYLIST) {
+            return "Too many playlist entries";
+        }
+        for (JsonObject obj : arr) {
+            uint8_t effect = obj["effect"] | 0xFF;
+            uint32_t duration = obj["duration"] | 0;
+            uint32_t transition = obj["transition"] | 0;
+            if (effect >= NUM_EFFECTS) {
+                return "Invalid effect ID";
+            }
+            if (duration < LED_PLAYLIST_MIN_MS) {
+                return "Invalid duration";
+            }
+            if (transition > LED_TRANSITION_MAX_MS) {
+                return "Invalid transition";
+            }
+            TransitionCurve curve;
+            if (obj.containsKey("curve") && !LEDTransition::parseCurve(obj["curve"], curve)) {
+                return "Invalid curve";
+            }
+        }
+        
+        LEDSegments::lock();
+        LEDPlaylist::clear();
+        for (JsonObject obj : arr) {
+            TransitionCurve curve = LEDTransition::getCurve();
+            LEDTransition::parseCurve(obj["curve"], curve);
+            PlaylistEntry* entry = LEDPlaylist::add(obj["effect"] | 0, obj["duration"] | 0,
+                                                    obj["transition"] | LEDTransition::getDuration(), curve);
+            JsonObject params = obj["params"].as<JsonObject>();
+            if (!params.isNull()) {
+                LEDSegments::withParams(entry->effect, entry->params, [&]() {
+                    for (JsonPair kv : params) {
+                        setParamFor(entry->effect, kv.key().c_str(), kv.value());
+                    }
+                });
+            }
+        }
+        LEDPlaylist::start(loop);
+        if (!LEDPlaylist::isRunning()) {
+            releaseEntryParams();
+        }
+        LEDSegments::unlock();
+        
+        if (LEDPlaylist::isRunning()) {
+            effectReady = true;
+        }
+        requestFrame();
+        LOG_PRINTF("INFO ", "Playlist: %d entries%s", LEDPlaylist::count(), loop ? " (loop)" : "");
+        return nullptr;
+    }
+    
+    // Stop the playlist. The effect it left on the strip fades over to the
+    // user's own params. Returns true if it was running.
+    static bool stopPlaylist() {
+        LEDSegments::lock();
+        bool wasRunning = LEDPlaylist::isRunning();
+        LEDPlaylist::stop();
+        releaseEntryParams();
+        LEDSegments::unlock();
+        if (wasRunning) {
+            LOG_INFO("Playlist stopped");
+        }
+        return wasRunning;
+    }
+    
+    // Restore the playlist from NVS (output of getPlaylistJson)
+    static void loadPlaylistFromJson(const String& jsonStr) {
+        if (jsonStr.isEmpty()) return;
+        
+        StaticJsonDocument<4096> doc;
+        DeserializationError error = deserializeJson(doc, jsonStr);
+        
+        if (error) {
+            LOG_PRINTF("WARN ", "Failed to parse playlist JSON: %s", error.c_str());
+            return;
+        }
+        
+        const char* err = setPlaylist(doc["entries"].as<JsonArray>(), doc["loop"] | true);
+        if (err != nullptr) {
+            LOG_PRINTF("WARN ", "Stored playlist not restored: %s", err);
+            return;
+        }
+        
+        LOG_INFO("Playlist restored from NVS");
+    }
+
+    // ========================================================================
+    // Color Correction
+    // ========================================================================
+    
+    // Get the output color settings as JSON (also the format stored in NVS)
+    static void getColorJson(JsonObject obj) {
+        const ColorConfig& cfg = ColorPipeline::getConfig();
+        JsonArray gamma = obj["gamma"].to<JsonArray>();
+        for (uint8_t ch = 0; ch < 3; ch++) {
+            gamma.add(roundf(cfg.gamma[ch] * 100) / 100);
+        }
+        obj["white"] = colorToHex(cfg.white);
+        obj["kelvin"] = cfg.kelvin;
+        obj["hue"] = cfg.hue;
+        obj["saturation"] = cfg.saturation;
+    }
+    
+    // Change output color settings: {"gamma":2.2 or [r,g,b],"white":"#FFE0C0",
+    // "kelvin":4000,"hue":0,"saturation":100}. Omitted fields keep their
+    // value. Returns an error message or nullptr.
+    static const char* setColor(JsonObject obj) {
+        ColorConfig cfg = ColorPipeline::getConfig();
+        
+        JsonVariant gamma = obj["gamma"];
+        if (gamma.is<JsonArray>()) {
+            if (gamma.size() != 3) return "Invalid gamma";
+            for (uint8_t ch = 0; ch < 3; ch++) {
+                cfg.gamma[ch] = gamma[ch] | 0.0f;
+            }
+        } else if (!gamma.isNull()) {
+            cfg.gamma[0] = cfg.gamma[1] = cfg.gamma[2] = gamma | 0.0f;
+        }
+        for (uint8_t ch = 0; ch < 3; ch++) {
+            if (!(cfg.gamma[ch] >= LED_COLOR_GAMMA_MIN && cfg.gamma[ch] <= LED_COLOR_GAMMA_MAX)) {
+                return "Invalid gamma";
+            }
+        }
+        
+        if (obj.containsKey("white")) {
+            if (!obj["white"].is<const char*>()) return "Invalid white point";
+            cfg.white = parseColor(obj["white"]);
+        }
+        if (obj.containsKey("kelvin")) {
+            uint32_t kelvin = obj["kelvin"] | 0;
+            if (kelvin < LED_COLOR_KELVIN_MIN || kelvin > LED_COLOR_KELVIN_MAX) return "Invalid kelvin";
+            cfg.kelvin = kelvin;
+        }
+        if (obj.containsKey("hue")) {
+            if (!obj["hue"].is<uint8_t>()) return "Invalid hue";
+            cfg.hue = obj["hue"];
+        }
+        if (obj.containsKey("saturation")) {
+            uint32_t saturation = obj["saturation"] | 0xFFFF;
+            if (saturation > 200) return "Invalid saturation";
+            cfg.saturation = saturation;
+        }
+        
+        ColorPipeline::configure(cfg);
+        LEDOutput::invalidate();  // Same pixels, corrected differently
+        requestFrame();
+        LOG_PRINTF("INFO ", "LED Color: gamma %.2f/%.2f/%.2f, white %s, %dK, hue %d, sat %d%%",
+                   cfg.gamma[0], cfg.gamma[1], cfg.gamma[2], colorToHex(cfg.white).c_str(),
+                   cfg.kelvin, cfg.hue, cfg.saturation);
+        return nullptr;
+    }
+    
+    // ========================================================================
+    // Tree Geometry
+    // ========================================================================
+    
+    // Validate a geometry object; omitted fields keep their value in cfg.
+    // Returns an error message, or nullptr.
+    static const char* parseGeometry(JsonObject obj, GeometryConfig& cfg) {
+        if (obj.containsKey("type")) {
+            const char* type = obj["type"] | "";
+            if (!strcmp(type, "strip")) cfg.type = GEOMETRY_STRIP;
+            else if (!strcmp(type, "spiral")) cfg.type = GEOMETRY_SPIRAL;
+            else return "Invalid type";
+        }
+        if (obj.containsKey("turns")) {
+            float turns = obj["turns"] | 0.0f;
+            if (!(turns >= 0.5f && turns <= 200.0f)) return "Invalid turns";
+            cfg.turns = turns;
+        }
+        if (obj.containsKey("taper")) {
+            float taper = obj["taper"] | -1.0f;
+            if (!(taper >= 0.0f && taper <= 1.0f)) return "Invalid taper";
+            cfg.taper = taper;
+        }
+        if (obj.containsKey("height")) {
+            float height = obj["height"] | 0.0f;
+            if (!(height >= 0.1f && height <= 50.0f)) return "Invalid height";
+            cfg.height = height;
+        }
+        if (obj.containsKey("wind")) {
+            const char* wind = obj["wind"] | "";
+            if (!strcmp(wind, "cw")) cfg.ccw = false;
+            else if (!strcmp(wind, "ccw")) cfg.ccw = true;
+            else return "Invalid wind";
+        }
+        if (obj.containsKey("topFirst")) {
+            cfg.topFirst = obj["topFirst"] | false;
+        }
+        return nullptr;
+    }
+    
+    static void getGeometryJson(const GeometryConfig& cfg, JsonObject obj) {
+        obj["type"] = cfg.type == GEOMETRY_SPIRAL ? "spiral" : "strip";
+        obj["turns"] = cfg.turns;
+        obj["taper"] = cfg.taper;
+        obj["height"] = cfg.height;
+        obj["wind"] = cfg.ccw ? "ccw" : "cw";
+        obj["topFirst"] = cfg.topFirst;
+    }
+    
+    // Restore color settings from NVS (output of getColorJson)
+    static void loadColorFromJson(const String& jsonStr) {
+        if (jsonStr.isEmpty()) return;
+        
+        StaticJsonDocument<256> doc;
+        DeserializationError error = deserializeJson(doc, jsonStr);
+        
+        if (error) {
+            LOG_PRINTF("WARN ", "Failed to parse color JSON: %s", error.c_str());
+            return;
+        }
+        
+        const char* err = setColor(doc.as<JsonObject>());
+        if (err != nullptr) {
+            LOG_PRINTF("WARN ", "Stored color settings not restored: %s", err);
+            return;
+        }
+        
+        LOG_INFO("Color settings restored from NVS");
+    }
+
 private:
     static TaskHandle_t ledTaskHandle;
     static uint8_t currentEffect;
@@ -833,65 +1355,177 @@ private:
     static bool effectReady;  // True after first setEffect() call
     static uint32_t frameCounter;
     static uint32_t lastFrameTime;
+    static uint32_t framePeriodMs;
+    static uint8_t shownEffect;  // Effect on the strip (transition source)
+    static bool playlistStep;    // Effect change came from the playlist...
+    static uint16_t stepTransitionMs;  // ...and fades with its entry's transition
+    static TransitionCurve stepCurve;
+    static EffectInstance mainEffect;  // State of the whole-strip effect
+    static uint8_t entryEffect;        // Effect rendering a playlist entry's params...
+    static uint8_t entryParams[maxEffectParamsSize()];  // ...from this copy
     
     // Effect function array
-    static const EffectEntry effects[];
+    static const EffectEntry* const effects;
     static const uint8_t NUM_EFFECTS;
     
+    // Hand the strip back to the user's params if it still shows a playlist
+    // entry's (lock held) - the LED task fades over as on an effect change
+    static void releaseEntryParams() {
+        if (entryEffect != LEDTransition::NO_EFFECT) {
+            effectChanged = true;
+            requestFrame();
+        }
+    }
+    
+    // Params the whole-strip effect renders with: the playlist entry's copy
+    // while one is playing it, otherwise the effect's globals
+    static uint8_t* paramsFor(uint8_t effectId) {
+        return effectId == entryEffect ? entryParams : (uint8_t*)effects[effectId].params;
+    }
+    
     // ========================================================================
     // FreeRTOS Task
     // ========================================================================
     
     static void ledTask(void* params) {
-        const TickType_t frameDelay = pdMS_TO_TICKS(1000 / LED_TARGET_FPS);
+        // A frame can't be shorter than its wire time - long strips run at a
+        // lower rate, effects keep their speed through effectTime
+        framePeriodMs = max<uint32_t>(1000 / LED_TARGET_FPS, (LEDOutput::wireTimeUs() + 999) / 1000);
+        const TickType_t frameDelay = pdMS_TO_TICKS(framePeriodMs);
         TickType_t lastWakeTime = xTaskGetTickCount();
+        resetEffectTime(millis());
+        LEDStats::begin(framePeriodMs);
         
-        // Crossfade state for smooth startup transition
-        static bool firstRun = true;
-        static uint16_t crossfadeProgress = 256;  // Start at 256 = no crossfade active
-        static CRGB previousLeds[ARGB_NUM_LEDS];
+        bool blanked = false;
         
-        LOG_INFO("LED Task started on Core 0");
+        LOG_PRINTF("INFO ", "LED Task started on Core 0 (%lu FPS)", (unsigned long)(1000 / framePeriodMs));
         
         while (true) {
-            if (powerOn && effectReady) {
-                // Handle effect change or first run
+            // Changes made before this point are picked up by this frame;
+            // later ones leave a notification that keeps the task awake
+            ulTaskNotifyTake(pdTRUE, 0);
+            bool idle = true;
+            LEDStats::service();
+            
+            if (!powerOn) {
+                // Push one black frame, then stay idle until power returns
+                if (!blanked) {
+                    clearLeds();
+                    LEDOutput::present();
+                    blanked = true;
+                }
+            }
+            else if (effectReady) {
+                blanked = false;
+                uint32_t frameStart = LEDStats::cycles();
+                advanceEffectTime(millis());
+                
+                // Params are swapped through the effects' global structs
+                // (segments, playlist entries) - hold the lock from the
+                // playlist step through the render
+                LEDSegments::lock();
+                
+                // Playlist step due: switch to the entry's effect
+                const PlaylistEntry* step = nullptr;
+                if (LEDPlaylist::isRunning()) {
+                    step = LEDPlaylist::due(effectTime.now);
+                    if (step != nullptr) {
+                        currentEffect = step->effect;
+                        stepTransitionMs = step->transitionMs;
+                        stepCurve = step->curve;
+                        playlistStep = true;
+                        effectChanged = true;
+                    }
+                }
+                
+                // Handle effect change or first run. The first effect fades
+                // in over the startup animation; segments always cut. The
+                // outgoing effect keeps the params it rendered with; the
+                // new one renders from the step's copy, or from the globals
+                // when the change is not a playlist step.
                 if (effectChanged) {
-                    if (firstRun) {
-                        // Save current LED state for crossfade
-                        memcpy(previousLeds, leds, sizeof(leds));
-                        crossfadeProgress = 0;  // Start crossfade
-                        firstRun = false;
-                    } else {
-                        // Normal effect change - clear LEDs
-                        FastLED.clear();
+                    const uint8_t* shownParams = shownEffect < NUM_EFFECTS ? paramsFor(shownEffect) : nullptr;
+                    bool fading = !LEDSegments::isActive() &&
+                        (playlistStep ? LEDTransition::start(shownEffect, shownParams, mainEffect,
+                                                             stepTransitionMs, stepCurve)
+                                      : LEDTransition::start(shownEffect, shownParams, mainEffect));
+                    if (!fading) {
+                        clearLeds();
+                    }
+                    entryEffect = LEDTransition::NO_EFFECT;
+                    if (step != nullptr) {
+                        memcpy(entryParams, step->params, effects[step->effect].paramsSize);
+                        entryEffect = step->effect;
                     }
+                    playlistStep = false;
+                    mainEffect.reset(currentEffect);
                     frameCounter = 0;
                     effectChanged = false;
                 }
                 
-                // Execute current effect into leds[]
-                if (currentEffect < NUM_EFFECTS) {
-                    effects[currentEffect].func();
+                // Execute current effect into leds[] (tiled across cores if supported)
+                uint32_t stageStart = LEDStats::cycles();
+                if (LEDSegments::isActive()) {
+                    LEDSegments::renderFrame(frameCounter);
+                    idle = LEDSegments::isStatic();
                 }
-                
-                // Apply crossfade if in progress (0-255)
-                if (crossfadeProgress < 256) {
-                    uint8_t blendAmount = (crossfadeProgress > 255) ? 255 : crossfadeProgress;
-                    for (uint16_t i = 0; i < ARGB_NUM_LEDS; i++) {
-                        leds[i] = blend(previousLeds[i], leds[i], blendAmount);
+                else if (currentEffect < NUM_EFFECTS) {
+                    auto renderMain = [&]() {
+                        if (LEDTransition::isActive()) {
+                            // Both effects render, then blend into leds[]
+                            LEDTransition::render(currentEffect, mainEffect);
+                            idle = false;
+                        } else {
+                            mainEffect.bind();
+                            TileRenderer::render(effects[currentEffect]);
+                            LEDStats::recordEffect(currentEffect, stageStart);
+                            idle = isStaticEffect(currentEffect);
+                        }
+                    };
+                    if (currentEffect == entryEffect) {
+                        LEDSegments::withParams(entryEffect, entryParams, renderMain);
+                    } else {
+                        renderMain();
                     }
-                    crossfadeProgress += 8;  // ~30 frames = 500ms crossfade
+                    shownEffect = currentEffect;
                 }
+                LEDSegments::unlock();
+                LEDStats::record(LEDStats::STAGE_RENDER, stageStart);
+                
+                // Hand frame to the show task (returns while it is being sent;
+                // skipped when the frame is the one already on the strip)
+                stageStart = LEDStats::cycles();
+                bool shown = LEDOutput::present();
+                LEDStats::record(LEDStats::STAGE_PRESENT, stageStart);
                 
-                // Show LEDs
-                FastLED.show();
+                // A static scene between output levels still needs frames
+                // for its dithering to average out
+                idle = idle && !LEDOutput::isDithering();
                 
                 frameCounter++;
                 lastFrameTime = millis();
+                LEDStats::frameDone(frameStart, shown);
             }
             
-            // Maintain consistent frame rate
+            if (idle) {
+                // Static scene (or off) is on the strip - sleep until a
+                // setter calls requestFrame() or the next playlist step
+                TickType_t wait = portMAX_DELAY;
+                if (powerOn && LEDPlaylist::isRunning()) {
+                    wait = pdMS_TO_TICKS(LEDPlaylist::msUntilNext(millis()));
+                }
+                ulTaskNotifyTake(pdTRUE, wait);
+                lastWakeTime = xTaskGetTickCount();
+                continue;
+            }
+            
+            // Maintain consistent frame rate. After an overrun start the next
+            // frame right away instead of rushing catch-up frames.
+            TickType_t nowTicks = xTaskGetTickCount();
+            if (nowTicks - lastWakeTime >= frameDelay) {
+                lastWakeTime = nowTicks - frameDelay;
+                LEDStats::missedDeadline();
+            }
             vTaskDelayUntil(&lastWakeTime, frameDelay);
         }
     }
@@ -900,6 +1534,19 @@ private:
     // Parameter Helpers
     // ========================================================================
     
+    // Apply a params object to a segment (segment lock held)
+    static void applySegmentParams(Segment& seg, JsonVariant params) {
+        JsonObject obj = params.as<JsonObject>();
+        if (obj.isNull()) return;
+        
+        LEDSegments::withParams(seg, [&]() {
+            for (JsonPair kv : obj) {
+                setParamFor(seg.effect, kv.key().c_str(), kv.value());
+            }
+        });
+        seg.dirty = true;
+    }
+    
     static CRGB parseColor(const char* hex) {
         if (hex[0] == '#') hex++;
         uint32_t val = strtoul(hex, NULL, 16);
@@ -912,9 +1559,9 @@ private:
         return String(buf);
     }
     
-    static void applySpeedParam(uint8_t speed) {
+    static void applySpeedParam(uint8_t effectId, uint8_t speed) {
         // Apply speed to current effect's params
-        switch (currentEffect) {
+        switch (effectId) {
             case 4: rainbowWaveParams.speed = speed; break;
             case 5: colorWaveParams.speed = speed; break;
             case 6: oscillateParams.speed = speed; break;
@@ -947,8 +1594,8 @@ private:
         }
     }
     
-    static void applyColorParam(CRGB color) {
-        switch (currentEffect) {
+    static void applyColorParam(uint8_t effectId, CRGB color) {
+        switch (effectId) {
             case 0: solidParams.color = color; break;
             case 2: spotsParams.color = color; break;
             case 8: theaterChaseParams.color = color; break;
@@ -969,8 +1616,8 @@ private:
         }
     }
     
-    static void applyIntensityParam(uint8_t intensity) {
-        switch (currentEffect) {
+    static void applyIntensityParam(uint8_t effectId, uint8_t intensity) {
+        switch (effectId) {
             case 13: twinkleParams.intensity = intensity; break;
             case 15: sparkleParams.intensity = intensity; break;
             case 16: glitterParams.intensity = intensity; break;
@@ -997,70 +1644,17 @@ bool LEDController::effectChanged = true;
 bool LEDController::effectReady = false;  // Wait for setEffect() before running
 uint32_t LEDController::frameCounter = 0;
 uint32_t LEDController::lastFrameTime = 0;
+uint32_t LEDController::framePeriodMs = 1000 / LED_TARGET_FPS;
+uint8_t LEDController::shownEffect = LEDTransition::NO_EFFECT;
+bool LEDController::playlistStep = false;
+uint16_t LEDController::stepTransitionMs = 0;
+TransitionCurve LEDController::stepCurve = CURVE_LINEAR;
+EffectInstance LEDController::mainEffect;
+uint8_t LEDController::entryEffect = LEDTransition::NO_EFFECT;
+uint8_t LEDController::entryParams[maxEffectParamsSize()];
 
-// Effect function array
-const LEDController::EffectEntry LEDController::effects[] = {
-    // Category 1: Static
-    {"Solid", effectSolid, 1},
-    {"Gradient", effectGradient, 1},
-    {"Spots", effectSpots, 1},
-    {"Pattern", effectPattern, 1},
-    
-    // Category 2: Wave/Fale
-    {"Rainbow Wave", effectRainbowWave, 2},
-    {"Color Wave", effectColorWave, 2},
-    {"Oscillate", effectOscillate, 2},
-    {"Wavy", effectWavy, 2},
-    
-    // Category 3: Chase/Running
-    {"Theater Chase", effectTheaterChase, 3},
-    {"Scanner", effectScanner, 3},
-    {"Comet", effectComet, 3},
-    {"Running Lights", effectRunningLights, 3},
-    {"Android", effectAndroid, 3},
-    
-    // Category 4: Twinkle/Sparkle
-    {"Twinkle", effectTwinkle, 4},
-    {"TwinkleFox", effectTwinkleFox, 4},
-    {"Sparkle", effectSparkle, 4},
-    {"Glitter", effectGlitter, 4},
-    {"Starry Night", effectStarryNight, 4},
-    
-    // Category 5: Fire/Organic
-    {"Fire", effectFire, 5},
-    {"Candle", effectCandle, 5},
-    {"Fire Flicker", effectFireFlicker, 5},
-    {"Lava", effectLava, 5},
-    {"Aurora", effectAurora, 5},
-    {"Pacifica", effectPacifica, 5},
-    {"Lake", effectLake, 5},
-    
-    // Category 6: Christmas/Seasonal
-    {"Fairy Lights", effectFairy, 6},
-    {"Christmas Chase", effectChristmasChase, 6},
-    {"Halloween Eyes", effectHalloweenEyes, 6},
-    {"Fireworks", effectFireworks, 6},
-    {"Snow Sparkle", effectSnowSparkle, 6},
-    
-    // Category 7: Special
-    {"Bouncing Balls", effectBouncingBalls, 7},
-    {"Popcorn", effectPopcorn, 7},
-    {"Drip", effectDrip, 7},
-    {"Plasma", effectPlasma, 7},
-    {"Lightning", effectLightning, 7},
-    {"Matrix", effectMatrix, 7},
-    {"Heartbeat", effectHeartbeat, 7},
-    
-    // Category 8: Breathing/Fade
-    {"Breathe", effectBreathe, 8},
-    {"Dissolve", effectDissolve, 8},
-    {"Fade", effectFade, 8},
-    
-    // Category 9: Alarm
-    {"Police Lights", effectPolice, 9},
-    {"Strobe", effectStrobe, 9}
-};
-
-const uint8_t LEDController::NUM_EFFECTS = sizeof(LEDController::effects) / sizeof(LEDController::effects[0]);
+// Effect function array (defined in EffectTable.h)
+const EffectEntry* const LEDController::effects = effectTable;
+const uint8_t LEDController::NUM_EFFECTS = NUM_EFFECT_ENTRIES;
 
 #endif // LED_CONTROLLER_H
@@ -0,0 +1,328 @@
+/*
+ * LEDGeometry.h - Physical layout of the strip on the tree
+ *
+ * Per-LED coordinates and the position tables behind effect directions
+ */
+
+#ifndef LED_GEOMETRY_H
+#define LED_GEOMETRY_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "EffectParams.h"
+#include "EffectDefs.h"
+
+// ============================================================================
+// Geometry Model
+// ============================================================================
+// GEOMETRY_STRIP     no layout known: up/cw behave as forward, down/ccw as
+//                    reverse (the behaviour effects always had)
+// GEOMETRY_SPIRAL    the strip wraps the tree as a spiral from the bottom
+//                    (or top) - cone of base radius 1 tapering to taper at
+//                    the top, height in base radii, LEDs evenly spaced
+//                    along the wire
+
+enum GeometryType : uint8_t {
+    GEOMETRY_STRIP = 0,
+    GEOMETRY_SPIRAL
+};
+
+struct GeometryConfig {
+    GeometryType type;
+    float turns;        // Wraps around the trunk, bottom to top
+    float taper;        // Top radius / base radius (0 = point)
+    float height;       // Tree height in base radii
+    bool ccw;           // Winds counter-clockwise seen from above (going up)
+    bool topFirst;      // LED 0 at the top
+
+    static GeometryConfig defaults() {
+        return { GEOMETRY_STRIP, 8.0f, 0.1f, 3.0f, false, false };
+    }
+};
+
+// One LED: x/y around the trunk in base radii (Q15, +-32767), z = height
+// (0 bottom .. 65535 top), angle clockwise from +x seen from above (65536
+// = full turn)
+struct LedPoint {
+    int16_t x;
+    int16_t y;
+    uint16_t z;
+    uint16_t angle;
+};
+
+// ============================================================================
+// LEDGeometry - Coordinates and direction tables, built once at boot
+// ============================================================================
+// Effects take a direction parameter and used to map it per pixel with a
+// switch, up/down and cw/ccw being aliases of forward/reverse. Now each
+// direction has a table holding every LED's position along it, in LEDs:
+//
+//   forward/reverse   index along the strip (as before)
+//   up/down           height, scaled to the strip length - a wave moves up
+//                     the tree at an even speed whatever the strip does
+//   cw/ccw            angle around the trunk, scaled to the LEDs of one
+//                     turn - bands rotate around the tree
+//
+// so an effect fetches ledPositions(dir) once per frame and reads pos[i].
+// Effects that move something from LED to LED (a comet, falling flakes)
+// need the inverse: ledOrder(dir) lists the LEDs in order along dir -
+// bottom to top, or around the trunk (ties in strip order) - and they draw
+// step k of their path on leds[order[k]]. The spiral is laid out (with its
+// trig) and sorted in begin(); nothing is computed per frame.
+//
+// Segments render into their own buffer with leds[0] = LED seg.start, so
+// LEDSegments moves the table origin along (setOrigin()). Geometric
+// positions stay in whole-strip units there; forward/reverse count within
+// the segment as before. A segment's order is the strip's with the other
+// LEDs left out, filtered into a scratch list when it is asked for.
+// ============================================================================
+
+class LEDGeometry {
+public:
+    // Lay out NUM_LEDS and build the tables (once, after allocLeds())
+    static bool begin(const GeometryConfig& cfg = GeometryConfig::defaults()) {
+        config = cfg;
+        count = NUM_LEDS;
+
+        ramps = allocLedBuffer<uint16_t>(count * 2);
+        points = allocLedBuffer<LedPoint>(count);
+        if (ramps == nullptr || points == nullptr) {
+            heap_caps_free(ramps);
+            heap_caps_free(points);
+            ramps = nullptr;
+            points = nullptr;
+            return false;
+        }
+        for (uint16_t i = 0; i < count; i++) {
+            ramps[i] = i;
+            ramps[count + i] = count - 1 - i;
+        }
+        tables[DIR_FORWARD] = ramps;
+        tables[DIR_REVERSE] = ramps + count;
+
+        if (!isMapped()) {
+            layoutStrip();
+            return true;
+        }
+        if (!layoutSpiral()) {
+            return false;
+        }
+        uint16_t* geo = allocLedBuffer<uint16_t>(count * 9);
+        uint16_t* start = allocLedBuffer<uint16_t>(max(count, ledsPerTurn) + 1);
+        if (geo == nullptr || start == nullptr) {
+            heap_caps_free(geo);
+            heap_caps_free(start);
+            return false;
+        }
+        buildTables(geo);
+        buildOrders(geo + count * 4, start);
+        heap_caps_free(start);
+        return true;
+    }
+
+    // Geometry in use
+    static const GeometryConfig& getConfig() { return config; }
+    static bool isMapped() { return config.type != GEOMETRY_STRIP && count > 1; }
+    static uint16_t getLedsPerTurn() { return ledsPerTurn; }
+
+    // Coordinates of a strip LED (global index)
+    static const LedPoint& point(uint16_t led) { return points[led]; }
+
+    // Position along dir of every LED being rendered: pos[i] for leds[i]
+    static const uint16_t* positions(Direction dir) {
+        if (dir == DIR_FORWARD) return tables[DIR_FORWARD];
+        if (dir == DIR_REVERSE) return tables[DIR_REVERSE] + (count - NUM_LEDS);
+        if (!isMapped()) return positions(dir == DIR_UP || dir == DIR_CW ? DIR_FORWARD : DIR_REVERSE);
+        return tables[dir] + origin;
+    }
+
+    // LEDs being rendered in order along dir: leds[order[k]] is the k-th.
+    // LED task only (a segment's list is built in one shared scratch list).
+    static const uint16_t* order(Direction dir) {
+        if (dir == DIR_FORWARD) return tables[DIR_FORWARD];
+        if (dir == DIR_REVERSE) return tables[DIR_REVERSE] + (count - NUM_LEDS);
+        if (!isMapped()) return order(dir == DIR_UP || dir == DIR_CW ? DIR_FORWARD : DIR_REVERSE);
+        if (origin == 0 && NUM_LEDS == count) return orders[dir];
+
+        if (scratchDir != dir || scratchOrigin != origin || scratchCount != NUM_LEDS) {
+            uint16_t n = 0;
+            for (uint16_t k = 0; k < count; k++) {
+                uint16_t led = orders[dir][k] - origin;   // Wraps for LEDs before origin
+                if (led < NUM_LEDS) scratch[n++] = led;
+            }
+            scratchDir = dir;
+            scratchOrigin = origin;
+            scratchCount = NUM_LEDS;
+        }
+        return scratch;
+    }
+
+    // Strip LED that leds[0] is (LEDSegments, around a segment render)
+    static void setOrigin(uint16_t led) { origin = led; }
+
+private:
+    static GeometryConfig config;
+    static uint16_t count;          // LEDs the tables were built for
+    static uint16_t origin;
+    static uint16_t ledsPerTurn;
+    static uint16_t* ramps;         // 0..count-1, then count-1..0
+    static LedPoint* points;
+    static const uint16_t* tables[6];
+    static const uint16_t* orders[6];
+    static uint16_t* scratch;       // A segment's order (order())
+    static Direction scratchDir;
+    static uint16_t scratchOrigin;
+    static uint16_t scratchCount;
+
+    // Vertical line, bottom to top
+    static void layoutStrip() {
+        for (uint16_t i = 0; i < count; i++) {
+            uint16_t z = count > 1 ? (uint32_t)i * 65535 / (count - 1) : 0;
+            points[i] = { 0, 0, z, 0 };
+        }
+    }
+
+    // Spiral on a cone, LEDs at equal arc length: the arc is sampled (64
+    // points a turn) and each LED placed by interpolating its share of the
+    // total length
+    static bool layoutSpiral() {
+        const uint16_t SAMPLES = max<uint16_t>(1024, (uint16_t)(config.turns * 64));
+        const float turnAngle = 2.0f * PI * config.turns;
+        float* arc = allocLedBuffer<float>(SAMPLES + 1);
+        if (arc == nullptr) {
+            return false;
+        }
+
+        arc[0] = 0;
+        for (uint16_t s = 1; s <= SAMPLES; s++) {
+            float t0 = (float)(s - 1) / SAMPLES, t1 = (float)s / SAMPLES;
+            float dx = spiralX(t1) - spiralX(t0);
+            float dy = spiralY(t1) - spiralY(t0);
+            float dz = (t1 - t0) * config.height;
+            arc[s] = arc[s - 1] + sqrtf(dx * dx + dy * dy + dz * dz);
+        }
+
+        uint16_t s = 1;
+        for (uint16_t i = 0; i < count; i++) {
+            float target = arc[SAMPLES] * i / (count - 1);
+            while (s < SAMPLES && arc[s] < target) s++;
+            float span = arc[s] - arc[s - 1];
+            float t = (s - 1 + (span > 0 ? (target - arc[s - 1]) / span : 0)) / SAMPLES;
+
+            // Winding angle; seen from above a ccw tree turns the other way
+            float theta = fmodf(turnAngle * t, 2.0f * PI);
+            uint16_t wound = (uint16_t)(uint32_t)(theta / (2.0f * PI) * 65536);
+            LedPoint& p = points[config.topFirst ? count - 1 - i : i];
+            p.x = (int16_t)(spiralX(t) * 32767);
+            p.y = (int16_t)(spiralY(t) * 32767);
+            p.z = (uint16_t)(t * 65535 + 0.5f);
+            p.angle = config.ccw ? (uint16_t)(0 - wound) : wound;
+        }
+        heap_caps_free(arc);
+        ledsPerTurn = max<uint16_t>(1, (uint16_t)(count / config.turns + 0.5f));
+        return true;
+    }
+
+    // Cone of the spiral at t (0 bottom, 1 top); clockwise from above is
+    // +y -> -y across +x, so a cw winding runs through negative math angles
+    static float spiralRadius(float t) { return 1.0f - (1.0f - config.taper) * t; }
+    static float spiralX(float t) { return spiralRadius(t) * cosf(2.0f * PI * config.turns * t); }
+    static float spiralY(float t) {
+        float y = spiralRadius(t) * sinf(2.0f * PI * config.turns * t);
+        return config.ccw ? y : -y;
+    }
+
+    // up/down from height, cw/ccw from angle (one turn = ledsPerTurn LEDs)
+    static void buildTables(uint16_t* geo) {
+        uint16_t* up = geo;
+        uint16_t* down = geo + count;
+        uint16_t* cw = geo + count * 2;
+        uint16_t* ccw = geo + count * 3;
+        for (uint16_t i = 0; i < count; i++) {
+            const LedPoint& p = points[i];
+            up[i] = ((uint32_t)p.z * (count - 1) + 32767) / 65535;
+            down[i] = count - 1 - up[i];
+            cw[i] = (uint32_t)p.angle * ledsPerTurn >> 16;
+            ccw[i] = ledsPerTurn - 1 - cw[i];
+        }
+        tables[DIR_UP] = up;
+        tables[DIR_DOWN] = down;
+        tables[DIR_CW] = cw;
+        tables[DIR_CCW] = ccw;
+    }
+
+    // LEDs sorted by up and cw position; down/ccw are the same lists
+    // backwards. buf holds 5 x count (the last for segments), start
+    // max(count, ledsPerTurn) + 1 entries of counting-sort scratch.
+    static void buildOrders(uint16_t* buf, uint16_t* start) {
+        uint16_t* up = buf;
+        uint16_t* down = buf + count;
+        uint16_t* cw = buf + count * 2;
+        uint16_t* ccw = buf + count * 3;
+        sortBy(tables[DIR_UP], count, up, start);
+        sortBy(tables[DIR_CW], ledsPerTurn, cw, start);
+        for (uint16_t k = 0; k < count; k++) {
+            down[k] = up[count - 1 - k];
+            ccw[k] = cw[count - 1 - k];
+        }
+        orders[DIR_UP] = up;
+        orders[DIR_DOWN] = down;
+        orders[DIR_CW] = cw;
+        orders[DIR_CCW] = ccw;
+        scratch = buf + count * 4;
+    }
+
+    // Counting sort of the LEDs by key (0..levels-1), equal keys in strip
+    // order
+    static void sortBy(const uint16_t* key, uint16_t levels, uint16_t* out, uint16_t* start) {
+        memset(start, 0, (levels + 1) * sizeof(uint16_t));
+        for (uint16_t i = 0; i < count; i++) {
+            start[key[i] + 1]++;
+        }
+        for (uint16_t l = 1; l <= levels; l++) {
+            start[l] += start[l - 1];
+        }
+        for (uint16_t i = 0; i < count; i++) {
+            out[start[key[i]]++] = i;
+        }
+    }
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+GeometryConfig LEDGeometry::config = GeometryConfig::defaults();
+uint16_t LEDGeometry::count = 0;
+uint16_t LEDGeometry::origin = 0;
+uint16_t LEDGeometry::ledsPerTurn = 1;
+uint16_t* LEDGeometry::ramps = nullptr;
+LedPoint* LEDGeometry::points = nullptr;
+const uint16_t* LEDGeometry::tables[6] = {};
+const uint16_t* LEDGeometry::orders[6] = {};
+uint16_t* LEDGeometry::scratch = nullptr;
+Direction LEDGeometry::scratchDir = DIR_FORWARD;
+uint16_t LEDGeometry::scratchOrigin = 0;
+uint16_t LEDGeometry::scratchCount = 0;
+
+// ============================================================================
+// Effect Helpers
+// ============================================================================
+
+// Position table for a direction - fetch once per frame, then pos[i]
+inline const uint16_t* ledPositions(Direction dir) {
+    return LEDGeometry::positions(dir);
+}
+
+// LEDs in order along a direction - fetch once per frame, then
+// leds[order[k]] for step k
+inline const uint16_t* ledOrder(Direction dir) {
+    return LEDGeometry::order(dir);
+}
+
+// Map LED position based on direction (one LED; prefer ledPositions())
+uint16_t mapLed(uint16_t pos, Direction dir) {
+    return LEDGeometry::positions(dir)[pos];
+}
+
+#endif // LED_GEOMETRY_H
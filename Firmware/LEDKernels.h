@@ -0,0 +1,272 @@
+/*
+ * LEDKernels.h - Buffer-wide pixel operations
+ *
+ * Fill, scale/fade, blend and saturating add over whole LED buffers, with
+ * ESP32-S3 vector (PIE) versions of the hottest ones
+ */
+
+#ifndef LED_KERNELS_H
+#define LED_KERNELS_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+
+#if LED_KERNELS_PIE && CONFIG_IDF_TARGET_ESP32S3
+#define LED_KERNELS_VECTOR 1
+#else
+#define LED_KERNELS_VECTOR 0
+#endif
+
+// ============================================================================
+// LEDKernels - Whole-buffer versions of the per-pixel FastLED calls
+// ============================================================================
+// Every kernel gives exactly the result of the per-pixel call it replaces
+// (FastLED's FASTLED_SCALE8_FIXED / FASTLED_BLEND_FIXED math):
+//
+//   fill(buf, n, c)            fill_solid()
+//   scale(buf, n, s)           leds[i].nscale8(s) on every pixel
+//   fade(buf, n, a)            leds[i].nscale8(255 - a)      (fadeAll)
+//   blend(dst, a, b, n, x)     dst[i] = blend(a[i], b[i], x)
+//   blendToward(buf, n, c, x)  buf[i] = blend(buf[i], c, x)
+//   add(dst, src, n)           dst[i] += src[i]              (qadd8)
+//
+// The portable versions treat the buffer as flat bytes (CRGB is 3 packed
+// bytes) in branch-free loops, which compilers vectorize on the host. On
+// the ESP32-S3, fill and scale/fade run the 16-byte-aligned middle of the
+// buffer through the PIE 128-bit unit: EE.VST.128 stores a 48-byte color
+// pattern, EE.VMUL.U8 scales 16 bytes per instruction (>> SAR = 8). Blend
+// and add stay portable - PIE has no unsigned saturating add, and its
+// 8-bit multiply shifts each product on its own, which cannot reproduce
+// blend8's rounding.
+//
+// begin() checks the vector kernels against the portable ones on the
+// device and switches them off if they ever disagree.
+// ============================================================================
+
+class LEDKernels {
+public:
+    // Verify the vector kernels (call once at boot). Returns false if they
+    // disagreed with the portable versions and were switched off.
+    static bool begin() {
+#if LED_KERNELS_VECTOR
+        vectorOn = selfCheck();
+        return vectorOn;
+#else
+        return true;
+#endif
+    }
+
+    // Kernels in use, for the log
+    static const char* name() {
+        return isVector() ? "PIE (128-bit)" : "portable";
+    }
+
+    static bool isVector() {
+#if LED_KERNELS_VECTOR
+        return vectorOn;
+#else
+        return false;
+#endif
+    }
+
+    // Vector units on or off (off = portable versions everywhere)
+    static void setVector(bool on) {
+#if LED_KERNELS_VECTOR
+        vectorOn = on;
+#else
+        (void)on;
+#endif
+    }
+
+    // ========================================================================
+    // Kernels
+    // ========================================================================
+
+    static void fill(CRGB* buf, uint16_t count, CRGB color) {
+        uint8_t* p = (uint8_t*)buf;
+        uint32_t len = count * 3;
+#if LED_KERNELS_VECTOR
+        if (vectorOn && len >= 2 * FILL_BLOCK) {
+            uint32_t head = (0u - (uintptr_t)p) & 15;
+            fillBytes(p, head, color, 0);
+
+            alignas(16) uint8_t pattern[FILL_BLOCK];
+            for (uint8_t k = 0; k < FILL_BLOCK; k++) {
+                pattern[k] = color.raw[(head + k) % 3];
+            }
+            uint32_t blocks = (len - head) / FILL_BLOCK;
+            vectorFill(p + head, blocks, pattern);
+
+            uint32_t done = head + blocks * FILL_BLOCK;
+            fillBytes(p + done, len - done, color, done % 3);
+            return;
+        }
+#endif
+        fillBytes(p, len, color, 0);
+    }
+
+    static void scale(CRGB* buf, uint16_t count, uint8_t scale) {
+        if (scale == 255) return;   // nscale8(255) keeps every value
+        uint8_t* p = (uint8_t*)buf;
+        uint32_t len = count * 3;
+#if LED_KERNELS_VECTOR
+        if (vectorOn && len >= 64) {
+            uint32_t head = (0u - (uintptr_t)p) & 15;
+            scaleBytes(p, head, scale);
+            uint32_t blocks = (len - head) / 16;
+            vectorScale(p + head, blocks, scale + 1);
+            uint32_t done = head + blocks * 16;
+            scaleBytes(p + done, len - done, scale);
+            return;
+        }
+#endif
+        scaleBytes(p, len, scale);
+    }
+
+    static void fade(CRGB* buf, uint16_t count, uint8_t amount) {
+        scale(buf, count, 255 - amount);
+    }
+
+    // dst may be a or b
+    static void blend(CRGB* dst, const CRGB* a, const CRGB* b, uint16_t count, uint8_t amountOfB) {
+        blendBytes((uint8_t*)dst, (const uint8_t*)a, (const uint8_t*)b, count * 3, amountOfB);
+    }
+
+    static void blendToward(CRGB* buf, uint16_t count, CRGB color, uint8_t amount) {
+        if (amount == 0) return;
+        // blend8 with the color's share (b*256 + b*x) folded into a constant
+        uint16_t base[3];
+        for (uint8_t c = 0; c < 3; c++) {
+            base[c] = (uint16_t)(color.raw[c] + color.raw[c] * amount);
+        }
+        uint8_t* p = (uint8_t*)buf;
+        for (uint32_t i = 0; i < count * 3u; i += 3) {
+            p[i]     = (uint16_t)((p[i] << 8) + base[0] - p[i] * amount) >> 8;
+            p[i + 1] = (uint16_t)((p[i + 1] << 8) + base[1] - p[i + 1] * amount) >> 8;
+            p[i + 2] = (uint16_t)((p[i + 2] << 8) + base[2] - p[i + 2] * amount) >> 8;
+        }
+    }
+
+    static void add(CRGB* dst, const CRGB* src, uint16_t count) {
+        addBytes((uint8_t*)dst, (const uint8_t*)src, count * 3);
+    }
+
+    // ========================================================================
+    // Portable Byte Kernels
+    // ========================================================================
+
+    static void fillBytes(uint8_t* p, uint32_t len, CRGB color, uint8_t phase) {
+        if (phase == 0 && len % 3 == 0) {
+            for (uint32_t i = 0; i < len; i += 3) {
+                p[i] = color.r;
+                p[i + 1] = color.g;
+                p[i + 2] = color.b;
+            }
+            return;
+        }
+        for (uint32_t i = 0; i < len; i++) {
+            p[i] = color.raw[(phase + i) % 3];
+        }
+    }
+
+    static void scaleBytes(uint8_t* p, uint32_t len, uint8_t scale) {
+        uint16_t s = (uint16_t)scale + 1;
+        for (uint32_t i = 0; i < len; i++) {
+            p[i] = (p[i] * s) >> 8;
+        }
+    }
+
+    // blend8() per byte: (a*256 + b + (b - a)*x) >> 8
+    static void blendBytes(uint8_t* dst, const uint8_t* a, const uint8_t* b,
+                           uint32_t len, uint8_t amountOfB) {
+        for (uint32_t i = 0; i < len; i++) {
+            uint16_t partial = (uint16_t)((a[i] << 8) | b[i]);
+            partial += (uint16_t)(b[i] * amountOfB);
+            partial -= (uint16_t)(a[i] * amountOfB);
+            dst[i] = partial >> 8;
+        }
+    }
+
+    static void addBytes(uint8_t* __restrict__ dst, const uint8_t* __restrict__ src, uint32_t len) {
+        for (uint32_t i = 0; i < len; i++) {
+            uint16_t t = dst[i] + src[i];
+            dst[i] = t > 255 ? 255 : t;
+        }
+    }
+
+private:
+    static constexpr uint8_t FILL_BLOCK = 48;   // 3 vectors = 16 whole pixels
+
+#if LED_KERNELS_VECTOR
+    static bool vectorOn;
+
+    // blocks x 48 bytes of pattern to p (16-byte aligned)
+    static void vectorFill(uint8_t* p, uint32_t blocks, const uint8_t* pattern) {
+        asm volatile (
+            "ee.vld.128.ip  q0, %[pat], 16  \n"
+            "ee.vld.128.ip  q1, %[pat], 16  \n"
+            "ee.vld.128.ip  q2, %[pat], 16  \n"
+            "loopnez        %[n], 1f        \n"
+            "ee.vst.128.ip  q0, %[p], 16    \n"
+            "ee.vst.128.ip  q1, %[p], 16    \n"
+            "ee.vst.128.ip  q2, %[p], 16    \n"
+            "1:                             \n"
+            : [p] "+r" (p), [pat] "+r" (pattern)
+            : [n] "r" (blocks)
+            : "memory"
+        );
+    }
+
+    // blocks x 16 bytes at p (16-byte aligned) = (p * mul) >> 8
+    static void vectorScale(uint8_t* p, uint32_t blocks, uint8_t mul) {
+        asm volatile (
+            "wsr.sar        %[shift]        \n"
+            "ee.vldbc.8     q1, %[mul]      \n"
+            "loopnez        %[n], 1f        \n"
+            "ee.vld.128.ip  q0, %[p], 0     \n"
+            "ee.vmul.u8     q0, q0, q1      \n"
+            "ee.vst.128.ip  q0, %[p], 16    \n"
+            "1:                             \n"
+            : [p] "+r" (p)
+            : [n] "r" (blocks), [mul] "r" (&mul), [shift] "r" (8)
+            : "memory"
+        );
+    }
+
+    // Vector against portable results on odd lengths and alignments
+    static bool selfCheck() {
+        const uint16_t CHECK_LEDS = 64;
+        CRGB ref[CHECK_LEDS + 8], vec[CHECK_LEDS + 8];
+        bool ok = true;
+        for (uint8_t offset = 0; offset < 8 && ok; offset++) {
+            uint16_t count = CHECK_LEDS - offset * 3;
+            for (uint16_t i = 0; i < count; i++) {
+                ref[offset + i] = CRGB(random8(), random8(), random8());
+            }
+            memcpy(vec, ref, sizeof(ref));
+
+            uint8_t s = random8();
+            scaleBytes((uint8_t*)(ref + offset), count * 3, s);
+            scale(vec + offset, count, s);
+            ok &= memcmp(ref, vec, sizeof(ref)) == 0;
+
+            CRGB c(random8(), random8(), random8());
+            fillBytes((uint8_t*)(ref + offset), count * 3, c, 0);
+            fill(vec + offset, count, c);
+            ok &= memcmp(ref, vec, sizeof(ref)) == 0;
+        }
+        return ok;
+    }
+#endif
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+#if LED_KERNELS_VECTOR
+bool LEDKernels::vectorOn = true;
+#endif
+
+#endif // LED_KERNELS_H
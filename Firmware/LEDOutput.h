@@ -0,0 +1,477 @@
+/*
+ * LEDOutput.h - Double-buffered LED output with asynchronous show
+ *
+ * Decouples effect rendering from the WS2812 wire time and maps the
+ * logical frame onto one or more physical data pins
+ */
+
+#ifndef LED_OUTPUT_H
+#define LED_OUTPUT_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <ArduinoJson.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "EffectDefs.h"
+#include "LEDStats.h"
+#include "ColorPipeline.h"
+#include "HDRFrame.h"
+#include "LEDKernels.h"
+#include "LEDPower.h"
+
+// ============================================================================
+// LEDOutput - Frame hand-off between LED task and the LED driver
+// ============================================================================
+// Effects always render into the global leds[] (back buffer). present()
+// copies a finished frame into frontLeds[] - the array registered with
+// FastLED - and wakes the show task, which clocks it out while the LED task
+// already renders the next frame. A copy (not a pointer swap) keeps leds[]
+// intact for effects that fade or shift the previous frame.
+//
+// Multiple outputs: every pin in LED_OUTPUT_PINS gets its own slice of
+// frontLeds[] and all of them are sent in parallel, one RMT channel each
+// (LED_OUTPUT_MAX_PINS on the S3). The output map says
+// which range of the logical strip each pin shows; it is applied in the same
+// copy, so effects never see the physical layout.
+//
+// The same copy runs the output stage when it has anything to do: color
+// correction and global brightness (ColorPipeline) at 16 bits per channel,
+// then temporal dithering back to 8 (HDRFrame). Frames that come with a
+// 16-bit version (crossfades, solid fades) are taken from that instead of
+// leds[].
+//
+// The copy also measures the current each output will draw (LEDPower) and
+// scales down outputs over their budget before the frame is sent: such an
+// output's dithering is taken back and done again with the scale in its
+// 8.8 values, so the error carried to the next frame is that of what the
+// strip really shows.
+//
+// present() hashes the frame and skips the copy and show entirely when it
+// matches the frame already on the strip, so animations that stand still
+// (and repeated static frames) cause no wire traffic - unless the strip is
+// still being dithered (isDithering()), which takes a stream of frames for
+// up to LED_DITHER_HOLD_FRAMES (HDRFrame).
+// invalidate() forces the next frame out when only output settings
+// (brightness, color) changed.
+//
+// With LED_OUTPUT_DOUBLE_BUFFER disabled present() is a plain FastLED.show()
+// on a single pin, without color correction or dithering (brightness, the
+// strip's LED_COLOR_CORRECTION and power limiting are FastLED's).
+// ============================================================================
+
+// One physical output: logical LEDs [start, start + count), optionally
+// reversed, with the current its power injection can supply
+struct OutputMapping {
+    uint16_t start;
+    uint16_t count;
+    bool reversed;
+    uint16_t maxMa;     // 0 = only the supply limit applies
+};
+
+class LEDOutput {
+public:
+    // WS2812 timing: 24 bits @ 800 kHz per LED plus the latch/reset gap
+    static constexpr uint32_t WS2812_US_PER_LED = 30;
+    static constexpr uint32_t WS2812_RESET_US = 280;
+
+    static constexpr uint8_t outputPins[] = { LED_OUTPUT_PINS };
+    static constexpr uint8_t NUM_OUTPUT_PINS = sizeof(outputPins);
+    static_assert(NUM_OUTPUT_PINS <= LED_OUTPUT_MAX_PINS, "LED_OUTPUT_PINS: the ESP32-S3 has 4 RMT TX channels");
+
+    // Register LED strip(s) with FastLED and start the show task.
+    // Call after allocLeds() - buffers are sized from NUM_LEDS.
+    // mapJson: stored output map (empty = split strip evenly over all pins).
+    static bool begin(const String& mapJson = "") {
+#if LED_OUTPUT_DOUBLE_BUFFER
+        if (!loadMap(mapJson)) {
+            return false;
+        }
+
+        // Every output gets a slice as long as the longest one (padded with
+        // black) so parallel drivers can clock all pins in lockstep
+        outputStride = 0;
+        for (uint8_t o = 0; o < numOutputs; o++) {
+            outputStride = max(outputStride, outputs[o].count);
+        }
+
+        // Driver reads this buffer while sending, so keep it in internal RAM
+        frontLeds = allocLedBuffer<CRGB>(numOutputs * outputStride,
+                                         MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+        if (frontLeds == nullptr) {
+            LOG_ERROR("Failed to allocate LED output buffer!");
+            return false;
+        }
+
+        addOutputs<0>();
+
+        showDone = xSemaphoreCreateBinary();
+        if (showDone == NULL) {
+            LOG_ERROR("Failed to create LED show semaphore!");
+            return false;
+        }
+        xSemaphoreGive(showDone);  // Front buffer starts free
+
+        if (!ColorPipeline::begin()) {
+            return false;
+        }
+        if (!HDRFrame::begin()) {
+            LOG_ERROR("Failed to allocate 16-bit frame buffers!");
+            return false;
+        }
+
+        // Same core as LED task - show() sleeps while the frame is sent
+        BaseType_t result = xTaskCreatePinnedToCore(
+            showTask,
+            "LEDShow",
+            TASK_STACK_SIZE_LED_SHOW,
+            NULL,
+            TASK_PRIORITY_LED_SHOW,
+            &showTaskHandle,
+            0
+        );
+
+        if (result != pdPASS) {
+            LOG_ERROR("Failed to create LED show task!");
+            return false;
+        }
+
+        LOG_INFO("LED output: double-buffered, async show");
+        for (uint8_t o = 0; o < numOutputs; o++) {
+            LOG_PRINTF("INFO ", "  Output %d: GPIO%d <- LEDs %d-%d%s", o, outputPins[o],
+                       outputs[o].start, outputs[o].start + outputs[o].count - 1,
+                       outputs[o].reversed ? " (reversed)" : "");
+            if (outputs[o].maxMa != 0) {
+                LOG_PRINTF("INFO ", "    limited to %d mA", outputs[o].maxMa);
+            }
+        }
+#else
+        static_assert(NUM_OUTPUT_PINS == 1, "Multiple outputs need LED_OUTPUT_DOUBLE_BUFFER");
+        outputs[0] = { 0, NUM_LEDS, false, 0 };
+
+        FastLED.addLeds<WS2812, outputPins[0], GRB>(leds, NUM_LEDS)
+               .setCorrection(LED_COLOR_CORRECTION);
+        if (LED_POWER_LIMIT_MW != 0) {
+            FastLED.setMaxPowerInMilliWatts(LED_POWER_LIMIT_MW);
+        }
+
+        LOG_INFO("LED output: single buffer, blocking show");
+#endif
+        return true;
+    }
+
+    // Hand the frame in leds[] to the driver. Blocks only while the
+    // previous frame is still being sent. Returns false if the frame was
+    // unchanged and nothing was sent.
+    static bool present() {
+        HDRFrame::Mode mode = HDRFrame::take();
+        uint32_t hash = frameHash(leds, NUM_LEDS);
+        if (mode == HDRFrame::FRAME_SOLID) {
+            hash = hashBytes(&HDRFrame::solidColor(), sizeof(CRGB16), hash);
+        } else if (mode == HDRFrame::FRAME_MIXED) {
+            hash = hashBytes(HDRFrame::mixBuffer(), NUM_LEDS * sizeof(CRGB16));
+        }
+        bool changed = hash != shownHash || forceShow;
+#if LED_OUTPUT_DOUBLE_BUFFER
+        if (!HDRFrame::beginFrame(changed)) {
+            return false;
+        }
+#else
+        if (!changed) {
+            return false;
+        }
+#endif
+        shownHash = hash;
+        forceShow = false;
+
+#if LED_OUTPUT_DOUBLE_BUFFER
+        xSemaphoreTake(showDone, portMAX_DELAY);
+        ColorPipeline::latch();
+        Source src = { mode, ColorPipeline::isActive(), { 0, 0, 0 } };
+        if (mode == HDRFrame::FRAME_SOLID) {
+            src.solid = ColorPipeline::toOutput(HDRFrame::solidColor());
+        }
+        LEDPower::Load loads[NUM_OUTPUT_PINS];
+        uint8_t fraction = 0;
+
+        for (uint8_t o = 0; o < numOutputs; o++) {
+            fraction |= writeOutput(o, src, 255);
+
+            // Slice was just written - sum it while it is still in cache
+            loads[o] = { {}, outputs[o].count, outputs[o].maxMa, 0, 255 };
+            LEDPower::measure(frontLeds + o * outputStride, outputs[o].count, loads[o].sums);
+        }
+
+        if (LEDPower::limit(loads, numOutputs)) {
+            // Over budget: write those outputs again, scaled before dithering
+            for (uint8_t o = 0; o < numOutputs; o++) {
+                if (loads[o].scale != 255) {
+                    undoOutput(o, src);
+                    fraction |= writeOutput(o, src, loads[o].scale);
+                }
+            }
+        }
+
+        HDRFrame::endFrame(fraction);
+
+        xTaskNotifyGive(showTaskHandle);
+#else
+        // FastLED limits the power itself; only estimate the draw, at its brightness
+        LEDPower::Load load = { {}, NUM_LEDS, 0, 0, 255 };
+        LEDPower::measure(leds, NUM_LEDS, load.sums);
+        for (uint8_t c = 0; c < 3; c++) {
+            load.sums[c] = (uint64_t)load.sums[c] * FastLED.getBrightness() / 255;
+        }
+        LEDPower::limit(&load, 1);
+
+        uint32_t showStart = LEDStats::cycles();
+        FastLED.show();
+        LEDStats::record(LEDStats::STAGE_SHOW, showStart);
+#endif
+        return true;
+    }
+
+    // Global brightness: in the 16-bit output tables (dithered), or
+    // FastLED's own scaling with a single buffer
+    static void setBrightness(uint8_t b) {
+#if LED_OUTPUT_DOUBLE_BUFFER
+        ColorPipeline::setBrightness(b);
+#else
+        FastLED.setBrightness(b);
+#endif
+        invalidate();
+    }
+
+    // Send the next frame even if its pixels are unchanged
+    static void invalidate() {
+        forceShow = true;
+    }
+
+    // The frame on the strip has values between output levels: keep
+    // presenting, even a static scene, so the dithering averages out (for
+    // a bounded number of frames, see HDRFrame)
+    static bool isDithering() {
+#if LED_OUTPUT_DOUBLE_BUFFER
+        return HDRFrame::isDithering();
+#else
+        return false;
+#endif
+    }
+
+    // FNV-1a over the frame, a word at a time
+    static uint32_t frameHash(const CRGB* frame, uint16_t count) {
+        return hashBytes(frame, count * sizeof(CRGB));
+    }
+
+    // Same over any buffer; hash continues an earlier one
+    static uint32_t hashBytes(const void* data, uint32_t len, uint32_t hash = 2166136261u) {
+        const uint8_t* bytes = (const uint8_t*)data;
+
+        uint32_t i = 0;
+        for (; i + 4 <= len; i += 4) {
+            uint32_t word;
+            memcpy(&word, bytes + i, 4);
+            hash = (hash ^ word) * 16777619u;
+        }
+        for (; i < len; i++) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    // Time to send one frame (all outputs are sent in parallel)
+    static uint32_t wireTimeUs() {
+#if LED_OUTPUT_DOUBLE_BUFFER
+        uint32_t longest = outputStride;
+#else
+        uint32_t longest = NUM_LEDS;
+#endif
+        return longest * WS2812_US_PER_LED + WS2812_RESET_US;
+    }
+
+    // Block until the last presented frame is fully on the wire
+    static void waitIdle() {
+#if LED_OUTPUT_DOUBLE_BUFFER
+        xSemaphoreTake(showDone, portMAX_DELAY);
+        xSemaphoreGive(showDone);
+#endif
+    }
+
+    // ========================================================================
+    // Output Map
+    // ========================================================================
+
+    // Parse and validate an output map:
+    // [{"start":0,"count":250,"reversed":false,"maxMa":3000}, ...] (maxMa optional)
+    static bool parseMap(JsonVariant json, OutputMapping* out, uint8_t& count) {
+        JsonArray arr = json.as<JsonArray>();
+        if (arr.isNull() || arr.size() == 0 || arr.size() > NUM_OUTPUT_PINS) {
+            return false;
+        }
+
+        count = 0;
+        for (JsonVariant item : arr) {
+            uint32_t start = item["start"] | 0;
+            uint32_t len = item["count"] | 0;
+            if (len == 0 || start + len > NUM_LEDS) {
+                return false;
+            }
+            out[count].start = start;
+            out[count].count = len;
+            out[count].reversed = item["reversed"] | false;
+            uint32_t maxMa = item["maxMa"] | 0;
+            if (maxMa > UINT16_MAX) {
+                return false;
+            }
+            out[count].maxMa = maxMa;
+            count++;
+        }
+        return true;
+    }
+
+    // Get pins and the active output map as JSON
+    static void getOutputsJson(JsonDocument& doc) {
+        JsonArray pins = doc["pins"].to<JsonArray>();
+        for (uint8_t o = 0; o < NUM_OUTPUT_PINS; o++) {
+            pins.add(outputPins[o]);
+        }
+
+        JsonArray arr = doc["outputs"].to<JsonArray>();
+        for (uint8_t o = 0; o < numOutputs; o++) {
+            JsonObject obj = arr.add<JsonObject>();
+            obj["start"] = outputs[o].start;
+            obj["count"] = outputs[o].count;
+            obj["reversed"] = outputs[o].reversed;
+            obj["maxMa"] = outputs[o].maxMa;
+            obj["mA"] = LEDPower::getOutputMilliamps(o);
+        }
+    }
+
+private:
+    static OutputMapping outputs[NUM_OUTPUT_PINS];
+    static uint8_t numOutputs;
+    static uint32_t shownHash;
+    static volatile bool forceShow;
+
+#if LED_OUTPUT_DOUBLE_BUFFER
+    static CRGB* frontLeds;
+    static uint16_t outputStride;
+    static TaskHandle_t showTaskHandle;
+    static SemaphoreHandle_t showDone;
+
+    // What present() copies out this frame
+    struct Source {
+        HDRFrame::Mode mode;
+        bool correct;       // ColorPipeline active (8-bit frames)
+        CRGB16 solid;       // FRAME_SOLID: the color, corrected
+    };
+
+    // Write output o's slice into frontLeds[], values scaled by scale (255 =
+    // as they are). Returns the dithered fraction (HDRFrame::endFrame()).
+    static uint8_t writeOutput(uint8_t o, const Source& src, uint8_t scale) {
+        const OutputMapping& m = outputs[o];
+        CRGB* dst = frontLeds + o * outputStride;
+        uint8_t* err = HDRFrame::errorAt(m.start);
+        if (src.mode == HDRFrame::FRAME_SOLID) {
+            return HDRFrame::ditherFill(dst, HDRFrame::scaleColor(src.solid, scale), err, m.count, m.reversed);
+        }
+        if (src.mode == HDRFrame::FRAME_MIXED) {
+            return HDRFrame::ditherRange(dst, HDRFrame::mixBuffer() + m.start, err, m.count, m.reversed, scale);
+        }
+        if (src.correct) {
+            return ColorPipeline::apply(dst, leds + m.start, err, m.count, m.reversed, scale);
+        }
+
+        // Nothing to correct or dither - plain copy
+        if (!m.reversed) {
+            memcpy(dst, leds + m.start, m.count * sizeof(CRGB));
+        } else {
+            const CRGB* from = leds + m.start + m.count - 1;
+            for (uint16_t i = 0; i < m.count; i++) {
+                dst[i] = *from--;
+            }
+        }
+        if (scale != 255) {
+            LEDKernels::scale(dst, m.count, scale);
+        }
+        return 0;
+    }
+
+    // Take back writeOutput(o, src, 255)'s dithering: the slice's error as
+    // it was before, so it can be written again scaled
+    static void undoOutput(uint8_t o, const Source& src) {
+        const OutputMapping& m = outputs[o];
+        uint8_t* err = HDRFrame::errorAt(m.start);
+        if (src.mode == HDRFrame::FRAME_SOLID) {
+            HDRFrame::undoFill(src.solid, err, m.count);
+        } else if (src.mode == HDRFrame::FRAME_MIXED) {
+            HDRFrame::undoRange(HDRFrame::mixBuffer() + m.start, err, m.count);
+        } else if (src.correct) {
+            ColorPipeline::undo(leds + m.start, err, m.count);
+        }
+    }
+
+    // Use the stored map, or split the strip evenly over all pins
+    static bool loadMap(const String& mapJson) {
+        if (!mapJson.isEmpty()) {
+            StaticJsonDocument<512> doc;
+            if (!deserializeJson(doc, mapJson) && parseMap(doc.as<JsonVariant>(), outputs, numOutputs)) {
+                return true;
+            }
+            LOG_WARN("Stored output map invalid for this strip - using default");
+        }
+
+        numOutputs = min<uint16_t>(NUM_OUTPUT_PINS, NUM_LEDS);
+        uint16_t perOutput = NUM_LEDS / numOutputs;
+        for (uint8_t o = 0; o < numOutputs; o++) {
+            outputs[o].start = o * perOutput;
+            outputs[o].count = (o == numOutputs - 1) ? NUM_LEDS - o * perOutput : perOutput;
+            outputs[o].reversed = false;
+            outputs[o].maxMa = 0;
+        }
+        return true;
+    }
+
+    // Register one FastLED controller per mapped pin (pins are template arguments)
+    template<uint8_t I>
+    static void addOutputs() {
+        if constexpr (I < NUM_OUTPUT_PINS) {
+            if (I < numOutputs) {
+                // Correction is in the output tables (ColorPipeline) -
+                // FastLED must not scale the dithered values again
+                FastLED.addLeds<WS2812, outputPins[I], GRB>(frontLeds + I * outputStride, outputStride)
+                       .setCorrection(UncorrectedColor);
+                addOutputs<I + 1>();
+            }
+        }
+    }
+
+    static void showTask(void* params) {
+        while (true) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            uint32_t showStart = LEDStats::cycles();
+            FastLED.show();
+            LEDStats::record(LEDStats::STAGE_SHOW, showStart);
+            xSemaphoreGive(showDone);
+        }
+    }
+#endif
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+OutputMapping LEDOutput::outputs[LEDOutput::NUM_OUTPUT_PINS];
+uint8_t LEDOutput::numOutputs = 1;
+uint32_t LEDOutput::shownHash = 0;
+volatile bool LEDOutput::forceShow = true;   // First frame always goes out
+
+#if LED_OUTPUT_DOUBLE_BUFFER
+CRGB* LEDOutput::frontLeds = nullptr;
+uint16_t LEDOutput::outputStride = 0;
+TaskHandle_t LEDOutput::showTaskHandle = NULL;
+SemaphoreHandle_t LEDOutput::showDone = NULL;
+#endif
+
+#endif // LED_OUTPUT_H
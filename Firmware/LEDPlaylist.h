@@ -0,0 +1,153 @@
+/*
+ * LEDPlaylist.h - Timed effect rotation
+ *
+ * Steps through a list of effects on the LED task's clock
+ */
+
+#ifndef LED_PLAYLIST_H
+#define LED_PLAYLIST_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "EffectDefs.h"
+#include "EffectTable.h"
+#include "LEDTransition.h"
+
+// ============================================================================
+// LEDPlaylist - Ordered (effect, params, duration, transition) steps
+// ============================================================================
+// Each entry keeps its effect's params as a raw copy of the xxxParams
+// struct (as segments do), filled in once when the playlist is set. When a
+// step is due the LED task copies that block into the whole-strip effect's
+// own params block and switches effect with the entry's transition; the
+// block is swapped into the globals only around the render, so the globals
+// keep the user's settings (GET /api/led/params, the params saved to NVS).
+// No JSON, no network and no NVS write per step. The list itself is stored
+// once, when it is set.
+//
+// Timing runs on effectTime.now, the LED task's frame clock. An entry's
+// duration includes its transition. A static effect lets the LED task
+// sleep; it then wakes on its own when the next step is due (msUntilNext).
+//
+// The playlist drives the whole-strip effect; with segments active it keeps
+// stepping underneath them. Entries and the effects' global params share
+// LEDSegments::lock().
+// ============================================================================
+
+struct PlaylistEntry {
+    uint8_t effect;
+    uint32_t durationMs;       // Time on this entry, transition included
+    uint16_t transitionMs;     // Crossfade into this entry
+    TransitionCurve curve;
+    uint8_t params[maxEffectParamsSize()];
+};
+
+class LEDPlaylist {
+public:
+    static uint8_t count() { return numEntries; }
+    static PlaylistEntry& get(uint8_t id) { return entries[id]; }
+    static bool isRunning() { return running; }
+    static bool isLooping() { return looping; }
+    static uint8_t currentIndex() { return index; }
+
+    // ========================================================================
+    // Entry List (lock held)
+    // ========================================================================
+
+    static void clear() {
+        numEntries = 0;
+        running = false;
+    }
+
+    // Append an entry; params start from the effect's current global values
+    static PlaylistEntry* add(uint8_t effect, uint32_t durationMs,
+                              uint16_t transitionMs, TransitionCurve curve) {
+        if (numEntries >= LED_MAX_PLAYLIST || effect >= NUM_EFFECT_ENTRIES) {
+            return nullptr;
+        }
+
+        PlaylistEntry& entry = entries[numEntries++];
+        entry.effect = effect;
+        entry.durationMs = max<uint32_t>(durationMs, LED_PLAYLIST_MIN_MS);
+        entry.transitionMs = min<uint16_t>(transitionMs, LED_TRANSITION_MAX_MS);
+        entry.curve = curve;
+        memcpy(entry.params, effectTable[effect].params, effectTable[effect].paramsSize);
+        return &entry;
+    }
+
+    // Play from the first entry (applied on the LED task's next frame)
+    static void start(bool loop) {
+        looping = loop;
+        running = numEntries > 0;
+        restart = true;
+    }
+
+    static void stop() {
+        running = false;
+    }
+
+    // ========================================================================
+    // Stepping (LED task, lock held)
+    // ========================================================================
+
+    // Entry to switch to at time now, or nullptr if the current one stays
+    static const PlaylistEntry* due(uint32_t now) {
+        if (!running) return nullptr;
+
+        if (restart) {
+            restart = false;
+            index = 0;
+            stepStart = now;
+            return &entries[0];
+        }
+
+        if (now - stepStart < entries[index].durationMs) {
+            return nullptr;
+        }
+        stepStart = now;
+
+        uint8_t next = index + 1;
+        if (next >= numEntries) {
+            if (!looping) {
+                running = false;   // Stay on the last entry
+                return nullptr;
+            }
+            next = 0;
+        }
+        if (next == index) {
+            return nullptr;        // Single entry - nothing to change
+        }
+        index = next;
+        return &entries[index];
+    }
+
+    // Time left on the current entry (how long an idle LED task may sleep)
+    static uint32_t msUntilNext(uint32_t now) {
+        if (!running || restart) return 0;
+        uint32_t spent = now - stepStart;
+        return spent < entries[index].durationMs ? entries[index].durationMs - spent : 0;
+    }
+
+private:
+    static PlaylistEntry entries[LED_MAX_PLAYLIST];
+    static uint8_t numEntries;
+    static uint8_t index;
+    static uint32_t stepStart;    // effectTime.now when the current entry began
+    static volatile bool running;
+    static volatile bool restart;
+    static bool looping;
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+PlaylistEntry LEDPlaylist::entries[LED_MAX_PLAYLIST];
+uint8_t LEDPlaylist::numEntries = 0;
+uint8_t LEDPlaylist::index = 0;
+uint32_t LEDPlaylist::stepStart = 0;
+volatile bool LEDPlaylist::running = false;
+volatile bool LEDPlaylist::restart = false;
+bool LEDPlaylist::looping = true;
+
+#endif // LED_PLAYLIST_H
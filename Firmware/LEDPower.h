@@ -0,0 +1,168 @@
+/*
+ * LEDPower.h - Current estimate and power limiting
+ *
+ * Estimates the draw of every output from the frame being sent and scales
+ * outputs down that would exceed their own or the supply's budget
+ */
+
+#ifndef LED_POWER_H
+#define LED_POWER_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <ArduinoJson.h>
+#include "Config.h"
+
+// ============================================================================
+// LEDPower - Per-output current estimate and limiter
+// ============================================================================
+// Replaces FastLED.setMaxPowerInMilliWatts(), which walks every LED again
+// inside each show() and turns the whole strip down by one factor. Here the
+// output stage sums each channel of a slice right after writing it (the
+// data is still in cache) and hands the sums to limit() before the frame
+// goes out:
+//
+//   - an output with a budget of its own (maxMa in the output map - the
+//     injection point feeding that pin) is scaled down to it
+//   - if all outputs together still exceed LED_POWER_LIMIT_MW, every
+//     output is scaled by the same factor on top
+//
+// Outputs within budget are left alone, so one bright section doesn't dim
+// the rest of the tree. The model is FastLED's (mA per channel at full,
+// plus the idle draw of each LED's driver chip). The double-buffered output
+// sums values that already carry the strip's color correction; with a
+// single buffer FastLED applies it during show(), so it is folded in here.
+// ============================================================================
+
+class LEDPower {
+public:
+    // WS2812 draw at full value (FastLED's power model, 5 V)
+    static constexpr uint8_t RED_MA = 16;
+    static constexpr uint8_t GREEN_MA = 11;
+    static constexpr uint8_t BLUE_MA = 15;
+    static constexpr uint8_t IDLE_MA = 1;   // Per LED, even when dark
+
+    static constexpr uint8_t MAX_OUTPUTS = LED_OUTPUT_MAX_PINS;
+
+    // Channel sums and draw of one output's slice in the current frame
+    struct Load {
+        uint32_t sums[3];
+        uint16_t count;
+        uint16_t maxMa;     // Output's own budget, 0 = none
+        uint32_t ma;        // Estimate before limiting
+        uint8_t scale;      // Applied by limit() (255 = untouched)
+    };
+
+    // Per-channel sums of count LEDs
+    static void measure(const CRGB* buf, uint16_t count, uint32_t sums[3]) {
+        const uint8_t* p = (const uint8_t*)buf;
+        uint32_t r = 0, g = 0, b = 0;
+        for (uint32_t i = 0; i < count * 3u; i += 3) {
+            r += p[i];
+            g += p[i + 1];
+            b += p[i + 2];
+        }
+        sums[0] = r;
+        sums[1] = g;
+        sums[2] = b;
+    }
+
+    // Work out the scale of every output (loads[o].scale) and record the
+    // frame's totals. Returns true if any output has to be scaled.
+    static bool limit(Load* loads, uint8_t numLoads) {
+        uint32_t idle = 0, wanted = 0;
+        uint32_t target[MAX_OUTPUTS];
+        for (uint8_t o = 0; o < numLoads; o++) {
+            Load& l = loads[o];
+            uint32_t outIdle = l.count * IDLE_MA;
+            uint32_t dynamic = dynamicMa(l.sums);
+            l.ma = outIdle + dynamic;
+            target[o] = dynamic;
+            if (l.maxMa != 0 && l.ma > l.maxMa) {
+                target[o] = l.maxMa > outIdle ? l.maxMa - outIdle : 0;
+            }
+            idle += outIdle;
+            wanted += target[o];
+        }
+
+        uint32_t supplyMa = LED_POWER_LIMIT_MW / LED_POWER_VOLTS;
+        if (supplyMa != 0 && wanted != 0 && idle + wanted > supplyMa) {
+            uint32_t available = supplyMa > idle ? supplyMa - idle : 0;
+            for (uint8_t o = 0; o < numLoads; o++) {
+                target[o] = (uint64_t)target[o] * available / wanted;
+            }
+        }
+
+        bool limited = false;
+        uint32_t total = idle, requested = 0;
+        for (uint8_t o = 0; o < numLoads; o++) {
+            Load& l = loads[o];
+            uint32_t dynamic = l.ma - l.count * IDLE_MA;
+            requested += l.ma;
+            l.scale = 255;
+            if (target[o] < dynamic) {
+                // nscale8(s) keeps (s + 1)/256 of each value
+                uint32_t s = (uint64_t)target[o] * 256 / dynamic;
+                l.scale = s > 0 ? s - 1 : 0;
+                limited = true;
+                total += (uint64_t)dynamic * (l.scale + 1) / 256;
+            } else {
+                total += dynamic;
+            }
+            outputMa[o] = l.ma;
+        }
+
+        frameMa = total;
+        requestedMa = requested;
+        limiting = limited;
+        return limited;
+    }
+
+    // Last frame sent: estimated draw after limiting, and what it asked for
+    static uint32_t getMilliamps() { return frameMa; }
+    static uint32_t getRequestedMilliamps() { return requestedMa; }
+    static uint32_t getMilliwatts() { return frameMa * LED_POWER_VOLTS; }
+    static bool isLimiting() { return limiting; }
+
+    // Estimate of one output before limiting
+    static uint32_t getOutputMilliamps(uint8_t o) { return o < MAX_OUTPUTS ? outputMa[o] : 0; }
+
+    static void getStatusJson(JsonObject obj) {
+        obj["mA"] = frameMa;
+        obj["W"] = getMilliwatts() / 1000.0f;
+        obj["requestedMa"] = requestedMa;
+        obj["limitMw"] = LED_POWER_LIMIT_MW;
+        obj["limited"] = limiting;
+    }
+
+private:
+    static volatile uint32_t frameMa;
+    static volatile uint32_t requestedMa;
+    static volatile bool limiting;
+    static volatile uint32_t outputMa[MAX_OUTPUTS];
+
+    // Channel draw (without idle), through the strip's color correction
+    // where FastLED still applies it
+    static uint32_t dynamicMa(const uint32_t sums[3]) {
+#if LED_OUTPUT_DOUBLE_BUFFER
+        const CRGB correction(UncorrectedColor);
+#else
+        const CRGB correction(LED_COLOR_CORRECTION);
+#endif
+        uint64_t weighted = (uint64_t)sums[0] * RED_MA * (correction.r + 1)
+                          + (uint64_t)sums[1] * GREEN_MA * (correction.g + 1)
+                          + (uint64_t)sums[2] * BLUE_MA * (correction.b + 1);
+        return weighted / (255u * 256u);
+    }
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+volatile uint32_t LEDPower::frameMa = 0;
+volatile uint32_t LEDPower::requestedMa = 0;
+volatile bool LEDPower::limiting = false;
+volatile uint32_t LEDPower::outputMa[LEDPower::MAX_OUTPUTS] = {};
+
+#endif // LED_POWER_H
@@ -0,0 +1,228 @@
+/*
+ * LEDSegments.h - Independent effects on sub-ranges of the strip
+ *
+ * Each segment runs its own effect, params, brightness and frame rate
+ */
+
+#ifndef LED_SEGMENTS_H
+#define LED_SEGMENTS_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "EffectDefs.h"
+#include "LEDGeometry.h"
+#include "EffectTable.h"
+#include "EffectInstance.h"
+#include "TileRenderer.h"
+#include "Compositor.h"
+#include "LEDStats.h"
+
+// ============================================================================
+// LEDSegments - Segment storage, rendering and composition
+// ============================================================================
+// Every segment owns a render buffer of its own length. To render one, the
+// global leds/NUM_LEDS are pointed at that buffer and the segment's params
+// are copied into the effect's global xxxParams struct, so effects run
+// unchanged. The segment list is the layer stack: Compositor blends the
+// buffers into the frame in list order (first = bottom), each with its own
+// blend mode and brightness, which leaves each effect's own buffer unscaled
+// for the next frame. Segments may overlap - e.g. Glitter with BLEND_ADD
+// over Fire on the same range replaces the old per-effect overlay flags,
+// which now only decide whether an effect keeps its own previous frame.
+//
+// Segments running a static effect (category 1) render once and then only
+// re-render after a change; others render every fpsDivider frames and see
+// the time since their last render, so a divider lowers the update rate but
+// not the animation speed.
+//
+// Every segment also owns an EffectInstance, so two segments running the
+// same effect animate independently and an effect change starts it fresh.
+//
+// All access goes through lock()/unlock() - the LED task holds the lock for
+// a whole frame, the web API while editing.
+// ============================================================================
+
+struct Segment {
+    uint16_t start;
+    uint16_t length;
+    uint8_t effect;
+    uint8_t brightness;
+    uint8_t fpsDivider;   // Render every Nth frame (1 = every frame)
+    BlendMode blend;      // How the segment is laid over the ones before it
+    bool dirty;           // Needs a render even if static/not due
+    uint32_t lastRender8; // effectTime.ticks8 of the last render
+    CRGB* buffer;         // Segment render buffer (length LEDs)
+    EffectInstance state; // Effect animation state
+    uint8_t params[maxEffectParamsSize()];
+};
+
+class LEDSegments {
+public:
+    static bool begin() {
+        mutex = xSemaphoreCreateMutex();
+        if (mutex == NULL) {
+            LOG_ERROR("Failed to create segment mutex!");
+            return false;
+        }
+        return true;
+    }
+
+    static void lock() {
+        if (mutex != NULL) xSemaphoreTake(mutex, portMAX_DELAY);
+    }
+
+    static void unlock() {
+        if (mutex != NULL) xSemaphoreGive(mutex);
+    }
+
+    // True when the strip is split into segments (otherwise the single
+    // current effect owns the whole strip)
+    static bool isActive() { return numSegments > 0; }
+    static uint8_t count() { return numSegments; }
+    static Segment& get(uint8_t id) { return segments[id]; }
+
+    // True when every segment shows a static effect that is already rendered
+    static bool isStatic() {
+        for (uint8_t i = 0; i < numSegments; i++) {
+            if (segments[i].dirty || !isStaticEffect(segments[i].effect)) return false;
+        }
+        return true;
+    }
+
+    // ========================================================================
+    // Segment List (lock held)
+    // ========================================================================
+
+    static void clear() {
+        for (uint8_t i = 0; i < numSegments; i++) {
+            heap_caps_free(segments[i].buffer);
+            segments[i].buffer = nullptr;
+            segments[i].state.release();
+        }
+        numSegments = 0;
+    }
+
+    // Append a segment; params start from the effect's current global values
+    static bool add(uint16_t start, uint16_t length, uint8_t effect,
+                    uint8_t brightness = 255, uint8_t fpsDivider = 1,
+                    BlendMode blend = BLEND_NORMAL) {
+        if (numSegments >= LED_MAX_SEGMENTS || length == 0 ||
+            start + length > NUM_LEDS || effect >= NUM_EFFECT_ENTRIES) {
+            return false;
+        }
+
+        CRGB* buffer = allocLedBuffer<CRGB>(length, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (buffer == nullptr) {
+            buffer = allocLedBuffer<CRGB>(length);
+        }
+        if (buffer == nullptr) {
+            return false;
+        }
+
+        Segment& seg = segments[numSegments];
+        if (!seg.state.init(length)) {
+            heap_caps_free(buffer);
+            return false;
+        }
+        numSegments++;
+        seg.start = start;
+        seg.length = length;
+        seg.buffer = buffer;
+        seg.brightness = brightness;
+        seg.fpsDivider = max((uint8_t)1, fpsDivider);
+        seg.blend = blend;
+        seg.lastRender8 = effectTime.ticks8 - 256;   // First render: one frame
+        setEffect(seg, effect);
+        return true;
+    }
+
+    // Switch a segment to another effect (params reset to the effect's
+    // globals, animation restarts)
+    static void setEffect(Segment& seg, uint8_t effect) {
+        seg.effect = effect;
+        seg.state.reset(effect);
+        memcpy(seg.params, effectTable[effect].params, effectTable[effect].paramsSize);
+        seg.dirty = true;
+    }
+
+    // Run fn() with the segment's params loaded into the effect's global
+    // struct; changes made by fn() are stored back into the segment
+    template<typename F>
+    static void withParams(Segment& seg, F fn) {
+        withParams(seg.effect, seg.params, fn);
+    }
+
+    // Same for any stored params block of an effect (playlist entries)
+    template<typename F>
+    static void withParams(uint8_t effectId, uint8_t* params, F fn) {
+        const EffectEntry& effect = effectTable[effectId];
+        memcpy(savedParams, effect.params, effect.paramsSize);
+        memcpy(effect.params, params, effect.paramsSize);
+
+        fn();
+
+        memcpy(params, effect.params, effect.paramsSize);
+        memcpy(effect.params, savedParams, effect.paramsSize);
+    }
+
+    // ========================================================================
+    // Rendering (LED task, lock held)
+    // ========================================================================
+
+    // Render due segments and compose all of them into leds[]
+    static void renderFrame(uint32_t frame) {
+        CRGB* frameLeds = leds;
+        uint16_t frameLen = NUM_LEDS;
+        Compositor::Layer layers[LED_MAX_SEGMENTS];
+
+        for (uint8_t s = 0; s < numSegments; s++) {
+            Segment& seg = segments[s];
+
+            bool due = seg.dirty ||
+                       (!isStaticEffect(seg.effect) && frame % seg.fpsDivider == 0);
+
+            if (due) {
+                EffectTime frameTime = effectTime;
+                effectTime = effectTimeSince(seg.lastRender8);
+                leds = seg.buffer;
+                numLeds = seg.length;
+                LEDGeometry::setOrigin(seg.start);
+                uint32_t renderStart = LEDStats::cycles();
+                seg.state.bind();
+                withParams(seg, [&seg]() {
+                    TileRenderer::render(effectTable[seg.effect]);
+                });
+                LEDStats::recordEffect(seg.effect, renderStart);
+                leds = frameLeds;
+                numLeds = frameLen;
+                LEDGeometry::setOrigin(0);
+                effectTime = frameTime;
+                seg.lastRender8 = frameTime.ticks8;
+                seg.dirty = false;
+            }
+
+            layers[s] = { seg.buffer, seg.start, seg.length, seg.brightness, seg.blend };
+        }
+
+        Compositor::compose(frameLeds, frameLen, layers, numSegments);
+    }
+
+private:
+    static SemaphoreHandle_t mutex;
+    static Segment segments[LED_MAX_SEGMENTS];
+    static uint8_t numSegments;
+    static uint8_t savedParams[maxEffectParamsSize()];
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+SemaphoreHandle_t LEDSegments::mutex = NULL;
+Segment LEDSegments::segments[LED_MAX_SEGMENTS];
+uint8_t LEDSegments::numSegments = 0;
+uint8_t LEDSegments::savedParams[maxEffectParamsSize()];
+
+#endif // LED_SEGMENTS_H
@@ -0,0 +1,317 @@
+/*
+ * LEDStats.h - Frame timing instrumentation
+ *
+ * Cycle-counter timing of the LED pipeline, per-stage and per-effect
+ */
+
+#ifndef LED_STATS_H
+#define LED_STATS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "EffectTable.h"
+
+// ============================================================================
+// TimingStats - min/avg/max and a histogram of one measured duration
+// ============================================================================
+// Buckets are half-octaves of microseconds (1, 2, 3, 4-5, 6-7, 8-11, ...),
+// so percentiles are accurate to ~25% at any scale and a stats block stays
+// small enough to keep one per effect. The last bucket collects everything
+// from ~49 ms up.
+// ============================================================================
+
+#define LED_STATS_BUCKETS 32
+
+struct TimingStats {
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint32_t overBudget;   // Samples longer than the frame period
+    uint64_t sumUs;
+    uint32_t buckets[LED_STATS_BUCKETS];
+
+    void reset() {
+        memset(this, 0, sizeof(*this));
+        minUs = UINT32_MAX;
+    }
+
+    void add(uint32_t us, uint32_t budgetUs) {
+        count++;
+        sumUs += us;
+        if (us < minUs) minUs = us;
+        if (us > maxUs) maxUs = us;
+        if (us > budgetUs) overBudget++;
+        buckets[bucketOf(us)]++;
+    }
+
+    // Upper bound of the bucket holding the pct-th percentile (capped at max)
+    uint32_t percentile(uint8_t pct) const {
+        if (count == 0) return 0;
+        uint32_t target = ((uint64_t)count * pct + 99) / 100;
+        uint32_t seen = 0;
+        for (uint8_t b = 0; b < LED_STATS_BUCKETS; b++) {
+            seen += buckets[b];
+            if (seen >= target) {
+                return b + 1 < LED_STATS_BUCKETS ? min(bucketStart(b + 1) - 1, maxUs) : maxUs;
+            }
+        }
+        return maxUs;
+    }
+
+    void toJson(JsonObject obj) const {
+        obj["count"] = count;
+        obj["minUs"] = count ? minUs : 0;
+        obj["avgUs"] = count ? (uint32_t)(sumUs / count) : 0;
+        obj["p99Us"] = percentile(99);
+        obj["maxUs"] = maxUs;
+        obj["overBudget"] = overBudget;
+    }
+
+    static uint8_t bucketOf(uint32_t us) {
+        if (us < 2) return us;
+        uint8_t msb = 31 - __builtin_clz(us);
+        uint8_t b = 2 * msb + ((us >> (msb - 1)) & 1);
+        return b < LED_STATS_BUCKETS ? b : LED_STATS_BUCKETS - 1;
+    }
+
+    static uint32_t bucketStart(uint8_t b) {
+        return b < 2 ? b : (2u + (b & 1)) << (b / 2 - 1);
+    }
+};
+
+// ============================================================================
+// LEDStats - Pipeline timing collected by the LED and show tasks
+// ============================================================================
+// Stages are timed with the CPU cycle counter (ESP.getCycleCount()); the
+// LED task and the show task both run on Core 0, so start and end stamps
+// come from the same counter. Effect renders are also kept per effect.
+//
+// Only the LED and show tasks write, each update inside a short critical
+// section (mux); getJson() copies the counters and stage blocks in one such
+// section and each effect's block in its own, then serializes the copies on
+// the web task - no torn 64-bit sums or counts that don't match their
+// histograms. Resets are requested and carried out by the LED task at the
+// start of its next frame.
+// ============================================================================
+
+class LEDStats {
+public:
+    enum Stage : uint8_t {
+        STAGE_RENDER = 0,   // Effect / segment render incl. composition, transitions
+        STAGE_CROSSFADE,    // Transition blend (part of render)
+        STAGE_PRESENT,      // Frame hash + copy to the output buffer
+        STAGE_SHOW,         // FastLED.show() (show task)
+        STAGE_FRAME,        // LED task busy time per frame
+        NUM_STAGES
+    };
+
+    static void begin(uint32_t framePeriodMs) {
+        cpuMhz = ESP.getCpuFreqMHz();
+        budgetUs = framePeriodMs * 1000;
+        resetNow();
+    }
+
+    static inline uint32_t cycles() {
+        return ESP.getCycleCount();
+    }
+
+    // Record the time since startCycles
+    static void record(Stage stage, uint32_t startCycles) {
+        uint32_t us = elapsedUs(startCycles);
+        portENTER_CRITICAL(&mux);
+        stages[stage].add(us, budgetUs);
+        portEXIT_CRITICAL(&mux);
+    }
+
+    static void recordEffect(uint8_t effect, uint32_t startCycles) {
+        if (effect < NUM_EFFECT_ENTRIES) {
+            uint32_t us = elapsedUs(startCycles);
+            portENTER_CRITICAL(&mux);
+            effects[effect].add(us, budgetUs);
+            portEXIT_CRITICAL(&mux);
+#if LED_EFFECT_CHECKS
+            checkEffect(effect, us);
+#endif
+        }
+    }
+
+    // End of an LED task frame; shown = frame went to the strip
+    static void frameDone(uint32_t frameStartCycles, bool shown) {
+        record(STAGE_FRAME, frameStartCycles);
+        uint32_t now = millis();
+
+        portENTER_CRITICAL(&mux);
+        framesRendered++;
+        if (shown) framesShown++;
+
+        // Achieved rates over ~1 s windows
+        windowRendered++;
+        if (shown) windowShown++;
+        if (now - windowStart >= 1000) {
+            uint32_t span = now - windowStart;
+            fpsRendered = windowRendered * 1000.0f / span;
+            fpsShown = windowShown * 1000.0f / span;
+            windowStart = now;
+            windowRendered = 0;
+            windowShown = 0;
+        }
+        portEXIT_CRITICAL(&mux);
+    }
+
+    // The LED task started a frame after its deadline had passed
+    static void missedDeadline() {
+        portENTER_CRITICAL(&mux);
+        missedDeadlines++;
+        portEXIT_CRITICAL(&mux);
+    }
+
+    // Called by the LED task at the start of each frame
+    static void service() {
+        if (resetRequested) {
+            resetNow();
+        }
+    }
+
+    static void requestReset() {
+        resetRequested = true;
+    }
+
+    static void getJson(JsonDocument& doc) {
+        TimingStats stageCopy[NUM_STAGES];
+        portENTER_CRITICAL(&mux);
+        memcpy(stageCopy, stages, sizeof(stages));
+        float fps = fpsRendered;
+        float shownFps = fpsShown;
+        uint32_t frames = framesRendered;
+        uint32_t shown = framesShown;
+        uint32_t missed = missedDeadlines;
+        uint32_t since = resetTime;
+        portEXIT_CRITICAL(&mux);
+
+        doc["cpuMhz"] = cpuMhz;
+        doc["budgetUs"] = budgetUs;
+        doc["fps"] = fps;
+        doc["shownFps"] = shownFps;
+        doc["frames"] = frames;
+        doc["framesShown"] = shown;
+        doc["missedDeadlines"] = missed;
+        doc["uptimeMs"] = millis() - since;
+
+        JsonObject st = doc["stages"].to<JsonObject>();
+        for (uint8_t s = 0; s < NUM_STAGES; s++) {
+            stageCopy[s].toJson(st[stageNames[s]].to<JsonObject>());
+        }
+
+        // Only effects that have run since the last reset (one block on the
+        // stack at a time - all of them would not fit the web task's)
+        JsonArray arr = doc["effects"].to<JsonArray>();
+        for (uint8_t e = 0; e < NUM_EFFECT_ENTRIES; e++) {
+            TimingStats fx;
+            portENTER_CRITICAL(&mux);
+            fx = effects[e];
+            portEXIT_CRITICAL(&mux);
+            if (fx.count == 0) continue;
+            JsonObject obj = arr.add<JsonObject>();
+            obj["id"] = e;
+            obj["name"] = effectTable[e].name;
+            fx.toJson(obj);
+        }
+    }
+
+private:
+    static TimingStats stages[NUM_STAGES];
+    static TimingStats effects[NUM_EFFECT_ENTRIES];
+    static uint32_t cpuMhz;
+    static uint32_t budgetUs;
+    static uint32_t framesRendered;
+    static uint32_t framesShown;
+    static uint32_t missedDeadlines;
+    static uint32_t resetTime;
+    static uint32_t windowStart;
+    static uint32_t windowRendered;
+    static uint32_t windowShown;
+    static float fpsRendered;
+    static float fpsShown;
+    static volatile bool resetRequested;
+    static portMUX_TYPE mux;         // Guards the stats blocks and counters
+
+    static constexpr const char* stageNames[NUM_STAGES] = {
+        "render", "crossfade", "present", "show", "frame"
+    };
+
+    static uint32_t elapsedUs(uint32_t startCycles) {
+        return (cycles() - startCycles) / cpuMhz;
+    }
+
+#if LED_EFFECT_CHECKS
+    static uint8_t effectWarned[NUM_EFFECT_ENTRIES];   // WARN_* bits already logged
+
+    static constexpr uint8_t WARN_BLOCKING = 1;
+    static constexpr uint8_t WARN_SLICE = 2;
+
+    // Report contract violations (Effects.h) - once per effect and kind
+    static void checkEffect(uint8_t effect, uint32_t us) {
+        const char* call = effectViolation;
+        if (call != nullptr) {
+            effectViolation = nullptr;
+            if (!(effectWarned[effect] & WARN_BLOCKING)) {
+                effectWarned[effect] |= WARN_BLOCKING;
+                LOG_PRINTF("WARN ", "Effect '%s' called %s (dropped) - effects must not block or show",
+                           effectTable[effect].name, call);
+            }
+        }
+
+        uint32_t sliceUs = budgetUs * LED_EFFECT_SLICE_PCT / 100;
+        if (us > sliceUs && !(effectWarned[effect] & WARN_SLICE)) {
+            effectWarned[effect] |= WARN_SLICE;
+            LOG_PRINTF("WARN ", "Effect '%s' took %lu us (slice %lu us)",
+                       effectTable[effect].name, (unsigned long)us, (unsigned long)sliceUs);
+        }
+    }
+#endif
+
+    static void resetNow() {
+        portENTER_CRITICAL(&mux);
+        for (uint8_t s = 0; s < NUM_STAGES; s++) stages[s].reset();
+        for (uint8_t e = 0; e < NUM_EFFECT_ENTRIES; e++) effects[e].reset();
+        framesRendered = 0;
+        framesShown = 0;
+        missedDeadlines = 0;
+        resetTime = millis();
+        windowStart = resetTime;
+        windowRendered = 0;
+        windowShown = 0;
+        fpsRendered = 0;
+        fpsShown = 0;
+        resetRequested = false;
+        portEXIT_CRITICAL(&mux);
+    }
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+TimingStats LEDStats::stages[LEDStats::NUM_STAGES];
+TimingStats LEDStats::effects[NUM_EFFECT_ENTRIES];
+uint32_t LEDStats::cpuMhz = 240;
+uint32_t LEDStats::budgetUs = 1000000 / LED_TARGET_FPS;
+uint32_t LEDStats::framesRendered = 0;
+uint32_t LEDStats::framesShown = 0;
+uint32_t LEDStats::missedDeadlines = 0;
+uint32_t LEDStats::resetTime = 0;
+uint32_t LEDStats::windowStart = 0;
+uint32_t LEDStats::windowRendered = 0;
+uint32_t LEDStats::windowShown = 0;
+float LEDStats::fpsRendered = 0;
+float LEDStats::fpsShown = 0;
+volatile bool LEDStats::resetRequested = false;
+portMUX_TYPE LEDStats::mux = portMUX_INITIALIZER_UNLOCKED;
+
+#if LED_EFFECT_CHECKS
+uint8_t LEDStats::effectWarned[NUM_EFFECT_ENTRIES] = {};
+#endif
+
+#endif // LED_STATS_H
@@ -0,0 +1,255 @@
+/*
+ * LEDTransition.h - Crossfade between effects
+ *
+ * Keeps the outgoing effect animating while the incoming one fades in
+ */
+
+#ifndef LED_TRANSITION_H
+#define LED_TRANSITION_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "EffectDefs.h"
+#include "EffectTable.h"
+#include "EffectInstance.h"
+#include "TileRenderer.h"
+#include "LEDStats.h"
+#include "ColorPipeline.h"
+#include "HDRFrame.h"
+
+// ============================================================================
+// Transition Curves
+// ============================================================================
+
+enum TransitionCurve : uint8_t {
+    CURVE_LINEAR = 0,
+    CURVE_EASE_IN,        // Slow start
+    CURVE_EASE_OUT,       // Slow end
+    CURVE_EASE_IN_OUT,    // Slow start and end
+    CURVE_COUNT
+};
+
+// ============================================================================
+// LEDTransition - Concurrent crossfade on effect change (LED task only)
+// ============================================================================
+// start() hands the outgoing effect its own state and render buffer: the
+// instance that was running it is swapped in (no copy), its buffer starts
+// from the frame on the strip. While the transition runs, render() draws
+// both effects into their buffers every frame - each keeps its own history
+// for trails and fades - and mixes them in one pass. The mix is done at 16
+// bits in output light (after color correction, ColorPipeline::mix()) into
+// the HDRFrame buffer, so slow fades between dark scenes don't step and the
+// blend is perceived evenly; leds[] is not written meanwhile. At the end
+// the incoming frame is copied to leds[] and the effect carries on there.
+//
+// The outgoing effect also keeps a copy of the params it was rendering
+// with (its globals, or a playlist entry's own block), taken at start()
+// before the caller switches params - a playlist step to the same effect
+// with other params then fades between the two settings instead of
+// rendering both sides with the new ones.
+//
+// The first effect after boot fades in over the startup animation, which
+// has no effect behind it and stays as a still frame (NO_EFFECT).
+//
+// A change during a transition keeps whichever side dominates the frame as
+// the new outgoing effect, so the picture never jumps by more than half.
+//
+// configure() sets the default duration and curve; a caller may pass its
+// own to start() (playlist steps carry one each).
+// ============================================================================
+
+class LEDTransition {
+public:
+    static constexpr uint8_t NO_EFFECT = 0xFF;
+
+    // Allocate both effect buffers and the outgoing state (after allocLeds())
+    static bool begin() {
+        outLeds = allocRenderBuffer();
+        inLeds = allocRenderBuffer();
+        if (outLeds == nullptr || inLeds == nullptr || !outgoing.init(NUM_LEDS)) {
+            LOG_ERROR("Failed to allocate transition buffers!");
+            return false;
+        }
+        return true;
+    }
+
+    // Default transition for effect changes
+    static void configure(uint16_t duration, TransitionCurve curve) {
+        durationMs = min<uint16_t>(duration, LED_TRANSITION_MAX_MS);
+        transitionCurve = curve < CURVE_COUNT ? curve : CURVE_LINEAR;
+    }
+
+    static uint16_t getDuration() { return durationMs; }
+    static TransitionCurve getCurve() { return transitionCurve; }
+    static bool isActive() { return active; }
+
+    // The effect changed. from = effect shown so far, fromParams = the
+    // params block it rendered with, incoming = instance that will run the
+    // new effect (reset by the caller afterwards). Call before switching
+    // params. Returns false for a 0 ms transition - the caller hard-cuts.
+    static bool start(uint8_t from, const uint8_t* fromParams, EffectInstance& incoming) {
+        return start(from, fromParams, incoming, durationMs, transitionCurve);
+    }
+
+    static bool start(uint8_t from, const uint8_t* fromParams, EffectInstance& incoming,
+                      uint16_t duration, TransitionCurve curve) {
+        if (duration == 0 || outLeds == nullptr) {
+            active = false;
+            return false;
+        }
+
+        if (!active) {
+            memcpy(outLeds, leds, NUM_LEDS * sizeof(CRGB));
+            outgoing.swap(incoming);
+            setOutgoing(from, fromParams);
+        } else if (position() >= 128) {
+            // Incoming already dominates - it becomes the outgoing effect
+            CRGB* tmp = outLeds;
+            outLeds = inLeds;
+            inLeds = tmp;
+            outgoing.swap(incoming);
+            setOutgoing(from, fromParams);
+        }
+        // else: outgoing stays, the half-faded incoming effect is dropped
+
+        LEDKernels::fill(inLeds, NUM_LEDS, CRGB::Black);
+        runMs = min<uint16_t>(duration, LED_TRANSITION_MAX_MS);
+        runCurve = curve < CURVE_COUNT ? curve : CURVE_LINEAR;
+        elapsedMs = 0;
+        active = true;
+        return true;
+    }
+
+    // Render one transition frame of effect (running on incoming) into leds[]
+    static void render(uint8_t effect, EffectInstance& incoming) {
+        CRGB* frame = leds;
+
+        if (outEffect != NO_EFFECT) {
+            // Outgoing side renders with its own params
+            const EffectEntry& out = effectTable[outEffect];
+            memcpy(savedParams, out.params, out.paramsSize);
+            memcpy(out.params, outParams, out.paramsSize);
+            leds = outLeds;
+            outgoing.bind();
+            uint32_t start = LEDStats::cycles();
+            TileRenderer::render(out);
+            LEDStats::recordEffect(outEffect, start);
+            memcpy(out.params, savedParams, out.paramsSize);
+        }
+
+        leds = inLeds;
+        incoming.bind();
+        uint32_t start = LEDStats::cycles();
+        TileRenderer::render(effectTable[effect]);
+        LEDStats::recordEffect(effect, start);
+
+        leds = frame;
+
+        start = LEDStats::cycles();
+        elapsedMs += effectTime.dt;
+        if (elapsedMs >= runMs) {
+            memcpy(frame, inLeds, NUM_LEDS * sizeof(CRGB));
+            active = false;
+        } else {
+            uint16_t amount = applyCurve(position16());
+            if (HDRFrame::isAvailable()) {
+                ColorPipeline::mix(HDRFrame::mixBuffer(), outLeds, inLeds, NUM_LEDS, amount);
+                HDRFrame::setMixed();
+            } else {
+                LEDKernels::blend(frame, outLeds, inLeds, NUM_LEDS, amount >> 8);
+            }
+        }
+        LEDStats::record(LEDStats::STAGE_CROSSFADE, start);
+    }
+
+    // ========================================================================
+    // Curves
+    // ========================================================================
+
+    static uint16_t applyCurve(uint16_t x) {
+        switch (runCurve) {
+            case CURVE_EASE_IN:     return scale16(x, x);
+            case CURVE_EASE_OUT:    return 65535 - scale16(65535 - x, 65535 - x);
+            case CURVE_EASE_IN_OUT: return ease16InOutQuad(x);
+            default:                return x;
+        }
+    }
+
+    static const char* curveName(TransitionCurve curve) {
+        return curve < CURVE_COUNT ? curveNames[curve] : "linear";
+    }
+
+    static bool parseCurve(const char* name, TransitionCurve& curve) {
+        if (name == nullptr) return false;
+        for (uint8_t c = 0; c < CURVE_COUNT; c++) {
+            if (!strcmp(name, curveNames[c])) {
+                curve = (TransitionCurve)c;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static CRGB* outLeds;          // Outgoing effect's render buffer
+    static CRGB* inLeds;           // Incoming effect's render buffer
+    static EffectInstance outgoing;
+    static uint8_t outEffect;
+    static uint8_t outParams[maxEffectParamsSize()];   // Outgoing effect's params
+    static uint8_t savedParams[maxEffectParamsSize()]; // Globals while it renders
+    static uint16_t durationMs;            // Defaults
+    static TransitionCurve transitionCurve;
+    static uint16_t runMs;                 // Running transition
+    static TransitionCurve runCurve;
+    static uint32_t elapsedMs;
+    static bool active;
+
+    static constexpr const char* curveNames[CURVE_COUNT] = {
+        "linear", "easeIn", "easeOut", "easeInOut"
+    };
+
+    // Make from the outgoing effect, with its params as they are now
+    static void setOutgoing(uint8_t from, const uint8_t* fromParams) {
+        outEffect = from;
+        if (from != NO_EFFECT) {
+            memcpy(outParams, fromParams, effectTable[from].paramsSize);
+        }
+    }
+
+    // Linear progress 0-255
+    static uint8_t position() {
+        return position16() >> 8;
+    }
+
+    // Linear progress 0-65535
+    static uint16_t position16() {
+        return runMs ? min<uint32_t>(elapsedMs * 65535 / runMs, 65535) : 65535;
+    }
+
+    // Effects write these every frame - prefer internal RAM
+    static CRGB* allocRenderBuffer() {
+        CRGB* buf = allocLedBuffer<CRGB>(NUM_LEDS, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        return buf != nullptr ? buf : allocLedBuffer<CRGB>(NUM_LEDS);
+    }
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+CRGB* LEDTransition::outLeds = nullptr;
+CRGB* LEDTransition::inLeds = nullptr;
+EffectInstance LEDTransition::outgoing;
+uint8_t LEDTransition::outEffect = LEDTransition::NO_EFFECT;
+uint8_t LEDTransition::outParams[maxEffectParamsSize()];
+uint8_t LEDTransition::savedParams[maxEffectParamsSize()];
+uint16_t LEDTransition::durationMs = LED_TRANSITION_MS;
+TransitionCurve LEDTransition::transitionCurve = CURVE_EASE_IN_OUT;
+uint16_t LEDTransition::runMs = 0;
+TransitionCurve LEDTransition::runCurve = CURVE_LINEAR;
+uint32_t LEDTransition::elapsedMs = 0;
+bool LEDTransition::active = false;
+
+#endif // LED_TRANSITION_H
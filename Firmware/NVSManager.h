@@ -116,6 +116,14 @@ public:
         prefs.remove(NVS_KEY_LED_EFFECT);
         prefs.remove("led_bright");
         prefs.remove("led_params");
+        prefs.remove(NVS_KEY_LED_COUNT);
+        prefs.remove(NVS_KEY_LED_OUTPUTS);
+        prefs.remove(NVS_KEY_LED_SEGMENTS);
+        prefs.remove(NVS_KEY_LED_TRANS_MS);
+        prefs.remove(NVS_KEY_LED_TRANS_CURVE);
+        prefs.remove(NVS_KEY_LED_PLAYLIST);
+        prefs.remove(NVS_KEY_LED_COLOR);
+        prefs.remove(NVS_KEY_LED_GEOMETRY);
         
         LOG_INFO("Credentials cleared - device reset to factory state");
     }
@@ -146,6 +154,34 @@ public:
         return prefs.getUChar("led_bright", 0xFF);
     }
     
+    // Save effect transition (duration in ms, TransitionCurve)
+    static void saveTransition(uint16_t durationMs, uint8_t curve) {
+        prefs.putUShort(NVS_KEY_LED_TRANS_MS, durationMs);
+        prefs.putUChar(NVS_KEY_LED_TRANS_CURVE, curve);
+        LOG_PRINTF("DEBUG", "Transition saved to NVS: %d ms, curve %d", durationMs, curve);
+    }
+    
+    // Load effect transition from NVS (returns false if not set)
+    static bool loadTransition(uint16_t& durationMs, uint8_t& curve) {
+        if (!prefs.isKey(NVS_KEY_LED_TRANS_MS)) {
+            return false;
+        }
+        durationMs = prefs.getUShort(NVS_KEY_LED_TRANS_MS, LED_TRANSITION_MS);
+        curve = prefs.getUChar(NVS_KEY_LED_TRANS_CURVE, 0);
+        return true;
+    }
+    
+    // Save output color correction as JSON string
+    static void saveColor(const String& colorJson) {
+        prefs.putString(NVS_KEY_LED_COLOR, colorJson);
+        LOG_DEBUG("Color settings saved to NVS");
+    }
+    
+    // Load output color correction from NVS
+    static String loadColor() {
+        return prefs.getString(NVS_KEY_LED_COLOR, "");
+    }
+    
     // Save effect parameters to NVS as JSON string
     static void saveParams(const String& paramsJson) {
         prefs.putString("led_params", paramsJson);
@@ -157,6 +193,85 @@ public:
         return prefs.getString("led_params", "");
     }
     
+    // Save strip length to NVS (applied on next boot)
+    static void saveLedCount(uint16_t count) {
+        prefs.putUShort(NVS_KEY_LED_COUNT, count);
+        LOG_PRINTF("DEBUG", "LED count saved to NVS: %d", count);
+    }
+    
+    // Load strip length from NVS (ARGB_NUM_LEDS if not set or out of range)
+    static uint16_t loadLedCount() {
+        uint16_t count = prefs.getUShort(NVS_KEY_LED_COUNT, ARGB_NUM_LEDS);
+        if (count == 0 || count > ARGB_MAX_LEDS) {
+            LOG_PRINTF("WARN ", "Invalid LED count in NVS (%d) - using %d", count, ARGB_NUM_LEDS);
+            count = ARGB_NUM_LEDS;
+        }
+        return count;
+    }
+    
+    // Save output map (JSON array, applied on next boot; empty = default split)
+    static void saveOutputMap(const String& mapJson) {
+        if (mapJson.isEmpty()) {
+            prefs.remove(NVS_KEY_LED_OUTPUTS);
+        } else {
+            prefs.putString(NVS_KEY_LED_OUTPUTS, mapJson);
+        }
+        LOG_DEBUG("Output map saved to NVS");
+    }
+    
+    // Load output map from NVS
+    static String loadOutputMap() {
+        return prefs.getString(NVS_KEY_LED_OUTPUTS, "");
+    }
+    
+    // Save tree geometry as JSON string (applied on next boot)
+    static void saveGeometry(const String& geometryJson) {
+        prefs.putString(NVS_KEY_LED_GEOMETRY, geometryJson);
+        LOG_DEBUG("Geometry saved to NVS");
+    }
+    
+    // Load tree geometry from NVS (empty = plain strip)
+    static String loadGeometry() {
+        return prefs.getString(NVS_KEY_LED_GEOMETRY, "");
+    }
+    
+    // Save segment list as JSON string (empty = no segments). Returns false
+    // if it is too long for an NVS string or the write fails - the stored
+    // list is then left as it was.
+    static bool saveSegments(const String& segmentsJson) {
+        if (segmentsJson.isEmpty()) {
+            prefs.remove(NVS_KEY_LED_SEGMENTS);
+        } else if (!putJson(NVS_KEY_LED_SEGMENTS, segmentsJson)) {
+            LOG_PRINTF("ERROR", "Segments not saved (%u bytes of JSON)", segmentsJson.length());
+            return false;
+        }
+        LOG_DEBUG("Segments saved to NVS");
+        return true;
+    }
+    
+    // Load segment list from NVS
+    static String loadSegments() {
+        return prefs.getString(NVS_KEY_LED_SEGMENTS, "");
+    }
+    
+    // Save playlist as JSON string (empty = no playlist); false as for
+    // saveSegments()
+    static bool savePlaylist(const String& playlistJson) {
+        if (playlistJson.isEmpty()) {
+            prefs.remove(NVS_KEY_LED_PLAYLIST);
+        } else if (!putJson(NVS_KEY_LED_PLAYLIST, playlistJson)) {
+            LOG_PRINTF("ERROR", "Playlist not saved (%u bytes of JSON)", playlistJson.length());
+            return false;
+        }
+        LOG_DEBUG("Playlist saved to NVS");
+        return true;
+    }
+    
+    // Load playlist from NVS
+    static String loadPlaylist() {
+        return prefs.getString(NVS_KEY_LED_PLAYLIST, "");
+    }
+    
     // Get stored SSID (for display purposes)
     static String getSSID() {
         return prefs.getString(NVS_KEY_SSID, "");
@@ -170,6 +285,15 @@ public:
 private:
     static Preferences prefs;
     
+    // Store a JSON string; putString() cannot hold NVS_MAX_STRING_LEN bytes
+    // or more, so longer values are refused up front
+    static bool putJson(const char* key, const String& json) {
+        if (json.length() >= NVS_MAX_STRING_LEN) {
+            return false;
+        }
+        return prefs.putString(key, json) == json.length();
+    }
+    
     // Log stored credentials (for debugging)
     static void logStoredCredentials() {
         String ssid = prefs.getString(NVS_KEY_SSID, "");
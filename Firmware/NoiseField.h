@@ -0,0 +1,159 @@
+/*
+ * NoiseField.h - Cached Perlin noise along the strip
+ *
+ * Samples inoise8 on a coarse lattice once per keyframe and interpolates
+ * it across pixels and frames in fixed point
+ */
+
+#ifndef NOISE_FIELD_H
+#define NOISE_FIELD_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "EffectDefs.h"
+
+// ============================================================================
+// NoiseField - Lattice-sampled 1D noise with time keyframes
+// ============================================================================
+// Noise effects read inoise8(i * scale + x, t + y) for every LED, every
+// frame - the Perlin evaluation is most of their frame on long strips. The
+// noise varies smoothly over a 256-unit lattice cell, so here it is sampled
+// only every 2^shift LEDs (about NOISE_FIELD_SPACING units apart) and at
+// time keyframes NOISE_FIELD_KEY units apart:
+//
+//   keyframe rows   lattice samples at the keyframe before t and after it;
+//                   re-sampled only when t crosses a keyframe (every few
+//                   frames at typical speeds)
+//   current row     the two rows mixed by t's position between them, once
+//                   per frame
+//   pixels          linear interpolation between current-row samples
+//
+// Several layers (x/y offsets of the same noise, averaged) are folded into
+// one row when it is sampled. The rows live in the effect's per-LED state
+// (NOISE_FIELD_LED_STATE bytes per LED), so every segment and transition
+// instance has its own.
+//
+// update() belongs in the effect's advance() (single-threaded, after the
+// tiles) and prepares the next frame; forEach() is safe to run from both
+// tiles. Until the rows match the current time and scale - first frame
+// after a reset, a scale change, scales too fine to interpolate, tiny
+// strips - forEach() evaluates the noise directly, as the effects did.
+// ============================================================================
+
+#define NOISE_FIELD_SPACING   64    // Target lattice spacing in noise units
+#define NOISE_FIELD_KEY       64    // Noise units between time keyframes
+#define NOISE_FIELD_LED_STATE 2     // Per-LED state bytes an effect registers
+
+// One noise layer: offsets added to x and y
+struct NoiseLayer {
+    uint16_t x;
+    uint16_t y;
+};
+
+// Bookkeeping of one field (in the effect's state struct)
+struct NoiseField {
+    uint16_t scale = 0;     // Noise units per LED the rows were built for
+    uint16_t key = 0;       // Time of the older keyframe row
+    uint16_t time = 0;      // Time the current row is for
+    uint8_t shift = 0;      // log2 LEDs per lattice cell
+    bool keyed = false;     // Keyframe rows hold samples
+    bool ready = false;     // Current row is valid for time/scale
+};
+
+class NoiseEngine {
+public:
+    // Average of the layers at one point
+    static uint8_t sample(uint16_t x, uint16_t y, const NoiseLayer* layers, uint8_t numLayers) {
+        uint16_t sum = 0;
+        for (uint8_t l = 0; l < numLayers; l++) {
+            sum += inoise8(x + layers[l].x, y + layers[l].y);
+        }
+        return sum / numLayers;
+    }
+
+    // Prepare the rows for time (advance(); rows = effectLedState())
+    static void update(NoiseField& f, uint8_t* rows, uint16_t scale, uint16_t time,
+                       const NoiseLayer* layers, uint8_t numLayers) {
+        uint8_t shift = shiftFor(scale);
+        uint16_t samples = sampleCount(shift);
+        if (shift == 0 || (uint32_t)samples * 3 > (uint32_t)NUM_LEDS * NOISE_FIELD_LED_STATE) {
+            f.ready = false;
+            return;
+        }
+
+        uint8_t* row0 = rows;
+        uint8_t* row1 = rows + samples;
+        uint8_t* current = rows + samples * 2;
+        uint16_t key = time & ~(uint16_t)(NOISE_FIELD_KEY - 1);
+
+        if (!f.keyed || f.scale != scale || f.shift != shift || (uint16_t)(key - f.key) > NOISE_FIELD_KEY) {
+            sampleRow(row0, samples, shift, scale, key, layers, numLayers);
+            sampleRow(row1, samples, shift, scale, key + NOISE_FIELD_KEY, layers, numLayers);
+        } else if (key != f.key) {
+            // Moved on by one keyframe: the newer row becomes the older one
+            memcpy(row0, row1, samples);
+            sampleRow(row1, samples, shift, scale, key + NOISE_FIELD_KEY, layers, numLayers);
+        }
+        f.scale = scale;
+        f.shift = shift;
+        f.key = key;
+        f.keyed = true;
+
+        // 0..255 of the way from row0 to row1
+        uint8_t mix = (uint16_t)(time - key) * 256 / NOISE_FIELD_KEY;
+        for (uint16_t s = 0; s < samples; s++) {
+            current[s] = row0[s] + (((int16_t)row1[s] - row0[s]) * mix >> 8);
+        }
+        f.time = time;
+        f.ready = true;
+    }
+
+    // fn(i, noise) for LEDs [start, end) at time (tile()); noise is the
+    // layer average at i * scale
+    template<typename F>
+    static void forEach(const NoiseField& f, const uint8_t* rows, uint16_t start, uint16_t end,
+                        uint16_t scale, uint16_t time, const NoiseLayer* layers, uint8_t numLayers, F fn) {
+        if (!f.ready || f.scale != scale || f.time != time) {
+            for (uint16_t i = start; i < end; i++) {
+                fn(i, sample(i * scale, time, layers, numLayers));
+            }
+            return;
+        }
+
+        const uint8_t* current = rows + sampleCount(f.shift) * 2;
+        uint8_t cellMask = (1 << f.shift) - 1;
+        uint8_t fracShift = 8 - f.shift;
+        for (uint16_t i = start; i < end; i++) {
+            uint16_t k = i >> f.shift;
+            uint8_t frac = (i & cellMask) << fracShift;
+            int16_t a = current[k];
+            fn(i, (uint8_t)(a + (((int16_t)current[k + 1] - a) * frac >> 8)));
+        }
+    }
+
+private:
+    // Widest power-of-two cell (in LEDs) that stays within the spacing;
+    // 0 = scale too coarse to interpolate
+    static uint8_t shiftFor(uint16_t scale) {
+        if (scale == 0) return 0;
+        uint16_t leds = NOISE_FIELD_SPACING / scale;
+        uint8_t shift = 0;
+        while ((2u << shift) <= leds && shift < 7) shift++;
+        return shift;
+    }
+
+    // Lattice points covering the strip (one past the last LED)
+    static uint16_t sampleCount(uint8_t shift) {
+        return (NUM_LEDS >> shift) + 2;
+    }
+
+    static void sampleRow(uint8_t* row, uint16_t samples, uint8_t shift, uint16_t scale,
+                          uint16_t time, const NoiseLayer* layers, uint8_t numLayers) {
+        for (uint16_t s = 0; s < samples; s++) {
+            row[s] = sample((uint16_t)((s << shift) * scale), time, layers, numLayers);
+        }
+    }
+};
+
+#endif // NOISE_FIELD_H
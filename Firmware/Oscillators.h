@@ -0,0 +1,124 @@
+/*
+ * Oscillators.h - Additive wave bank for the wave effects
+ *
+ * Sums a few periodic waves along the strip from shared 256-entry shape
+ * tables, a chunk of LEDs at a time
+ */
+
+#ifndef OSCILLATORS_H
+#define OSCILLATORS_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "EffectParams.h"
+
+// ============================================================================
+// OscillatorBank - Sum of N waves per LED
+// ============================================================================
+// Pacifica, Lake, Plasma, Wavy and Running Lights each summed two or three
+// sin8() calls per pixel with their own phase arithmetic. They now describe
+// their waves as Oscillator terms and let render() do the work:
+//
+//   value(i) = sum over terms of scale8(shape[phase + i * step], amp) / N
+//
+// The shapes (WaveShape) are 256-byte tables built once - sin8(), saw,
+// square, triwave8() - so a term costs a load and an add per LED. Terms
+// are accumulated term by term into a small 16-bit block on the stack
+// (OSC_CHUNK LEDs), which keeps the inner loop a flat, branch-free pass
+// the compiler can unroll and vectorize, then fn(i, value) turns each
+// value into a color - normally one palette table lookup.
+//
+// Phases and steps are Q8.8, so a term can run at a fraction of a phase
+// unit per LED (Wavy fits its waves to the strip length that way). With
+// whole steps the values match the per-pixel sin8() sums exactly.
+//
+// render() keeps everything on the stack and is safe to run from both
+// tiles at once.
+// ============================================================================
+
+#define OSC_MAX_TERMS   4       // Terms in one bank (value range 0..255 each)
+#define OSC_CHUNK       64      // LEDs accumulated per block
+
+// One wave along the strip
+struct Oscillator {
+    uint16_t step;      // Phase advance per LED (Q8.8, 256 = one table entry)
+    uint16_t phase;     // Phase at LED 0 (Q8.8)
+    uint8_t amp;        // Peak value (scale8 of the shape, 255 = full)
+    WaveShape shape;
+};
+
+class OscillatorBank {
+public:
+    // Q8.8 phase from a whole table position
+    static constexpr uint16_t whole(uint16_t phase) { return phase << 8; }
+
+    // Shape table (256 entries) - e.g. for a single wave outside render()
+    static const uint8_t* table(WaveShape shape) {
+        if (!__atomic_load_n(&ready, __ATOMIC_ACQUIRE)) {
+            build();
+        }
+        return tables[(unsigned)shape <= SHAPE_TRIANGLE ? shape : SHAPE_SINE];
+    }
+
+    // fn(i, value) for LEDs [start, end); value is the average of the terms
+    template<typename F>
+    static void render(const Oscillator* terms, uint8_t numTerms, uint16_t start, uint16_t end, F fn) {
+        if (numTerms == 0) return;
+        if (numTerms > OSC_MAX_TERMS) numTerms = OSC_MAX_TERMS;
+
+        const uint8_t* waves[OSC_MAX_TERMS];
+        for (uint8_t t = 0; t < numTerms; t++) {
+            waves[t] = table(terms[t].shape);
+        }
+        // Exact sum / numTerms for sums up to 255 * OSC_MAX_TERMS
+        const uint32_t recip = (65535 + numTerms) / numTerms;
+
+        uint16_t acc[OSC_CHUNK];
+        for (uint16_t base = start; base < end; base += OSC_CHUNK) {
+            uint16_t len = min<uint16_t>(OSC_CHUNK, end - base);
+            memset(acc, 0, len * sizeof(uint16_t));
+
+            for (uint8_t t = 0; t < numTerms; t++) {
+                const uint8_t* wave = waves[t];
+                const uint16_t step = terms[t].step;
+                const uint16_t scale = terms[t].amp + 1;
+                uint16_t p = terms[t].phase + (uint16_t)((uint32_t)base * step);
+                for (uint16_t j = 0; j < len; j++) {
+                    acc[j] += (wave[p >> 8] * scale) >> 8;
+                    p += step;
+                }
+            }
+
+            for (uint16_t j = 0; j < len; j++) {
+                fn(base + j, (uint8_t)(acc[j] * recip >> 16));
+            }
+        }
+    }
+
+private:
+    static uint8_t tables[SHAPE_TRIANGLE + 1][256];
+    static bool ready;
+
+    // Same values the effects computed per pixel; two cores building at
+    // once write identical bytes
+    static void build() {
+        for (uint16_t i = 0; i < 256; i++) {
+            uint8_t s = sin8(i);
+            tables[SHAPE_SINE][i] = s;
+            tables[SHAPE_SAW][i] = i;
+            tables[SHAPE_SQUARE][i] = s > 127 ? 255 : 0;
+            tables[SHAPE_TRIANGLE][i] = triwave8(i);
+        }
+        __atomic_store_n(&ready, true, __ATOMIC_RELEASE);
+    }
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+uint8_t OscillatorBank::tables[SHAPE_TRIANGLE + 1][256];
+bool OscillatorBank::ready = false;
+
+#endif // OSCILLATORS_H
@@ -130,6 +130,76 @@ CRGBPalette16 getPalette(PaletteType type) {
     }
 }
 
+// ============== EXPANDED PALETTE CACHE ==============
+
+#define PALETTE_COUNT (PALETTE_CYBER + 1)
+
+// 256-entry RGB tables, one per palette, expanded from the 16-entry palette
+// with LINEARBLEND the first time that palette is selected (setParamFor()
+// prepares it when a palette param changes; effects build on first use
+// otherwise). A lookup is then one indexed load instead of rebuilding a
+// CRGBPalette16 - and decoding gradient palettes - per call. Palettes are
+// constant, so a table never needs rebuilding once it exists.
+//
+// Tile effects may look a table up from both cores. A table is published
+// only after it is complete; two cores building the same one at once write
+// identical bytes.
+class PaletteCache {
+public:
+    static const CRGB* get(PaletteType type) {
+        uint8_t t = (unsigned)type < PALETTE_COUNT ? type : PALETTE_RAINBOW;
+        if (!__atomic_load_n(&ready[t], __ATOMIC_ACQUIRE)) {
+            CRGBPalette16 pal = getPalette((PaletteType)t);
+            for (uint16_t i = 0; i < 256; i++) {
+                tables[t][i] = ColorFromPalette(pal, i, 255, LINEARBLEND);
+            }
+            __atomic_store_n(&ready[t], true, __ATOMIC_RELEASE);
+        }
+        return tables[t];
+    }
+
+    // Expand a palette ahead of its first frame
+    static void prepare(PaletteType type) {
+        get(type);
+    }
+
+    // CHSV(hue, 255, 255) for every hue - the full-saturation rainbow
+    static const CRGB* hues() {
+        if (!__atomic_load_n(&huesReady, __ATOMIC_ACQUIRE)) {
+            for (uint16_t h = 0; h < 256; h++) {
+                hueTable[h] = CHSV(h, 255, 255);
+            }
+            __atomic_store_n(&huesReady, true, __ATOMIC_RELEASE);
+        }
+        return hueTable;
+    }
+
+private:
+    static CRGB tables[PALETTE_COUNT][256];
+    static bool ready[PALETTE_COUNT];
+    static CRGB hueTable[256];
+    static bool huesReady;
+};
+
+CRGB PaletteCache::tables[PALETTE_COUNT][256];
+bool PaletteCache::ready[PALETTE_COUNT] = {};
+CRGB PaletteCache::hueTable[256];
+bool PaletteCache::huesReady = false;
+
+// Color from an expanded table - same result as ColorFromPalette() with
+// LINEARBLEND on the palette it was built from
+inline CRGB paletteColor(const CRGB* table, uint8_t index, uint8_t brightness = 255) {
+    CRGB color = table[index];
+    if (brightness != 255) {
+        if (brightness == 0) return CRGB::Black;
+        brightness++;
+        color.r = scale8(color.r, brightness);
+        color.g = scale8(color.g, brightness);
+        color.b = scale8(color.b, brightness);
+    }
+    return color;
+}
+
 // Palette name (for debugging)
 const char* getPaletteName(PaletteType type) {
     static const char* names[] = {
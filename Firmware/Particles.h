@@ -0,0 +1,170 @@
+/*
+ * Particles.h - Particle pool and subpixel drawing for moving-dot effects
+ *
+ * Fixed-point particles kept as parallel arrays in the effect's per-LED
+ * state, so the pool grows with the strip
+ */
+
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "EffectDefs.h"
+
+// ============================================================================
+// Particle Pool
+// ============================================================================
+// Fireworks, Bouncing Balls, Popcorn, Drip, Matrix, Scanner, Comet and the
+// Starry Night shooting star each kept their own fixed array (8 to 32
+// entries), scanned it for a free slot and drew whole pixels. They now share
+// one pool:
+//
+//   storage     structure of arrays - pos[], vel[] (Q16.16 LEDs, LEDs per
+//               step), color[], life[] - carved out of the effect's per-LED
+//               state (PARTICLE_LED_STATE bytes per LED), so capacity scales
+//               with the strip: ~30 particles on 75 LEDs, ~400 on 1000
+//   live set    particles [0, count) are alive and the free slots are the
+//               tail: spawn() takes slot count, kill() moves the last live
+//               particle into the hole - both O(1), and every pass over the
+//               pool touches only live particles, contiguously
+//   stepping    effects keep their effectSteps() period as the fixed
+//               timestep; integrate() is one flat vel += g, pos += vel pass
+//               over the arrays, then the effect applies its own rules
+//               (bounces, fades, deaths) in update()
+//   drawing     splat() draws a particle between the two LEDs it straddles,
+//               weighted by its fractional position, so slow particles
+//               glide instead of jumping pixel to pixel; at() places a
+//               particle part way into the next step for frames that fall
+//               between steps
+//
+// Particles do not keep their slot: kill() reorders the pool, so anything
+// an effect needs per particle lives in the particle (color, life).
+// ============================================================================
+
+#define PARTICLE_LED_STATE  5       // Per-LED state bytes an effect registers
+#define PARTICLE_BYTES      (sizeof(q16_16) * 2 + sizeof(CRGB) + 1)
+
+// Pool bookkeeping (in the effect's state struct)
+struct ParticleSet {
+    uint16_t count = 0;     // Live particles, slots [0, count)
+};
+
+// View of the bound instance's pool - build one per frame with
+// ParticlePool::bind()
+class ParticlePool {
+public:
+    q16_16* pos;        // LEDs (Q16.16)
+    q16_16* vel;        // LEDs per step (Q16.16)
+    CRGB* color;
+    uint8_t* life;      // Effect-defined: brightness, fade level, ...
+    uint16_t capacity;
+
+    // Pool in effectLedState() for NUM_LEDS LEDs
+    static ParticlePool bind(ParticleSet& set) {
+        uint16_t cap = (uint32_t)NUM_LEDS * PARTICLE_LED_STATE / PARTICLE_BYTES;
+        uint8_t* base = effectLedState();
+        q16_16* pos = (q16_16*)base;
+        q16_16* vel = pos + cap;
+        CRGB* color = (CRGB*)(vel + cap);
+        uint8_t* life = (uint8_t*)(color + cap);
+        if (set.count > cap) set.count = cap;
+        return ParticlePool(set, pos, vel, color, life, cap);
+    }
+
+    uint16_t count() const { return set.count; }
+    bool full() const { return set.count >= capacity; }
+
+    // New particle; -1 when the pool is full
+    int16_t spawn(q16_16 p, q16_16 v, const CRGB& c, uint8_t l = 255) {
+        if (full()) return -1;
+        uint16_t i = set.count++;
+        pos[i] = p;
+        vel[i] = v;
+        color[i] = c;
+        life[i] = l;
+        return i;
+    }
+
+    // Remove particle i (the last live particle takes its slot)
+    void kill(uint16_t i) {
+        uint16_t last = --set.count;
+        if (i != last) {
+            pos[i] = pos[last];
+            vel[i] = vel[last];
+            color[i] = color[last];
+            life[i] = life[last];
+        }
+    }
+
+    void clear() { set.count = 0; }
+
+    // One step of motion for every particle: vel += gravity, pos += vel
+    void integrate(q16_16 gravity) {
+        const uint16_t n = set.count;
+        for (uint16_t i = 0; i < n; i++) {
+            vel[i] += gravity;
+            pos[i] += vel[i];
+        }
+    }
+
+    // fn(i) for every live particle; particles it returns false for die.
+    // Runs last to first so kill() only moves particles already visited.
+    template<typename F>
+    void update(F fn) {
+        for (int32_t i = (int32_t)set.count - 1; i >= 0; i--) {
+            if (!fn((uint16_t)i)) kill(i);
+        }
+    }
+
+    // Position fraction/256 of a step past the last one (effectStepFraction())
+    q16_16 at(uint16_t i, uint8_t fraction) const {
+        return pos[i] + (q16_16)(((int64_t)vel[i] * fraction) >> 8);
+    }
+
+private:
+    ParticleSet& set;
+
+    ParticlePool(ParticleSet& s, q16_16* p, q16_16* v, CRGB* c, uint8_t* l, uint16_t cap)
+        : pos(p), vel(v), color(c), life(l), capacity(cap), set(s) {}
+};
+
+// ============================================================================
+// Subpixel Drawing
+// ============================================================================
+
+// Draw c at pos (Q16.16 LEDs) over the two LEDs it straddles, blending each
+// toward c by its coverage times opacity. A particle on a whole LED at full
+// opacity simply sets that LED. With an order (ledOrder()) pos is a step
+// along it and lands on leds[order[step]].
+inline void splat(q16_16 pos, const CRGB& c, uint8_t opacity = 255,
+                  const uint16_t* order = nullptr) {
+    int32_t p = q16Int(pos);
+    uint8_t frac = (uint8_t)(pos >> 8);
+    uint8_t w0 = scale8(opacity, 255 - frac);
+    uint8_t w1 = scale8(opacity, frac);
+    if (p >= 0 && p < NUM_LEDS && w0) {
+        CRGB& led = leds[order ? order[p] : p];
+        led = blend(led, c, w0);
+    }
+    if (p + 1 >= 0 && p + 1 < NUM_LEDS && w1) {
+        CRGB& led = leds[order ? order[p + 1] : p + 1];
+        led = blend(led, c, w1);
+    }
+}
+
+// Add c at pos, split between the two LEDs by coverage - for streaks drawn
+// as a run of splats, where neighbouring samples should sum
+inline void splatAdd(q16_16 pos, const CRGB& c, const uint16_t* order = nullptr) {
+    int32_t p = q16Int(pos);
+    uint8_t frac = (uint8_t)(pos >> 8);
+    if (p >= 0 && p < NUM_LEDS && frac != 255) {
+        leds[order ? order[p] : p] += CRGB(c).nscale8(255 - frac);
+    }
+    if (p + 1 >= 0 && p + 1 < NUM_LEDS && frac) {
+        leds[order ? order[p + 1] : p + 1] += CRGB(c).nscale8(frac);
+    }
+}
+
+#endif // PARTICLES_H
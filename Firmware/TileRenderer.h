@@ -0,0 +1,118 @@
+/*
+ * TileRenderer.h - Dual-core tiled effect rendering
+ *
+ * Splits the strip between the LED task (Core 0) and a worker on Core 1
+ */
+
+#ifndef TILE_RENDERER_H
+#define TILE_RENDERER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "SerialLogger.h"
+#include "EffectDefs.h"
+#include "EffectTable.h"
+
+// ============================================================================
+// TileRenderer - Parallel render for tile-capable effects
+// ============================================================================
+// Effects that provide tile()/advance() in effectTable[] are rendered in two
+// halves: the worker on Core 1 renders the upper tile while the LED task
+// renders the lower one, then both meet at a barrier before advance() steps
+// the animation and the frame is presented. All other effects (shared
+// simulation state, random numbers, cross-pixel reads) keep using func().
+// ============================================================================
+
+class TileRenderer {
+public:
+    // Start the Core 1 worker (no-op when parallel rendering is disabled)
+    static bool begin() {
+#if LED_PARALLEL_RENDER
+        if (NUM_LEDS < LED_PARALLEL_MIN_LEDS) {
+            LOG_INFO("Tiled rendering: off (strip too short)");
+            return true;
+        }
+
+        tileDone = xSemaphoreCreateBinary();
+        if (tileDone == NULL) {
+            LOG_ERROR("Failed to create tile semaphore!");
+            return false;
+        }
+
+        BaseType_t result = xTaskCreatePinnedToCore(
+            workerTask,
+            "LEDTile",
+            TASK_STACK_SIZE_LED_TILE,
+            NULL,
+            TASK_PRIORITY_LED_TILE,
+            &workerHandle,
+            1                     // Core 1 - LED task owns Core 0
+        );
+
+        if (result != pdPASS) {
+            LOG_ERROR("Failed to create LED tile worker!");
+            workerHandle = NULL;
+            return false;
+        }
+
+        LOG_PRINTF("INFO ", "Tiled rendering: 2 tiles of ~%d LEDs", NUM_LEDS / 2);
+#endif
+        return true;
+    }
+
+    // Render one frame of the given effect into leds[]
+    static void render(const EffectEntry& effect) {
+#if LED_PARALLEL_RENDER
+        if (workerHandle != NULL && effect.tile != nullptr && NUM_LEDS >= LED_PARALLEL_MIN_LEDS) {
+            uint16_t split = NUM_LEDS / 2;
+
+            jobTile = effect.tile;
+            jobStart = split;
+            jobEnd = NUM_LEDS;
+            xTaskNotifyGive(workerHandle);
+
+            effect.tile(0, split);
+
+            // Barrier: wait for the upper tile before stepping the animation
+            xSemaphoreTake(tileDone, portMAX_DELAY);
+
+            if (effect.advance != nullptr) {
+                effect.advance();
+            }
+            return;
+        }
+#endif
+        effect.func();
+    }
+
+private:
+#if LED_PARALLEL_RENDER
+    static TaskHandle_t workerHandle;
+    static SemaphoreHandle_t tileDone;
+    static void (*volatile jobTile)(uint16_t start, uint16_t end);
+    static volatile uint16_t jobStart;
+    static volatile uint16_t jobEnd;
+
+    static void workerTask(void* params) {
+        while (true) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            jobTile(jobStart, jobEnd);
+            xSemaphoreGive(tileDone);
+        }
+    }
+#endif
+};
+
+// ============================================================================
+// Static Member Initialization
+// ============================================================================
+
+#if LED_PARALLEL_RENDER
+TaskHandle_t TileRenderer::workerHandle = NULL;
+SemaphoreHandle_t TileRenderer::tileDone = NULL;
+void (*volatile TileRenderer::jobTile)(uint16_t start, uint16_t end) = nullptr;
+volatile uint16_t TileRenderer::jobStart = 0;
+volatile uint16_t TileRenderer::jobEnd = 0;
+#endif
+
+#endif // TILE_RENDERER_H
@@ -0,0 +1,183 @@
+/*
+ * bench.cpp - Per-effect frame-time benchmark (host simulation build)
+ *
+ * Renders every effectTable[] entry for a fixed number of simulated frames
+ * and reports the render cost per frame. The simulated clock advances by
+ * one frame period (1000 / LED_TARGET_FPS ms, or --fps) per frame and the
+ * effect timebase is stepped with it, as the LED task does on the device.
+ *
+ * The strip length is a runtime setting, as on the device: buffers are
+ * allocated once for --leds before the first effect runs.
+ *
+ * Usage: pixeltree_bench [--leds N] [--frames N] [--warmup N] [--fps N] [--effect ID] [--csv]
+ */
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "EffectDefs.h"
+#include "Effects.h"
+#include "EffectTable.h"
+#include "EffectInstance.h"
+
+// WS2812 wire time: 24 bits @ 800 kHz per LED plus the latch/reset gap
+#define WS2812_US_PER_LED     30
+#define WS2812_RESET_US       280
+
+struct BenchOptions {
+    uint16_t leds = ARGB_NUM_LEDS;
+    uint32_t frames = 600;      // 10 s of simulated time at 60 FPS
+    uint32_t warmup = 60;
+    uint16_t fps = LED_TARGET_FPS;
+    int effect = -1;            // -1 = all effects
+    bool csv = false;
+};
+
+struct FrameStats {
+    double meanNs;
+    double p50Ns;
+    double p99Ns;
+    double maxNs;
+    double fps;
+};
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+static double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t idx = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[idx];
+}
+
+static EffectInstance benchState;
+
+static FrameStats benchEffect(uint8_t id, const BenchOptions& opt) {
+    typedef std::chrono::steady_clock Clock;
+    const uint32_t frameMs = 1000 / opt.fps;
+    const EffectEntry& entry = effectTable[id];
+
+    // Same starting conditions for every effect
+    hostsim::setMillis(0);
+    resetEffectTime(0);
+    random16_set_seed(1337);
+    fill_solid(leds, NUM_LEDS, CRGB::Black);
+    benchState.reset(id);
+    benchState.bind();
+
+    for (uint32_t f = 0; f < opt.warmup; f++) {
+        hostsim::advanceMillis(frameMs);
+        advanceEffectTime(millis());
+        entry.func();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(opt.frames);
+
+    for (uint32_t f = 0; f < opt.frames; f++) {
+        hostsim::advanceMillis(frameMs);
+        advanceEffectTime(millis());
+
+        Clock::time_point start = Clock::now();
+        entry.func();
+        Clock::time_point end = Clock::now();
+
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+
+    double total = 0;
+    for (double s : samples) total += s;
+
+    std::sort(samples.begin(), samples.end());
+
+    FrameStats stats;
+    stats.meanNs = total / samples.size();
+    stats.p50Ns = percentile(samples, 0.50);
+    stats.p99Ns = percentile(samples, 0.99);
+    stats.maxNs = samples.back();
+    stats.fps = stats.meanNs > 0 ? 1e9 / stats.meanNs : 0;
+    return stats;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+static bool parseArgs(int argc, char** argv, BenchOptions& opt) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--leds") && i + 1 < argc) {
+            opt.leds = (uint16_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            opt.frames = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--warmup") && i + 1 < argc) {
+            opt.warmup = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--fps") && i + 1 < argc) {
+            opt.fps = (uint16_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--effect") && i + 1 < argc) {
+            opt.effect = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--csv")) {
+            opt.csv = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--leds N] [--frames N] [--warmup N] [--fps N] [--effect ID] [--csv]\n", argv[0]);
+            return false;
+        }
+    }
+    if (opt.frames == 0) opt.frames = 1;
+    if (opt.fps == 0 || opt.fps > 1000) {
+        fprintf(stderr, "--fps must be 1..1000\n");
+        return false;
+    }
+    if (opt.leds == 0 || opt.leds > ARGB_MAX_LEDS) {
+        fprintf(stderr, "--leds must be 1..%d\n", ARGB_MAX_LEDS);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    if (!parseArgs(argc, argv, opt)) {
+        return 1;
+    }
+
+    if (!allocLeds(opt.leds) || !benchState.init(NUM_LEDS) || !LEDGeometry::begin()) {
+        fprintf(stderr, "Failed to allocate buffers for %d LEDs\n", opt.leds);
+        return 1;
+    }
+
+    double wireMs = (NUM_LEDS * WS2812_US_PER_LED + WS2812_RESET_US) / 1000.0;
+    double frameBudgetMs = 1000.0 / opt.fps;
+
+    if (opt.csv) {
+        printf("leds,id,name,mean_ns,p50_ns,p99_ns,max_ns,fps\n");
+    } else {
+        printf("PixelTree host benchmark - %d LEDs, %u frames/effect\n", NUM_LEDS, opt.frames);
+        printf("Wire time: %.2f ms  Frame budget @%d FPS: %.2f ms  Render budget: %.2f ms\n\n",
+               wireMs, opt.fps, frameBudgetMs, frameBudgetMs - wireMs);
+        printf("%3s  %-16s %12s %12s %12s %12s %12s\n",
+               "ID", "Effect", "ns/frame", "p50 ns", "p99 ns", "max ns", "frames/s");
+    }
+
+    for (uint8_t id = 0; id < NUM_EFFECT_ENTRIES; id++) {
+        if (opt.effect >= 0 && opt.effect != id) continue;
+
+        FrameStats s = benchEffect(id, opt);
+
+        if (opt.csv) {
+            printf("%d,%d,%s,%.0f,%.0f,%.0f,%.0f,%.0f\n", NUM_LEDS, id, effectTable[id].name,
+                   s.meanNs, s.p50Ns, s.p99Ns, s.maxNs, s.fps);
+        } else {
+            printf("%3d  %-16s %12.0f %12.0f %12.0f %12.0f %12.0f\n", id, effectTable[id].name,
+                   s.meanNs, s.p50Ns, s.p99Ns, s.maxNs, s.fps);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,569 @@
+/*
+ * fixedpoint.cpp - Fixed-point physics check and benchmark (host simulation build)
+ *
+ * Runs the Q16.16 ports of Color Wave, Bouncing Balls, Popcorn and Drip
+ * next to float versions of the same code, from the same random seed and
+ * simulated clock, and reports how closely the frames match and what each
+ * version costs per frame. Also checks the integer Comet trail curve
+ * against its float original for every trail length.
+ *
+ * Bouncing Balls, Popcorn and Drip run on the particle pool (Particles.h)
+ * and draw between LEDs; their references are that same code with double
+ * positions and velocities. Subpixel weights make exact frame matches
+ * rare, so a port passes when nearly every frame is within a few levels
+ * of the float one ("close") - a port that drifts falls out of step and
+ * fails. Exits non-zero if any port drifts.
+ *
+ * Usage: pixeltree_fixedpoint [--leds N] [--frames N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "EffectDefs.h"
+#include "Effects.h"
+#include "EffectTable.h"
+#include "EffectInstance.h"
+
+// ============================================================================
+// Float Reference
+// ============================================================================
+
+struct ColorWaveStateF {
+    float offset = 0;
+};
+
+// Length of one color band (0 if there are no colors)
+inline uint16_t colorWaveSegmentLenFloat() {
+    if (colorWaveParams.numColors == 0) return 0;
+    uint16_t segmentLen = NUM_LEDS / colorWaveParams.numColors;
+    return segmentLen ? segmentLen : 1;  // Safety check
+}
+
+void effectColorWaveTileFloat(uint16_t start, uint16_t end) {
+    // Prevent division by zero
+    uint16_t segmentLen = colorWaveSegmentLenFloat();
+    if (segmentLen == 0) return;
+    
+    float offset = effectState<ColorWaveStateF>().offset;
+    
+    for (uint16_t i = start; i < end; i++) {
+        uint16_t pos = mapLed(i, colorWaveParams.direction);
+        uint16_t adjustedPos = ((uint16_t)(pos + offset)) % NUM_LEDS;
+        
+        uint8_t colorIdx = adjustedPos / segmentLen;
+        uint8_t nextColorIdx = (colorIdx + 1) % colorWaveParams.numColors;
+        
+        // Safe blend calculation
+        uint8_t blendAmount;
+        if (segmentLen > 1) {
+            blendAmount = map(adjustedPos % segmentLen, 0, segmentLen - 1, 0, 255);
+        } else {
+            blendAmount = 0;
+        }
+        
+        if (colorIdx < colorWaveParams.numColors) {
+            leds[i] = blend(colorWaveParams.colors[colorIdx], 
+                           colorWaveParams.colors[nextColorIdx], 
+                           blendAmount);
+        }
+    }
+}
+
+void effectColorWaveAdvanceFloat() {
+    uint16_t segmentLen = colorWaveSegmentLenFloat();
+    if (segmentLen == 0) return;
+    
+    // Normalize speed: higher numColors = smaller segments, so scale offset increment
+    // This keeps visual wave speed constant regardless of number of colors
+    float speedFactor = map(colorWaveParams.speed, 0, 255, 10, 100) / 100.0;
+    float normalizedIncrement = speedFactor * (float)segmentLen / 10.0;
+    
+    float& offset = effectState<ColorWaveStateF>().offset;
+    offset += normalizedIncrement * effectTime.dt8 / 256.0f;
+    while (offset >= NUM_LEDS) offset -= NUM_LEDS;
+}
+
+void effectColorWaveFloat() {
+    effectColorWaveTileFloat(0, NUM_LEDS);
+    effectColorWaveAdvanceFloat();
+}
+
+// Bouncing Balls, Popcorn and Drip as they run now - particle pool,
+// subpixel drawing, positions between steps - with floating-point positions
+// and velocities, so the comparison isolates the Q16.16 arithmetic. They are
+// double: a float has 11 fraction bits left at LED 5000, fewer than Q16.16,
+// and would be the side that drifts on long strips.
+
+struct ParticleSetF {
+    uint16_t count = 0;
+};
+
+// ParticlePool with double pos/vel: same capacity, spawn and swap-remove
+// order, so both versions keep their particles in the same slots
+class ParticlePoolF {
+public:
+    static std::vector<double> pos, vel;
+    static std::vector<CRGB> color;
+    static std::vector<uint8_t> life;
+    static uint16_t capacity;
+
+    static bool init(uint16_t ledCount) {
+        capacity = (uint32_t)ledCount * PARTICLE_LED_STATE / PARTICLE_BYTES;
+        pos.resize(capacity);
+        vel.resize(capacity);
+        color.resize(capacity);
+        life.resize(capacity);
+        return true;
+    }
+
+    explicit ParticlePoolF(ParticleSetF& s) : set(s) {}
+
+    uint16_t count() const { return set.count; }
+    void clear() { set.count = 0; }
+
+    void spawn(double p, double v, const CRGB& c, uint8_t l = 255) {
+        if (set.count >= capacity) return;
+        uint16_t i = set.count++;
+        pos[i] = p;
+        vel[i] = v;
+        color[i] = c;
+        life[i] = l;
+    }
+
+    void integrate(double gravity) {
+        for (uint16_t i = 0; i < set.count; i++) {
+            vel[i] += gravity;
+            pos[i] += vel[i];
+        }
+    }
+
+    template<typename F>
+    void update(F fn) {
+        for (int32_t i = (int32_t)set.count - 1; i >= 0; i--) {
+            if (!fn((uint16_t)i)) {
+                uint16_t last = --set.count;
+                pos[i] = pos[last];
+                vel[i] = vel[last];
+                color[i] = color[last];
+                life[i] = life[last];
+            }
+        }
+    }
+
+    double at(uint16_t i, uint8_t fraction) const {
+        return pos[i] + vel[i] * fraction / 256.0;
+    }
+
+private:
+    ParticleSetF& set;
+};
+
+std::vector<double> ParticlePoolF::pos;
+std::vector<double> ParticlePoolF::vel;
+std::vector<CRGB> ParticlePoolF::color;
+std::vector<uint8_t> ParticlePoolF::life;
+uint16_t ParticlePoolF::capacity = 0;
+
+// splat() at a double position
+void splatFloat(double pos, const CRGB& c, uint8_t opacity = 255) {
+    int32_t p = (int32_t)floor(pos);
+    uint8_t frac = (uint8_t)((pos - p) * 256.0);
+    uint8_t w0 = scale8(opacity, 255 - frac);
+    uint8_t w1 = scale8(opacity, frac);
+    if (p >= 0 && p < NUM_LEDS && w0) {
+        leds[p] = blend(leds[p], c, w0);
+    }
+    if (p + 1 >= 0 && p + 1 < NUM_LEDS && w1) {
+        leds[p + 1] = blend(leds[p + 1], c, w1);
+    }
+}
+
+struct BouncingBallsStateF {
+    ParticleSetF balls;
+    uint32_t lastUpdate = 0;
+};
+
+void effectBouncingBallsFloat() {
+    auto& [balls, lastUpdate] = effectState<BouncingBallsStateF>();
+    ParticlePoolF pool(balls);
+    
+    const CRGB* pal = PaletteCache::get(bouncingBallsParams.palette);
+    
+    uint8_t numBalls = min<uint16_t>(min<uint8_t>(bouncingBallsParams.numBalls, 8), pool.capacity);
+    if (pool.count() != numBalls) {
+        pool.clear();
+        for (uint8_t i = 0; i < numBalls; i++) {
+            pool.spawn(i * NUM_LEDS / 8, 0, paletteColor(pal, i * 32, 255));
+        }
+    }
+    
+    double gravity = (double)bouncingBallsParams.gravity / 5000.0;
+    double damping = 0.9;
+    double bottom = NUM_LEDS - 1;
+    
+    for (uint8_t s = effectSteps(lastUpdate, 15); s > 0; s--) {
+        pool.integrate(gravity);
+        pool.update([&](uint16_t i) {
+            double& position = pool.pos[i];
+            double& velocity = pool.vel[i];
+            
+            if (position >= bottom) {
+                position = bottom;
+                velocity = -velocity * damping;
+                
+                if (fabs(velocity) < 0.5) {
+                    position = 0;
+                    velocity = 0;
+                }
+            }
+            
+            if (position < 0) {
+                position = 0;
+                velocity = -velocity * damping;
+            }
+            return true;
+        });
+    }
+    
+    for (uint8_t f = 0; f < effectTime.frames; f++) {
+        fadeAll(bouncingBallsParams.trail > 0 ? 50 : 255);
+    }
+    
+    uint8_t fraction = effectStepFraction(lastUpdate, 15);
+    for (uint8_t i = 0; i < pool.count(); i++) {
+        double pos = constrain(pool.at(i, fraction), 0.0, bottom);
+        CRGB ballColor = paletteColor(pal, i * 32, 255);
+        
+        if (bouncingBallsParams.trail > 0) {
+            int8_t back = pool.vel[i] > 0 ? -1 : 1;
+            for (uint8_t t = bouncingBallsParams.trail; t >= 1; t--) {
+                CRGB col = ballColor;
+                col.nscale8(255 - t * (255 / bouncingBallsParams.trail));
+                splatFloat(pos + back * t, col, 180);
+            }
+        }
+        splatFloat(pos, ballColor);
+    }
+}
+
+struct PopcornStateF {
+    ParticleSetF kernels;
+    uint32_t lastUpdate = 0;
+    uint32_t lastPop = 0;
+};
+
+void effectPopcornFloat() {
+    auto& [kernels, lastUpdate, lastPop] = effectState<PopcornStateF>();
+    ParticlePoolF pool(kernels);
+    
+    const CRGB* pal = PaletteCache::get(popcornParams.palette);
+    
+    uint16_t updateDelay = map(popcornParams.speed, 0, 255, 40, 10);
+    uint16_t popDelay = map(popcornParams.intensity, 0, 255, 800, 50);
+    
+    for (uint8_t s = effectSteps(lastPop, popDelay); s > 0; s--) {
+        double position = random8(5);
+        double velocity;
+        if (random8() < 20) {
+            velocity = random8(90, 120) / 10.0;
+        } else {
+            velocity = random8(20, 80) / 10.0;
+        }
+        pool.spawn(position, velocity, paletteColor(pal, random8(), 255));
+    }
+    
+    for (uint8_t s = effectSteps(lastUpdate, updateDelay); s > 0; s--) {
+        pool.integrate(-0.25);
+        pool.update([&](uint16_t k) {
+            if (pool.pos[k] < 0) {
+                pool.pos[k] = 0;
+                pool.vel[k] = -pool.vel[k] * 0.6;
+                
+                if (fabs(pool.vel[k]) < 0.3) {
+                    return false;
+                }
+            }
+            
+            return pool.pos[k] < NUM_LEDS;
+        });
+    }
+    
+    for (uint8_t f = 0; f < effectTime.frames; f++) {
+        fadeAll(80);
+    }
+    
+    uint8_t fraction = effectStepFraction(lastUpdate, updateDelay);
+    for (uint16_t k = 0; k < pool.count(); k++) {
+        splatFloat(max(0.0, pool.at(k, fraction)), pool.color[k]);
+    }
+}
+
+struct DripStateF {
+    ParticleSetF drips;
+    uint32_t lastUpdate = 0;
+    uint32_t nextDripTime = 0;
+};
+
+void effectDripFloat() {
+    auto& [drips, lastUpdate, nextDripTime] = effectState<DripStateF>();
+    ParticlePoolF pool(drips);
+    
+    double gravity = (double)dripParams.gravity / 2500.0;
+    double bottom = NUM_LEDS - 1;
+    
+    for (uint8_t s = effectSteps(lastUpdate, 20); s > 0; s--) {
+        if (millis() > nextDripTime && pool.count() < dripParams.numDrips) {
+            pool.spawn(0, 0.2, dripParams.color);
+            nextDripTime = millis() + 800 + random16(700);
+        }
+        
+        pool.update([&](uint16_t d) {
+            if (pool.vel[d] != 0) {
+                pool.vel[d] += gravity;
+                pool.pos[d] += pool.vel[d];
+                
+                if (pool.pos[d] >= bottom) {
+                    pool.pos[d] = bottom;
+                    pool.vel[d] = 0;
+                    pool.life[d] = 255;
+                }
+                return true;
+            }
+            pool.life[d] = qsub8(pool.life[d], 12);
+            return pool.life[d] >= 5;
+        });
+    }
+    
+    for (uint8_t f = 0; f < effectTime.frames; f++) {
+        if (!dripParams.overlay) {
+            fadeAll(30);
+        } else {
+            fadeAll(10);
+        }
+    }
+    
+    uint8_t fraction = effectStepFraction(lastUpdate, 20);
+    for (uint16_t d = 0; d < pool.count(); d++) {
+        if (pool.vel[d] != 0) {
+            double pos = min(pool.at(d, fraction), bottom);
+            uint8_t tailLen = constrain((int)(pool.vel[d] * 1.5), 1, 6);
+            for (uint8_t t = tailLen; t >= 1; t--) {
+                CRGB col = dripParams.color;
+                col.nscale8(255 - (t * 40));
+                splatFloat(pos - t, col);
+            }
+            splatFloat(pos, dripParams.color);
+        } else {
+            uint8_t splashBrightness = pool.life[d];
+            CRGB splashCol = dripParams.color;
+            splashCol.nscale8(splashBrightness);
+            
+            leds[NUM_LEDS - 1] = splashCol;
+            
+            for (uint8_t s = 1; s <= 8; s++) {
+                int16_t splashPos = NUM_LEDS - 1 - s;
+                if (splashPos >= 0) {
+                    CRGB col = dripParams.color;
+                    col.nscale8(splashBrightness * (9 - s) / 9);
+                    leds[splashPos] = blend(leds[splashPos], col, splashBrightness);
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Comparison
+// ============================================================================
+
+struct RefEffect {
+    uint8_t id;                 // effectTable[] entry of the fixed-point port
+    void (*floatFunc)();
+    uint16_t stateSize;
+    void (*resetState)(void*);
+};
+
+#define REF_EFFECT(id, func, State) { id, func, sizeof(State), resetEffectState<State> }
+
+static const RefEffect refEffects[] = {
+    REF_EFFECT(5, effectColorWaveFloat, ColorWaveStateF),
+    REF_EFFECT(30, effectBouncingBallsFloat, BouncingBallsStateF),
+    REF_EFFECT(31, effectPopcornFloat, PopcornStateF),
+    REF_EFFECT(32, effectDripFloat, DripStateF),
+};
+
+// A frame is close when no channel is off by more than CLOSE_LEVELS (a
+// particle a sixteenth of an LED off, or a tail one LED shorter on a
+// threshold tie); a port passes with CLOSE_PERCENT of its frames close
+#define CLOSE_LEVELS    16
+#define CLOSE_PERCENT   99
+
+#define TIMING_PASSES   3       // Runs of each version, fastest counts
+
+struct RunResult {
+    std::vector<CRGB> frames;   // Every frame, back to back
+    double meanNs;
+};
+
+static EffectInstance fixedState;
+static uint32_t floatState[256];
+
+// Render frameCount frames of one version from the same start conditions
+static RunResult run(void (*func)(), uint32_t frameCount) {
+    RunResult result;
+    result.frames.reserve((size_t)frameCount * NUM_LEDS);
+
+    hostsim::setMillis(0);
+    resetEffectTime(0);
+    random16_set_seed(1337);
+    fill_solid(leds, NUM_LEDS, CRGB::Black);
+
+    double totalNs = 0;
+    for (uint32_t f = 0; f < frameCount; f++) {
+        hostsim::advanceMillis(1000 / LED_TARGET_FPS);
+        advanceEffectTime(millis());
+
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+
+        result.frames.insert(result.frames.end(), leds, leds + NUM_LEDS);
+    }
+    result.meanNs = totalNs / frameCount;
+    return result;
+}
+
+// Compare one port with its reference; true when it stays close
+static bool compare(const RefEffect& ref, uint32_t frameCount) {
+    if (ref.stateSize > sizeof(floatState)) {
+        printf("%3d  float state too large for the reference block\n", ref.id);
+        return false;
+    }
+
+    // Runs are deterministic; alternate the two and keep the fastest of
+    // each so a noisy host doesn't decide the speedup
+    RunResult floatRun, fixedRun;
+    for (uint8_t pass = 0; pass < TIMING_PASSES; pass++) {
+        ref.resetState(floatState);
+        effectStateBlock = floatState;
+        RunResult floatPass = run(ref.floatFunc, frameCount);
+
+        fixedState.reset(ref.id);
+        fixedState.bind();
+        RunResult fixedPass = run(effectTable[ref.id].func, frameCount);
+
+        if (pass == 0) {
+            floatRun = std::move(floatPass);
+            fixedRun = std::move(fixedPass);
+        } else {
+            floatRun.meanNs = std::min(floatRun.meanNs, floatPass.meanNs);
+            fixedRun.meanNs = std::min(fixedRun.meanNs, fixedPass.meanNs);
+        }
+    }
+
+    uint32_t sameFrames = 0;
+    uint32_t closeFrames = 0;
+    uint64_t diffPixels = 0;
+    uint32_t firstDiff = UINT32_MAX;
+    for (uint32_t f = 0; f < frameCount; f++) {
+        uint32_t diff = 0;
+        bool close = true;
+        for (uint16_t i = 0; i < NUM_LEDS; i++) {
+            size_t at = (size_t)f * NUM_LEDS + i;
+            const CRGB& a = floatRun.frames[at];
+            const CRGB& b = fixedRun.frames[at];
+            if (a != b) {
+                diff++;
+                close = close && abs(a.r - b.r) <= CLOSE_LEVELS &&
+                        abs(a.g - b.g) <= CLOSE_LEVELS && abs(a.b - b.b) <= CLOSE_LEVELS;
+            }
+        }
+        if (close) closeFrames++;
+        if (diff == 0) {
+            sameFrames++;
+        } else if (firstDiff == UINT32_MAX) {
+            firstDiff = f;
+        }
+        diffPixels += diff;
+    }
+
+    char first[16] = "-";
+    if (firstDiff != UINT32_MAX) snprintf(first, sizeof(first), "%u", firstDiff);
+    bool pass = closeFrames >= (uint64_t)frameCount * CLOSE_PERCENT / 100;
+    printf("%3d  %-16s %9.1f%% %9.1f%% %10.3f %11s %12.0f %12.0f %8.2fx  %s\n",
+           ref.id, effectTable[ref.id].name,
+           100.0 * sameFrames / frameCount, 100.0 * closeFrames / frameCount,
+           (double)diffPixels / frameCount, first,
+           floatRun.meanNs, fixedRun.meanNs,
+           fixedRun.meanNs > 0 ? floatRun.meanNs / fixedRun.meanNs : 0,
+           pass ? "ok" : "DRIFT");
+    return pass;
+}
+
+// Comet trail brightness, integer version vs. the float original
+static uint32_t checkCometCurve() {
+    uint32_t mismatches = 0;
+    for (uint32_t len = 1; len <= 255; len++) {
+        uint64_t cube = (uint64_t)len * len * len;
+        for (uint32_t i = 0; i < len; i++) {
+            float ratio = (float)i / len;
+            uint8_t expected = 255 * (1.0 - ratio * ratio * ratio);
+            uint8_t actual = 255 - (255ull * i * i * i + cube - 1) / cube;
+            if (expected != actual) mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    uint16_t ledCount = ARGB_NUM_LEDS;
+    uint32_t frameCount = 3600;   // 60 s of simulated time
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--leds") && i + 1 < argc) {
+            ledCount = (uint16_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            frameCount = (uint32_t)atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--leds N] [--frames N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (ledCount == 0 || ledCount > ARGB_MAX_LEDS || frameCount == 0) {
+        fprintf(stderr, "--leds must be 1..%d, --frames at least 1\n", ARGB_MAX_LEDS);
+        return 1;
+    }
+
+    if (!allocLeds(ledCount) || !fixedState.init(NUM_LEDS) || !ParticlePoolF::init(NUM_LEDS) ||
+        !LEDGeometry::begin()) {
+        fprintf(stderr, "Failed to allocate buffers for %d LEDs\n", ledCount);
+        return 1;
+    }
+
+    printf("PixelTree fixed-point check - %d LEDs, %u frames/effect\n\n", NUM_LEDS, frameCount);
+    printf("%3s  %-16s %10s %10s %10s %11s %12s %12s %9s\n",
+           "ID", "Effect", "same", "close", "px/frame", "first diff", "float ns", "fixed ns", "speedup");
+
+    bool pass = true;
+    for (const RefEffect& ref : refEffects) {
+        pass = compare(ref, frameCount) && pass;
+    }
+
+    uint32_t cometMismatches = checkCometCurve();
+    printf("\nComet trail curve: %u mismatches over all trail lengths\n", cometMismatches);
+    return pass && cometMismatches == 0 ? 0 : 1;
+}
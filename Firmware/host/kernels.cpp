@@ -0,0 +1,177 @@
+/*
+ * kernels.cpp - Pixel kernel check and benchmark (host simulation build)
+ *
+ * Checks every LEDKernels kernel against the per-pixel FastLED calls it
+ * replaces (fill_solid, nscale8, blend, +=) on random buffers of every
+ * length up to 64 LEDs, at every byte alignment, then times both over the
+ * strip length. The host runs the portable kernels; on an ESP32-S3 the PIE
+ * versions are checked against these at boot (LEDKernels::begin()) and
+ * their timing is logged.
+ *
+ * Usage: pixeltree_kernels [--leds N] [--reps N]
+ * Exit status is 1 if any kernel result differs.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "LEDKernels.h"
+
+// ============================================================================
+// Per-Pixel Reference (how effects did it before)
+// ============================================================================
+
+static void refFill(CRGB* buf, uint16_t n, CRGB c)  { fill_solid(buf, n, c); }
+static void refScale(CRGB* buf, uint16_t n, uint8_t s) {
+    for (uint16_t i = 0; i < n; i++) buf[i].nscale8(s);
+}
+static void refFade(CRGB* buf, uint16_t n, uint8_t a) {
+    for (uint16_t i = 0; i < n; i++) buf[i].nscale8(255 - a);
+}
+static void refBlend(CRGB* dst, const CRGB* a, const CRGB* b, uint16_t n, uint8_t x) {
+    for (uint16_t i = 0; i < n; i++) dst[i] = blend(a[i], b[i], x);
+}
+static void refBlendToward(CRGB* buf, uint16_t n, CRGB c, uint8_t x) {
+    for (uint16_t i = 0; i < n; i++) buf[i] = blend(buf[i], c, x);
+}
+static void refAdd(CRGB* dst, const CRGB* src, uint16_t n) {
+    for (uint16_t i = 0; i < n; i++) dst[i] += src[i];
+}
+
+// ============================================================================
+// Kernel Table
+// ============================================================================
+// Each case runs one operation with the arguments drawn for it: buf is the
+// buffer under test, other a second source buffer, c a color, x an amount.
+
+struct KernelCase {
+    const char* name;
+    void (*ref)(CRGB* buf, const CRGB* other, uint16_t n, CRGB c, uint8_t x);
+    void (*kernel)(CRGB* buf, const CRGB* other, uint16_t n, CRGB c, uint8_t x);
+};
+
+static const KernelCase kernelCases[] = {
+    { "fill",
+      [](CRGB* b, const CRGB*, uint16_t n, CRGB c, uint8_t) { refFill(b, n, c); },
+      [](CRGB* b, const CRGB*, uint16_t n, CRGB c, uint8_t) { LEDKernels::fill(b, n, c); } },
+    { "scale",
+      [](CRGB* b, const CRGB*, uint16_t n, CRGB, uint8_t x) { refScale(b, n, x); },
+      [](CRGB* b, const CRGB*, uint16_t n, CRGB, uint8_t x) { LEDKernels::scale(b, n, x); } },
+    { "fade",
+      [](CRGB* b, const CRGB*, uint16_t n, CRGB, uint8_t x) { refFade(b, n, x); },
+      [](CRGB* b, const CRGB*, uint16_t n, CRGB, uint8_t x) { LEDKernels::fade(b, n, x); } },
+    { "blend",
+      [](CRGB* b, const CRGB* o, uint16_t n, CRGB, uint8_t x) { refBlend(b, b, o, n, x); },
+      [](CRGB* b, const CRGB* o, uint16_t n, CRGB, uint8_t x) { LEDKernels::blend(b, b, o, n, x); } },
+    { "blendToward",
+      [](CRGB* b, const CRGB*, uint16_t n, CRGB c, uint8_t x) { refBlendToward(b, n, c, x); },
+      [](CRGB* b, const CRGB*, uint16_t n, CRGB c, uint8_t x) { LEDKernels::blendToward(b, n, c, x); } },
+    { "add",
+      [](CRGB* b, const CRGB* o, uint16_t n, CRGB, uint8_t) { refAdd(b, o, n); },
+      [](CRGB* b, const CRGB* o, uint16_t n, CRGB, uint8_t) { LEDKernels::add(b, o, n); } },
+};
+
+// ============================================================================
+// Check
+// ============================================================================
+
+static void randomize(uint8_t* p, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) p[i] = random8();
+}
+
+// Mismatching runs of one kernel over all lengths, alignments and a spread
+// of amounts (0 and 255 included)
+static uint32_t check(const KernelCase& kc) {
+    const uint16_t MAX_LEDS = 64;
+    const uint8_t amounts[] = { 0, 1, 30, 127, 128, 200, 254, 255 };
+    uint8_t refBuf[MAX_LEDS * 3 + 16], kerBuf[MAX_LEDS * 3 + 16], other[MAX_LEDS * 3];
+    uint32_t failures = 0;
+
+    for (uint8_t offset = 0; offset < 16; offset++) {
+        for (uint16_t n = 0; n <= MAX_LEDS; n++) {
+            for (uint8_t x : amounts) {
+                randomize(refBuf, sizeof(refBuf));
+                randomize(other, sizeof(other));
+                memcpy(kerBuf, refBuf, sizeof(refBuf));
+                CRGB c(random8(), random8(), random8());
+
+                kc.ref((CRGB*)(refBuf + offset), (const CRGB*)other, n, c, x);
+                kc.kernel((CRGB*)(kerBuf + offset), (const CRGB*)other, n, c, x);
+                if (memcmp(refBuf, kerBuf, sizeof(refBuf)) != 0) {
+                    if (failures == 0) {
+                        printf("  %s: first mismatch at %d LEDs, offset %d, amount %d\n",
+                               kc.name, n, offset, x);
+                    }
+                    failures++;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+typedef void (*KernelFn)(CRGB*, const CRGB*, uint16_t, CRGB, uint8_t);
+
+static double timeNs(KernelFn fn, std::vector<CRGB>& buf, const std::vector<CRGB>& other, uint32_t reps) {
+    typedef std::chrono::steady_clock Clock;
+    CRGB c(40, 90, 200);
+    auto start = Clock::now();
+    for (uint32_t r = 0; r < reps; r++) {
+        fn(buf.data(), other.data(), (uint16_t)buf.size(), c, (uint8_t)(r | 1));
+    }
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / reps;
+}
+
+int main(int argc, char** argv) {
+    uint16_t ledCount = 1000;
+    uint32_t reps = 20000;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--leds") && i + 1 < argc) {
+            ledCount = (uint16_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--reps") && i + 1 < argc) {
+            reps = (uint32_t)atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--leds N] [--reps N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (ledCount == 0 || ledCount > ARGB_MAX_LEDS || reps == 0) {
+        fprintf(stderr, "--leds must be 1..%d, --reps at least 1\n", ARGB_MAX_LEDS);
+        return 1;
+    }
+
+    printf("PixelTree pixel kernels (%s) - %d LEDs, %u reps\n\n", LEDKernels::name(), ledCount, reps);
+    printf("%-12s %10s %14s %12s %9s\n", "Kernel", "mismatch", "per-pixel ns", "kernel ns", "speedup");
+
+    std::vector<CRGB> buf(ledCount), other(ledCount);
+    randomize((uint8_t*)other.data(), ledCount * 3);
+
+    uint32_t totalFailures = 0;
+    for (const KernelCase& kc : kernelCases) {
+        uint32_t failures = check(kc);
+        totalFailures += failures;
+
+        randomize((uint8_t*)buf.data(), ledCount * 3);
+        double refNs = timeNs(kc.ref, buf, other, reps);
+        randomize((uint8_t*)buf.data(), ledCount * 3);
+        double kerNs = timeNs(kc.kernel, buf, other, reps);
+
+        printf("%-12s %10u %14.0f %12.0f %8.1fx\n", kc.name, failures, refNs, kerNs,
+               kerNs > 0 ? refNs / kerNs : 0);
+    }
+
+    printf("\n%s\n", totalFailures ? "FAILED - kernels differ from the per-pixel calls" : "All kernels match");
+    return totalFailures ? 1 : 0;
+}
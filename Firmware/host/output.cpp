@@ -0,0 +1,154 @@
+/*
+ * output.cpp - Static scene output check (host simulation build)
+ *
+ * Runs each static effect (Solid, Gradient, Spots, Pattern) at the
+ * firmware's default settings (brightness 180, LED_COLOR_CORRECTION in the
+ * output tables) through the same per-frame output decision as
+ * LEDOutput::present(): a frame is sent if it changed or is still being
+ * dithered (HDRFrame::beginFrame()), corrected and dithered by
+ * ColorPipeline::apply(), and HDRFrame::endFrame() records whether it needs
+ * more frames. Checks that every one of them stops sending frames within
+ * LED_DITHER_HOLD_FRAMES, stays stopped, and that the frame left on the
+ * strip is every output value rounded to the nearest level.
+ *
+ * Usage: pixeltree_output [--leds N]
+ * Exit status is 1 if a static scene keeps sending frames or is left on
+ * the strip with anything other than the rounded values.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+
+// Logging goes to the serial port on the device; nothing to log to here
+#define SERIAL_LOGGER_H
+#define LOG_ERROR(msg)
+
+#include "EffectDefs.h"
+#include "Effects.h"
+#include "EffectTable.h"
+#include "HDRFrame.h"
+#include "ColorPipeline.h"
+
+#define DEFAULT_BRIGHTNESS    180     // LEDController::brightness at boot
+#define STATIC_EFFECTS        4       // Category 1 of the effect table
+#define WATCH_FRAMES          (LED_DITHER_HOLD_FRAMES * 3)
+
+struct SceneResult {
+    bool dithered;         // First frame had values between output levels
+    uint32_t sent;         // Frames sent before the scene rested (0 = never rested)
+    uint32_t sentAfter;    // Frames sent after it rested
+    uint32_t wrong;        // Channels on the strip not at their rounded value
+};
+
+// ============================================================================
+// Output (LEDOutput::present() for an 8-bit frame, one output)
+// ============================================================================
+
+static std::vector<CRGB> shown;     // Frame the strip was last sent
+static std::vector<CRGB> strip;     // What the strip shows
+
+static bool presentFrame(bool force, uint8_t* fraction) {
+    bool changed = force || memcmp(shown.data(), leds, NUM_LEDS * sizeof(CRGB)) != 0;
+    if (!HDRFrame::beginFrame(changed)) {
+        return false;
+    }
+    memcpy(shown.data(), leds, NUM_LEDS * sizeof(CRGB));
+
+    ColorPipeline::latch();
+    *fraction = ColorPipeline::apply(strip.data(), leds, HDRFrame::errorAt(0), NUM_LEDS, false);
+    HDRFrame::endFrame(*fraction);
+    return true;
+}
+
+// ============================================================================
+// Check
+// ============================================================================
+
+static SceneResult runScene(uint8_t id) {
+    const uint32_t frameMs = 1000 / LED_TARGET_FPS;
+    SceneResult r = { false, 0, 0, 0 };
+
+    hostsim::setMillis(0);
+    resetEffectTime(0);
+    fill_solid(leds, NUM_LEDS, CRGB::Black);
+
+    bool rested = false;
+    for (uint32_t f = 0; f < WATCH_FRAMES; f++) {
+        hostsim::advanceMillis(frameMs);
+        advanceEffectTime(millis());
+        effectTable[id].func();
+
+        uint8_t fraction = 0;
+        bool sent = presentFrame(f == 0, &fraction);
+        if (f == 0) {
+            r.dithered = fraction != 0;
+        }
+        if (!sent) {
+            rested = true;
+        } else if (rested) {
+            r.sentAfter++;
+        } else {
+            r.sent++;
+        }
+    }
+    if (!rested) {
+        r.sent = 0;
+    }
+
+    for (uint16_t i = 0; i < NUM_LEDS; i++) {
+        CRGB16 v = ColorPipeline::toOutput(leds[i]);
+        r.wrong += strip[i].r != (v.r + 0x80) >> 8;
+        r.wrong += strip[i].g != (v.g + 0x80) >> 8;
+        r.wrong += strip[i].b != (v.b + 0x80) >> 8;
+    }
+    return r;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    uint16_t count = ARGB_NUM_LEDS;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--leds") && i + 1 < argc) {
+            count = (uint16_t)atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--leds N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (count == 0 || count > ARGB_MAX_LEDS) {
+        fprintf(stderr, "--leds must be 1..%d\n", ARGB_MAX_LEDS);
+        return 2;
+    }
+
+    random16_set_seed(1337);
+    if (!allocLeds(count) || !HDRFrame::begin() || !ColorPipeline::begin()) {
+        fprintf(stderr, "Failed to allocate buffers for %d LEDs\n", count);
+        return 2;
+    }
+    ColorPipeline::setBrightness(DEFAULT_BRIGHTNESS);
+    shown.resize(NUM_LEDS);
+    strip.resize(NUM_LEDS);
+
+    printf("PixelTree static scene output - %d LEDs, brightness %d, rest after %d frames\n",
+           NUM_LEDS, DEFAULT_BRIGHTNESS, LED_DITHER_HOLD_FRAMES);
+    printf("%-10s %9s %6s %11s %7s\n", "effect", "dithered", "sent", "sent after", "wrong");
+
+    int failures = 0;
+    for (uint8_t id = 0; id < STATIC_EFFECTS; id++) {
+        SceneResult r = runScene(id);
+        bool ok = r.sent != 0 && r.sent <= LED_DITHER_HOLD_FRAMES + 1 &&
+                  r.sentAfter == 0 && r.wrong == 0;
+        printf("%-10s %9s %6u %11u %7u  %s\n", effectTable[id].name, r.dithered ? "yes" : "no",
+               (unsigned)r.sent, (unsigned)r.sentAfter, (unsigned)r.wrong, ok ? "ok" : "FAIL");
+        if (!ok) failures++;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * Arduino.h - Minimal Arduino core shim for the host simulation build
+ *
+ * Provides just enough of the Arduino-ESP32 API for the effect code to
+ * compile on Linux. Time is simulated: millis() returns a clock that the
+ * host driver advances explicitly, so time-gated effects behave the same
+ * way they do on the device regardless of host CPU speed.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+
+// Arduino-ESP32 pulls these into the global namespace as well
+using std::abs;
+using std::min;
+using std::max;
+
+#define PROGMEM
+#define pgm_read_byte(addr)   (*(const uint8_t*)(addr))
+#define pgm_read_dword(addr)  (*(const uint32_t*)(addr))
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+// ============================================================================
+// Simulated Clock
+// ============================================================================
+
+namespace hostsim {
+    inline uint32_t clockMs = 0;
+
+    inline void setMillis(uint32_t ms) { clockMs = ms; }
+    inline void advanceMillis(uint32_t ms) { clockMs += ms; }
+}
+
+inline uint32_t millis() { return hostsim::clockMs; }
+inline uint32_t micros() { return hostsim::clockMs * 1000UL; }
+
+// Blocking calls only move the simulated clock forward
+inline void delay(uint32_t ms) { hostsim::advanceMillis(ms); }
+inline void delayMicroseconds(uint32_t) {}
+
+// ============================================================================
+// Math Helpers
+// ============================================================================
+
+// Same semantics as the Arduino-ESP32 core (guards against a zero input range)
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    const long run = in_max - in_min;
+    if (run == 0) {
+        return -1;
+    }
+    const long rise = out_max - out_min;
+    const long delta = x - in_min;
+    return (delta * rise) / run + out_min;
+}
+
+inline uint32_t esp_random() { return (uint32_t)rand(); }
+
+// ============================================================================
+// Heap Capabilities (esp_heap_caps.h) - one flat heap on the host
+// ============================================================================
+
+#define MALLOC_CAP_DMA        (1 << 3)
+#define MALLOC_CAP_8BIT       (1 << 2)
+#define MALLOC_CAP_SPIRAM     (1 << 10)
+#define MALLOC_CAP_INTERNAL   (1 << 11)
+
+inline void* heap_caps_calloc(size_t n, size_t size, uint32_t) { return calloc(n, size); }
+inline void* heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+inline void heap_caps_free(void* ptr) { free(ptr); }
+
+// ============================================================================
+// FreeRTOS Mutexes - one thread on the host, taking one always succeeds
+// ============================================================================
+
+typedef void* SemaphoreHandle_t;
+
+#define portMAX_DELAY  0xFFFFFFFFUL
+#define pdTRUE         1
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+    static int mutexToken;
+    return &mutexToken;
+}
+inline int xSemaphoreTake(SemaphoreHandle_t, uint32_t) { return pdTRUE; }
+inline int xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+
+#endif // HOST_ARDUINO_H
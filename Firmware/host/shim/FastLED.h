@@ -0,0 +1,705 @@
+/*
+ * FastLED.h - FastLED subset for the host simulation build
+ *
+ * Re-implements the parts of FastLED used by the effects (CRGB/CHSV,
+ * palettes, lib8tion math, 8-bit Perlin noise) with the same integer
+ * algorithms as FastLED 3.x, so per-frame cost on the host is
+ * representative of the real library. Output calls (show/delay) never
+ * touch hardware.
+ */
+
+#ifndef HOST_FASTLED_H
+#define HOST_FASTLED_H
+
+#include "Arduino.h"
+
+typedef uint8_t fract8;
+
+// ============================================================================
+// lib8tion - 8-bit Math
+// ============================================================================
+
+inline uint8_t qadd8(uint8_t i, uint8_t j) {
+    unsigned int t = i + j;
+    return t > 255 ? 255 : (uint8_t)t;
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j) {
+    int t = i - j;
+    return t < 0 ? 0 : (uint8_t)t;
+}
+
+// FASTLED_SCALE8_FIXED semantics: scale8(255, 255) == 255
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+    return (uint8_t)(((uint16_t)i * (1 + (uint16_t)scale)) >> 8);
+}
+
+inline uint8_t scale8_video(uint8_t i, fract8 scale) {
+    return (uint8_t)((((int)i * (int)scale) >> 8) + ((i && scale) ? 1 : 0));
+}
+
+inline uint16_t scale16(uint16_t i, uint16_t scale) {
+    return (uint16_t)(((uint32_t)i * (1 + (uint32_t)scale)) >> 16);
+}
+
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+    uint16_t partial = (uint16_t)((a << 8) | b);
+    partial += (uint16_t)(b * amountOfB);
+    partial -= (uint16_t)(a * amountOfB);
+    return (uint8_t)(partial >> 8);
+}
+
+inline uint8_t sin8(uint8_t theta) {
+    static const uint8_t b_m16_interleave[] = { 0, 49, 49, 41, 90, 27, 117, 10 };
+
+    uint8_t offset = theta;
+    if (theta & 0x40) {
+        offset = (uint8_t)255 - offset;
+    }
+    offset &= 0x3F;
+
+    uint8_t secoffset = offset & 0x0F;
+    if (theta & 0x40) {
+        ++secoffset;
+    }
+
+    uint8_t section = offset >> 4;
+    const uint8_t* p = b_m16_interleave + section * 2;
+    uint8_t b = p[0];
+    uint8_t m16 = p[1];
+
+    uint8_t mx = (m16 * secoffset) >> 4;
+    int8_t y = (int8_t)(mx + b);
+    if (theta & 0x80) {
+        y = -y;
+    }
+    y += 128;
+    return (uint8_t)y;
+}
+
+inline uint8_t cos8(uint8_t theta) { return sin8(theta + 64); }
+
+inline uint8_t triwave8(uint8_t in) {
+    if (in & 0x80) {
+        in = 255 - in;
+    }
+    return in << 1;
+}
+
+inline uint8_t ease8InOutQuad(uint8_t i) {
+    uint8_t j = i;
+    if (j & 0x80) {
+        j = 255 - j;
+    }
+    uint8_t jj = scale8(j, j);
+    uint8_t jj2 = jj << 1;
+    if (i & 0x80) {
+        jj2 = 255 - jj2;
+    }
+    return jj2;
+}
+
+inline uint16_t ease16InOutQuad(uint16_t i) {
+    uint16_t j = i;
+    if (j & 0x8000) {
+        j = 65535 - j;
+    }
+    uint16_t jj = scale16(j, j);
+    uint16_t jj2 = jj << 1;
+    if (i & 0x8000) {
+        jj2 = 65535 - jj2;
+    }
+    return jj2;
+}
+
+inline int16_t sin16(uint16_t theta) {
+    static const uint16_t base[] = { 0, 6393, 12539, 18204, 23170, 27245, 30273, 32137 };
+    static const uint8_t slope[] = { 49, 48, 44, 38, 31, 23, 14, 4 };
+
+    uint16_t offset = (theta & 0x3FFF) >> 3;
+    if (theta & 0x4000) {
+        offset = 2047 - offset;
+    }
+
+    uint8_t section = offset / 256;
+    uint16_t b = base[section];
+    uint8_t m = slope[section];
+    uint8_t secoffset8 = (uint8_t)offset / 2;
+
+    uint16_t mx = m * secoffset8;
+    int16_t y = mx + b;
+    if (theta & 0x8000) {
+        y = -y;
+    }
+    return y;
+}
+
+inline int16_t cos16(uint16_t theta) { return sin16(theta + 16384); }
+
+// ============================================================================
+// Random Numbers (same LCG as FastLED)
+// ============================================================================
+
+namespace hostsim {
+    inline uint16_t rand16seed = 1337;
+}
+
+inline uint8_t random8() {
+    hostsim::rand16seed = (uint16_t)(hostsim::rand16seed * 2053 + 13849);
+    return (uint8_t)((uint8_t)(hostsim::rand16seed & 0xFF) + (uint8_t)(hostsim::rand16seed >> 8));
+}
+
+inline uint8_t random8(uint8_t lim) {
+    return (uint8_t)((random8() * lim) >> 8);
+}
+
+inline uint8_t random8(uint8_t min, uint8_t lim) {
+    uint8_t delta = lim - min;
+    return random8(delta) + min;
+}
+
+inline uint16_t random16() {
+    hostsim::rand16seed = (uint16_t)(hostsim::rand16seed * 2053 + 13849);
+    return hostsim::rand16seed;
+}
+
+inline uint16_t random16(uint16_t lim) {
+    return (uint16_t)(((uint32_t)lim * random16()) >> 16);
+}
+
+inline uint16_t random16(uint16_t min, uint16_t lim) {
+    uint16_t delta = lim - min;
+    return random16(delta) + min;
+}
+
+inline void random16_set_seed(uint16_t seed) { hostsim::rand16seed = seed; }
+inline uint16_t random16_get_seed() { return hostsim::rand16seed; }
+
+// ============================================================================
+// Color Types
+// ============================================================================
+
+struct CHSV {
+    union {
+        struct {
+            uint8_t hue;
+            uint8_t sat;
+            uint8_t val;
+        };
+        uint8_t raw[3];
+    };
+
+    CHSV() : hue(0), sat(0), val(0) {}
+    CHSV(uint8_t ih, uint8_t is, uint8_t iv) : hue(ih), sat(is), val(iv) {}
+};
+
+struct CRGB;
+inline void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb);
+
+struct CRGB {
+    union {
+        struct {
+            union { uint8_t r; uint8_t red; };
+            union { uint8_t g; uint8_t green; };
+            union { uint8_t b; uint8_t blue; };
+        };
+        uint8_t raw[3];
+    };
+
+    typedef enum {
+        Aqua = 0x00FFFF,
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Cyan = 0x00FFFF,
+        DarkBlue = 0x00008B,
+        DarkGreen = 0x006400,
+        DarkRed = 0x8B0000,
+        Gold = 0xFFD700,
+        Green = 0x008000,
+        Lime = 0x00FF00,
+        Magenta = 0xFF00FF,
+        Maroon = 0x800000,
+        Navy = 0x000080,
+        Orange = 0xFFA500,
+        OrangeRed = 0xFF4500,
+        Pink = 0xFFC0CB,
+        Purple = 0x800080,
+        Red = 0xFF0000,
+        White = 0xFFFFFF,
+        Yellow = 0xFFFF00
+    } HTMLColorCode;
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(uint32_t colorcode)
+        : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    CRGB(HTMLColorCode colorcode)
+        : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    CRGB(const CHSV& rhs) { hsv2rgb_rainbow(rhs, *this); }
+
+    CRGB& operator=(const CHSV& rhs) {
+        hsv2rgb_rainbow(rhs, *this);
+        return *this;
+    }
+
+    uint8_t& operator[](uint8_t x) { return raw[x]; }
+    const uint8_t& operator[](uint8_t x) const { return raw[x]; }
+
+    CRGB& operator+=(const CRGB& rhs) {
+        r = qadd8(r, rhs.r);
+        g = qadd8(g, rhs.g);
+        b = qadd8(b, rhs.b);
+        return *this;
+    }
+
+    CRGB& operator-=(const CRGB& rhs) {
+        r = qsub8(r, rhs.r);
+        g = qsub8(g, rhs.g);
+        b = qsub8(b, rhs.b);
+        return *this;
+    }
+
+    CRGB& nscale8(uint8_t scaledown) {
+        uint16_t scale_fixed = scaledown + 1;
+        r = (r * scale_fixed) >> 8;
+        g = (g * scale_fixed) >> 8;
+        b = (b * scale_fixed) >> 8;
+        return *this;
+    }
+
+    CRGB& nscale8_video(uint8_t scaledown) {
+        r = scale8_video(r, scaledown);
+        g = scale8_video(g, scaledown);
+        b = scale8_video(b, scaledown);
+        return *this;
+    }
+
+    CRGB& fadeToBlackBy(uint8_t fadefactor) { return nscale8(255 - fadefactor); }
+
+    bool operator==(const CRGB& rhs) const { return r == rhs.r && g == rhs.g && b == rhs.b; }
+    bool operator!=(const CRGB& rhs) const { return !(*this == rhs); }
+
+    explicit operator bool() const { return r || g || b; }
+};
+
+inline CRGB operator+(const CRGB& p1, const CRGB& p2) {
+    return CRGB(qadd8(p1.r, p2.r), qadd8(p1.g, p2.g), qadd8(p1.b, p2.b));
+}
+
+// hsv2rgb_rainbow from FastLED (Y1 yellow boost, no G2/Gscale)
+inline void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb) {
+    uint8_t hue = hsv.hue;
+    uint8_t sat = hsv.sat;
+    uint8_t val = hsv.val;
+
+    uint8_t offset = hue & 0x1F;
+    uint8_t offset8 = offset << 3;
+    uint8_t third = scale8(offset8, (256 / 3));
+
+    uint8_t r, g, b;
+
+    if (!(hue & 0x80)) {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {
+                r = 255 - third; g = third; b = 0;
+            } else {
+                r = 171; g = 85 + third; b = 0;
+            }
+        } else {
+            if (!(hue & 0x20)) {
+                uint8_t twothirds = scale8(offset8, ((256 * 2) / 3));
+                r = 171 - twothirds; g = 170 + third; b = 0;
+            } else {
+                r = 0; g = 255 - third; b = third;
+            }
+        }
+    } else {
+        if (!(hue & 0x40)) {
+            if (!(hue & 0x20)) {
+                uint8_t twothirds = scale8(offset8, ((256 * 2) / 3));
+                r = 0; g = 171 - twothirds; b = 85 + twothirds;
+            } else {
+                r = third; g = 0; b = 255 - third;
+            }
+        } else {
+            if (!(hue & 0x20)) {
+                r = 85 + third; g = 0; b = 171 - third;
+            } else {
+                r = 170 + third; g = 0; b = 85 - third;
+            }
+        }
+    }
+
+    if (sat != 255) {
+        if (sat == 0) {
+            r = 255; g = 255; b = 255;
+        } else {
+            uint8_t desat = 255 - sat;
+            desat = scale8_video(desat, desat);
+            uint8_t satscale = 255 - desat;
+            r = scale8(r, satscale) + desat;
+            g = scale8(g, satscale) + desat;
+            b = scale8(b, satscale) + desat;
+        }
+    }
+
+    if (val != 255) {
+        val = scale8_video(val, val);
+        if (val == 0) {
+            r = 0; g = 0; b = 0;
+        } else {
+            r = scale8(r, val);
+            g = scale8(g, val);
+            b = scale8(b, val);
+        }
+    }
+
+    rgb.r = r;
+    rgb.g = g;
+    rgb.b = b;
+}
+
+inline CRGB blend(const CRGB& p1, const CRGB& p2, fract8 amountOfP2) {
+    if (amountOfP2 == 0) return p1;
+    if (amountOfP2 == 255) return p2;
+    return CRGB(blend8(p1.r, p2.r, amountOfP2),
+                blend8(p1.g, p2.g, amountOfP2),
+                blend8(p1.b, p2.b, amountOfP2));
+}
+
+// ============================================================================
+// Fill Functions
+// ============================================================================
+
+inline void fill_solid(CRGB* leds, int numToFill, const CRGB& color) {
+    for (int i = 0; i < numToFill; ++i) {
+        leds[i] = color;
+    }
+}
+
+inline void fill_rainbow(CRGB* leds, int numToFill, uint8_t initialhue, uint8_t deltahue = 5) {
+    CHSV hsv(initialhue, 240, 255);
+    for (int i = 0; i < numToFill; ++i) {
+        leds[i] = hsv;
+        hsv.hue += deltahue;
+    }
+}
+
+inline void fill_gradient_RGB(CRGB* leds, uint16_t startpos, CRGB startcolor,
+                              uint16_t endpos, CRGB endcolor) {
+    if (endpos < startpos) {
+        uint16_t t = endpos;
+        CRGB tc = endcolor;
+        endcolor = startcolor;
+        endpos = startpos;
+        startpos = t;
+        startcolor = tc;
+    }
+
+    int16_t rdistance87 = (endcolor.r - startcolor.r) << 7;
+    int16_t gdistance87 = (endcolor.g - startcolor.g) << 7;
+    int16_t bdistance87 = (endcolor.b - startcolor.b) << 7;
+
+    uint16_t pixeldistance = endpos - startpos;
+    int16_t divisor = pixeldistance ? pixeldistance : 1;
+
+    int16_t rdelta87 = (rdistance87 / divisor) * 2;
+    int16_t gdelta87 = (gdistance87 / divisor) * 2;
+    int16_t bdelta87 = (bdistance87 / divisor) * 2;
+
+    uint16_t r88 = startcolor.r << 8;
+    uint16_t g88 = startcolor.g << 8;
+    uint16_t b88 = startcolor.b << 8;
+    for (uint16_t i = startpos; i <= endpos; ++i) {
+        leds[i] = CRGB(r88 >> 8, g88 >> 8, b88 >> 8);
+        r88 += rdelta87;
+        g88 += gdelta87;
+        b88 += bdelta87;
+    }
+}
+
+inline void fill_gradient_RGB(CRGB* leds, uint16_t numLeds, const CRGB& c1, const CRGB& c2) {
+    uint16_t last = numLeds - 1;
+    fill_gradient_RGB(leds, 0, c1, last, c2);
+}
+
+// ============================================================================
+// Palettes
+// ============================================================================
+
+typedef uint32_t TProgmemRGBPalette16[16];
+typedef uint8_t TProgmemRGBGradientPalette_byte;
+typedef const TProgmemRGBGradientPalette_byte* TProgmemRGBGradientPalette_bytes;
+
+#define DEFINE_GRADIENT_PALETTE(X) extern const TProgmemRGBGradientPalette_byte X[] =
+
+typedef enum { NOBLEND = 0, LINEARBLEND = 1 } TBlendType;
+
+class CRGBPalette16 {
+public:
+    CRGB entries[16];
+
+    CRGBPalette16() {}
+
+    CRGBPalette16(const TProgmemRGBPalette16& rhs) {
+        for (uint8_t i = 0; i < 16; i++) {
+            entries[i] = CRGB(rhs[i]);
+        }
+    }
+
+    // Expands a gradient palette into 16 entries (FastLED's algorithm)
+    CRGBPalette16(TProgmemRGBGradientPalette_bytes progpal) {
+        uint16_t count = 0;
+        while (progpal[count * 4] != 255) {
+            ++count;
+        }
+        ++count;
+
+        int8_t lastSlotUsed = -1;
+        const uint8_t* ent = progpal;
+        CRGB rgbstart(ent[1], ent[2], ent[3]);
+        int indexstart = 0;
+        while (indexstart < 255) {
+            ent += 4;
+            int indexend = ent[0];
+            CRGB rgbend(ent[1], ent[2], ent[3]);
+            uint8_t istart8 = indexstart / 16;
+            uint8_t iend8 = indexend / 16;
+            if (count < 16) {
+                if ((istart8 <= lastSlotUsed) && (lastSlotUsed < 15)) {
+                    istart8 = lastSlotUsed + 1;
+                    if (iend8 < istart8) {
+                        iend8 = istart8;
+                    }
+                }
+                lastSlotUsed = iend8;
+            }
+            fill_gradient_RGB(entries, istart8, rgbstart, iend8, rgbend);
+            indexstart = indexend;
+            rgbstart = rgbend;
+        }
+    }
+
+    CRGB& operator[](uint8_t x) { return entries[x]; }
+    const CRGB& operator[](uint8_t x) const { return entries[x]; }
+};
+
+inline CRGB ColorFromPalette(const CRGBPalette16& pal, uint8_t index,
+                             uint8_t brightness = 255, TBlendType blendType = LINEARBLEND) {
+    uint8_t hi4 = index >> 4;
+    uint8_t lo4 = index & 0x0F;
+
+    const CRGB* entry = &(pal[0]) + hi4;
+    uint8_t red1 = entry->r;
+    uint8_t green1 = entry->g;
+    uint8_t blue1 = entry->b;
+
+    if (lo4 && blendType != NOBLEND) {
+        if (hi4 == 15) {
+            entry = &(pal[0]);
+        } else {
+            ++entry;
+        }
+        uint8_t f2 = lo4 << 4;
+        uint8_t f1 = 255 - f2;
+        red1 = scale8(red1, f1) + scale8(entry->r, f2);
+        green1 = scale8(green1, f1) + scale8(entry->g, f2);
+        blue1 = scale8(blue1, f1) + scale8(entry->b, f2);
+    }
+
+    if (brightness != 255) {
+        if (brightness) {
+            ++brightness;
+            red1 = scale8(red1, brightness);
+            green1 = scale8(green1, brightness);
+            blue1 = scale8(blue1, brightness);
+        } else {
+            red1 = green1 = blue1 = 0;
+        }
+    }
+
+    return CRGB(red1, green1, blue1);
+}
+
+inline const TProgmemRGBPalette16 CloudColors_p = {
+    0x0000FF, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B,
+    0x0000FF, 0x00008B, 0x87CEEB, 0x87CEEB, 0xADD8E6, 0xFFFFFF, 0xADD8E6, 0x87CEEB
+};
+
+inline const TProgmemRGBPalette16 LavaColors_p = {
+    0x000000, 0x800000, 0x000000, 0x800000, 0x8B0000, 0x8B0000, 0x800000, 0x8B0000,
+    0x8B0000, 0x8B0000, 0xFF0000, 0xFFA500, 0xFFFFFF, 0xFFA500, 0xFF0000, 0x8B0000
+};
+
+inline const TProgmemRGBPalette16 OceanColors_p = {
+    0x191970, 0x00008B, 0x191970, 0x000080, 0x00008B, 0x0000CD, 0x2E8B57, 0x008080,
+    0x5F9EA0, 0x0000FF, 0x008B8B, 0x6495ED, 0x7FFFD4, 0x2E8B57, 0x00FFFF, 0x87CEFA
+};
+
+inline const TProgmemRGBPalette16 ForestColors_p = {
+    0x006400, 0x006400, 0x556B2F, 0x006400, 0x008000, 0x228B22, 0x6B8E23, 0x008000,
+    0x2E8B57, 0x66CDAA, 0x32CD32, 0x9ACD32, 0x90EE90, 0x7CFC00, 0x66CDAA, 0x228B22
+};
+
+inline const TProgmemRGBPalette16 RainbowColors_p = {
+    0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A,
+    0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B
+};
+
+inline const TProgmemRGBPalette16 PartyColors_p = {
+    0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00,
+    0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9
+};
+
+inline const TProgmemRGBPalette16 HeatColors_p = {
+    0x000000, 0x330000, 0x660000, 0x990000, 0xCC0000, 0xFF0000, 0xFF3300, 0xFF6600,
+    0xFF9900, 0xFFCC00, 0xFFFF00, 0xFFFF33, 0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF
+};
+
+// ============================================================================
+// Noise - 8-bit 2D Perlin (inoise8)
+// ============================================================================
+
+namespace hostsim {
+    inline const uint8_t perlinPerm[257] = {
+        151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+        140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+        247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+        57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+        74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+        60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+        65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+        200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+        52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+        207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+        119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+        129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+        218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+        81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+        184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+        222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+        151
+    };
+
+    inline uint8_t P(uint8_t x) { return perlinPerm[x]; }
+
+    inline int8_t avg7(int8_t i, int8_t j) {
+        return (int8_t)((i >> 1) + (j >> 1) + (i & 0x1));
+    }
+
+    inline int8_t grad8(uint8_t hash, int8_t x, int8_t y) {
+        int8_t u, v;
+        if (hash & 4) {
+            u = y; v = x;
+        } else {
+            u = x; v = y;
+        }
+        if (hash & 1) u = -u;
+        if (hash & 2) v = -v;
+        return avg7(u, v);
+    }
+
+    inline int8_t lerp7by8(int8_t a, int8_t b, fract8 frac) {
+        if (b > a) {
+            uint8_t delta = b - a;
+            return (int8_t)(a + scale8(delta, frac));
+        }
+        uint8_t delta = a - b;
+        return (int8_t)(a - scale8(delta, frac));
+    }
+
+    inline int8_t inoise8_raw(uint16_t x, uint16_t y) {
+        uint8_t X = x >> 8;
+        uint8_t Y = y >> 8;
+
+        uint8_t A = P(X) + Y;
+        uint8_t AA = P(A);
+        uint8_t AB = P(A + 1);
+        uint8_t B = P(X + 1) + Y;
+        uint8_t BA = P(B);
+        uint8_t BB = P(B + 1);
+
+        uint8_t u = (uint8_t)x;
+        uint8_t v = (uint8_t)y;
+
+        int8_t xx = (int8_t)(((uint8_t)x >> 1) & 0x7F);
+        int8_t yy = (int8_t)(((uint8_t)y >> 1) & 0x7F);
+        const uint8_t N = 0x80;
+
+        u = ease8InOutQuad(u);
+        v = ease8InOutQuad(v);
+
+        int8_t X1 = lerp7by8(grad8(P(AA), xx, yy), grad8(P(BA), xx - N, yy), u);
+        int8_t X2 = lerp7by8(grad8(P(AB), xx, yy - N), grad8(P(BB), xx - N, yy - N), u);
+        return lerp7by8(X1, X2, v);
+    }
+}
+
+inline uint8_t inoise8(uint16_t x, uint16_t y) {
+    int8_t n = hostsim::inoise8_raw(x, y);
+    n += 64;
+    return qadd8((uint8_t)n, (uint8_t)n);
+}
+
+// ============================================================================
+// Controller / CFastLED
+// ============================================================================
+
+enum EOrder { RGB = 0012, GRB = 0102 };
+
+enum LEDColorCorrection { TypicalLEDStrip = 0xFFB0F0, UncorrectedColor = 0xFFFFFF };
+
+template<uint8_t DATA_PIN, EOrder RGB_ORDER = GRB>
+class WS2812 {};
+
+class CLEDController {
+public:
+    CRGB* leds = nullptr;
+    int numLeds = 0;
+
+    CLEDController& setCorrection(LEDColorCorrection) { return *this; }
+    CLEDController& setLeds(CRGB* data, int nLeds) {
+        leds = data;
+        numLeds = nLeds;
+        return *this;
+    }
+};
+
+class CFastLED {
+public:
+    template<template<uint8_t, EOrder> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+    CLEDController& addLeds(CRGB* data, int nLeds) {
+        controller.setLeds(data, nLeds);
+        return controller;
+    }
+
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness() const { return brightness; }
+    void setMaxPowerInMilliWatts(uint32_t) {}
+
+    void clear(bool writeData = false) {
+        if (controller.leds) {
+            fill_solid(controller.leds, controller.numLeds, CRGB::Black);
+        }
+        if (writeData) {
+            show();
+        }
+    }
+
+    void show() { ++showCount; }
+
+    void delay(unsigned long ms) {
+        show();
+        hostsim::advanceMillis(ms);
+    }
+
+    uint32_t showCount = 0;
+
+private:
+    CLEDController controller;
+    uint8_t brightness = 255;
+};
+
+inline CFastLED FastLED;
+
+#endif // HOST_FASTLED_H